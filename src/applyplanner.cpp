@@ -0,0 +1,194 @@
+#include "applyplanner.h"
+#include <QHash>
+#include <QTextStream>
+
+namespace {
+
+QString fieldNames(DisplayFields fields)
+{
+    static const QList<QPair<DisplayField, const char *>> names = {
+        {DisplayField::Identity, "identity"},
+        {DisplayField::Mode, "mode"},
+        {DisplayField::Position, "position"},
+        {DisplayField::Scale, "scale"},
+        {DisplayField::Transform, "transform"},
+        {DisplayField::Mirror, "mirror"},
+        {DisplayField::Enabled, "enabled"},
+        {DisplayField::Primary, "primary"},
+        {DisplayField::Workspace, "workspace"},
+        {DisplayField::ColorManagement, "color"},
+        {DisplayField::Vrr, "vrr"},
+        {DisplayField::Capabilities, "capabilities"},
+    };
+    
+    QStringList parts;
+    for (const auto &entry : names) {
+        if (fields.testFlag(entry.first)) parts.append(entry.second);
+    }
+    return parts.isEmpty() ? QString("-") : parts.join(',');
+}
+
+// Fields that end up in a monitor rule; everything else is informational
+const DisplayFields RuleFields = DisplayField::Mode | DisplayField::Position | DisplayField::Scale
+                               | DisplayField::Transform | DisplayField::Mirror
+                               | DisplayField::ColorManagement | DisplayField::Vrr;
+
+// Fields whose change makes Hyprland commit a new mode
+const DisplayFields ModesetFields = DisplayField::Mode | DisplayField::Mirror | DisplayField::ColorManagement;
+
+} // namespace
+
+bool PlannedChange::causesModeset() const
+{
+    return kind == Modeset || kind == Enable || kind == Disable;
+}
+
+QString PlannedChange::kindName(Kind kind)
+{
+    switch (kind) {
+        case Unchanged: return "unchanged";
+        case Reposition: return "reposition";
+        case Reconfigure: return "reconfigure";
+        case Modeset: return "modeset";
+        case Enable: return "enable";
+        case Disable: return "disable";
+    }
+    return "unknown";
+}
+
+QStringList ApplyPlan::commands() const
+{
+    QStringList result;
+    for (const PlannedChange &change : changes) {
+        if (change.kind != PlannedChange::Unchanged) {
+            result.append(change.command);
+        }
+    }
+    return result;
+}
+
+int ApplyPlan::modesetCount() const
+{
+    int count = 0;
+    for (const PlannedChange &change : changes) {
+        if (change.causesModeset()) ++count;
+    }
+    return count;
+}
+
+bool ApplyPlan::isEmpty() const
+{
+    for (const PlannedChange &change : changes) {
+        if (change.kind != PlannedChange::Unchanged) return false;
+    }
+    return true;
+}
+
+QString ApplyPlan::describe() const
+{
+    QString text;
+    QTextStream out(&text);
+    out << "Apply plan: " << commands().size() << " command(s), "
+        << modesetCount() << " estimated modeset(s)" << Qt::endl;
+    for (const PlannedChange &change : changes) {
+        out << "  " << change.name.leftJustified(12)
+            << ' ' << PlannedChange::kindName(change.kind).leftJustified(12)
+            << ' ' << fieldNames(change.fields);
+        if (change.kind != PlannedChange::Unchanged) {
+            out << Qt::endl << "      " << change.command;
+        }
+        out << Qt::endl;
+    }
+    return text;
+}
+
+ApplyPlan ApplyPlanner::plan(const QList<DisplayInfo> &current, const QList<DisplayInfo> &desired)
+{
+    QHash<QString, const DisplayInfo *> currentByName;
+    for (const DisplayInfo &display : current) {
+        currentByName.insert(display.name, &display);
+    }
+    
+    ApplyPlan result;
+    for (const DisplayInfo &target : desired) {
+        PlannedChange change;
+        change.name = target.name;
+        const DisplayInfo *live = currentByName.value(target.name, nullptr);
+        
+        if (!target.isEnabled()) {
+            if (live && live->isEnabled()) {
+                change.kind = PlannedChange::Disable;
+                change.fields = DisplayField::Enabled;
+                change.command = buildDisableCommand(target.name);
+            }
+        } else if (!live || !live->isEnabled()) {
+            change.kind = PlannedChange::Enable;
+            change.fields = live ? target.diff(*live) : DisplayFields(RuleFields | DisplayField::Enabled);
+            change.command = buildMonitorCommand(target);
+        } else {
+            change.fields = target.diff(*live);
+            DisplayFields ruleChanges = change.fields & RuleFields;
+            if (!ruleChanges) {
+                change.kind = PlannedChange::Unchanged;
+            } else if (ruleChanges & ModesetFields) {
+                change.kind = PlannedChange::Modeset;
+                change.command = buildMonitorCommand(target);
+            } else if (ruleChanges == DisplayFields(DisplayField::Position)) {
+                // Resend the live rule verbatim with only the offset changed so
+                // Hyprland sees an identical mode and just moves the output
+                DisplayInfo moved = *live;
+                moved.x = target.x;
+                moved.y = target.y;
+                change.kind = PlannedChange::Reposition;
+                change.command = buildMonitorCommand(moved);
+            } else {
+                change.kind = PlannedChange::Reconfigure;
+                change.command = buildMonitorCommand(target);
+            }
+        }
+        result.changes.append(change);
+    }
+    return result;
+}
+
+QString ApplyPlanner::buildMonitorCommand(const DisplayInfo &monitor)
+{
+    QString command = QString("keyword monitor %1,%2x%3@%4,%5x%6,%7")
+                     .arg(monitor.name)
+                     .arg(monitor.width)
+                     .arg(monitor.height)
+                     .arg(monitor.refreshRate)
+                     .arg(monitor.x)
+                     .arg(monitor.y)
+                     .arg(monitor.scale);
+    
+    if (monitor.transform != DisplayTransform::Normal) {
+        command += QString(",transform,%1").arg(monitor.transformNumber());
+    }
+    
+    if (!monitor.mirrorOf.isEmpty() && monitor.mirrorOf != "none") {
+        command += QString(",mirror,%1").arg(monitor.mirrorOf);
+    }
+    
+    // Keep color options in the rule, otherwise resending it would reset them
+    if (monitor.isTenBit()) {
+        command += ",bitdepth,10";
+    }
+    if (monitor.isHdr()) {
+        command += QString(",cm,hdr,sdrbrightness,%1,sdrsaturation,%2")
+                   .arg(monitor.sdrBrightness, 0, 'f', 2)
+                   .arg(monitor.sdrSaturation, 0, 'f', 2);
+    } else if (monitor.isWideGamut()) {
+        command += ",cm,wide";
+    }
+    if (monitor.vrrMode != 0) {
+        command += QString(",vrr,%1").arg(monitor.vrrMode);
+    }
+    
+    return command;
+}
+
+QString ApplyPlanner::buildDisableCommand(const QString &name)
+{
+    return QString("keyword monitor %1,disable").arg(name);
+}
@@ -0,0 +1,48 @@
+#ifndef APPLYPLANNER_H
+#define APPLYPLANNER_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "displaymanager.h"
+
+struct PlannedChange {
+    enum Kind {
+        Unchanged,      // nothing to send
+        Reposition,     // only the position moved, mode is resent unchanged
+        Reconfigure,    // scale/transform/VRR, no new mode
+        Modeset,        // new mode or color format, the panel will blank
+        Enable,
+        Disable
+    };
+    
+    QString name;
+    Kind kind = Unchanged;
+    DisplayFields fields;
+    QString command;
+    
+    bool causesModeset() const;
+    static QString kindName(Kind kind);
+};
+
+struct ApplyPlan {
+    QList<PlannedChange> changes;
+    
+    QStringList commands() const;
+    int modesetCount() const;
+    bool isEmpty() const;
+    QString describe() const;
+};
+
+// Compares the layout we want with the last state read from Hyprland and
+// only emits monitor rules for the monitors whose settings actually changed
+class ApplyPlanner
+{
+public:
+    static ApplyPlan plan(const QList<DisplayInfo> &current, const QList<DisplayInfo> &desired);
+    static QString buildMonitorCommand(const DisplayInfo &monitor);
+    static QString buildDisableCommand(const QString &name);
+};
+
+#endif // APPLYPLANNER_H
@@ -0,0 +1,368 @@
+#include "backupstore.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <algorithm>
+
+namespace {
+
+QJsonObject addRecord(const BackupEntry &entry)
+{
+    QJsonObject record;
+    record["op"] = "add";
+    record["id"] = entry.id;
+    record["hash"] = QString::fromLatin1(entry.hash);
+    record["created"] = entry.created;
+    return record;
+}
+
+QJsonObject removeRecord(const QString &id)
+{
+    QJsonObject record;
+    record["op"] = "remove";
+    record["id"] = id;
+    return record;
+}
+
+QByteArray indexLine(const QJsonObject &record)
+{
+    return QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n';
+}
+
+}
+
+BackupStore::BackupStore(const QString &directory)
+    : m_directory(directory)
+    , m_indexPath(directory + "/index")
+    , m_maxEntries(0)
+    , m_format(SnapshotFormat::Json)
+    , m_loaded(false)
+    , m_indexRecords(0)
+{
+}
+
+QString BackupStore::objectPath(const QByteArray &hash, SnapshotFormat::Format format) const
+{
+    return m_directory + "/objects/" + QString::fromLatin1(hash) + '.' + SnapshotFormat::name(format);
+}
+
+QString BackupStore::objectPath(const QByteArray &hash) const
+{
+    const QString preferred = objectPath(hash, m_format);
+    if (QFile::exists(preferred)) {
+        return preferred;
+    }
+    // Written before the format was switched
+    const QString other = objectPath(hash, m_format == SnapshotFormat::Json ? SnapshotFormat::Cbor : SnapshotFormat::Json);
+    return QFile::exists(other) ? other : preferred;
+}
+
+QString BackupStore::add(const QJsonObject &state, QString *error)
+{
+    if (!ensureLoaded(error)) {
+        return QString();
+    }
+
+    // QJsonObject keeps keys sorted, so equal states serialize identically
+    const QByteArray data = QJsonDocument(state).toJson(QJsonDocument::Compact);
+    BackupEntry entry;
+    entry.hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+    entry.created = QDateTime::currentMSecsSinceEpoch();
+    entry.id = uniqueId(entry.created);
+
+    if (!m_references.contains(entry.hash) && !writeObject(entry.hash, state, data, error)) {
+        return QString();
+    }
+    if (!appendToIndex({addRecord(entry)}, error)) {
+        if (!m_references.contains(entry.hash)) {
+            QFile::remove(objectPath(entry.hash, m_format));
+        }
+        return QString();
+    }
+    insert(entry);
+    prune();
+    return entry.id;
+}
+
+bool BackupStore::read(const QString &id, QJsonObject &state, QString *error)
+{
+    const BackupEntry *found = entry(id);
+    if (!found) {
+        if (error && error->isEmpty()) *error = QString("No backup named %1").arg(id);
+        return false;
+    }
+
+    QFile file(objectPath(found->hash));
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    return SnapshotFormat::decode(file.readAll(), state, error);
+}
+
+bool BackupStore::remove(const QString &id, QString *error)
+{
+    const BackupEntry *found = entry(id);
+    if (!found) {
+        if (error && error->isEmpty()) *error = QString("No backup named %1").arg(id);
+        return false;
+    }
+    if (!appendToIndex({removeRecord(id)}, error)) {
+        return false;
+    }
+    const QByteArray hash = found->hash;
+    m_entries.remove(id);
+    m_order.removeOne(id);
+    release(hash);
+    return true;
+}
+
+bool BackupStore::contains(const QString &id)
+{
+    return entry(id) != nullptr;
+}
+
+const BackupEntry *BackupStore::entry(const QString &id)
+{
+    QString error;
+    if (!ensureLoaded(&error)) {
+        return nullptr;
+    }
+    auto it = m_entries.constFind(id);
+    return it != m_entries.constEnd() ? &it.value() : nullptr;
+}
+
+QStringList BackupStore::ids()
+{
+    QString error;
+    ensureLoaded(&error);
+    QStringList ids(m_order.crbegin(), m_order.crend());
+    return ids;
+}
+
+int BackupStore::size()
+{
+    QString error;
+    ensureLoaded(&error);
+    return m_order.size();
+}
+
+int BackupStore::objectCount()
+{
+    QString error;
+    ensureLoaded(&error);
+    return m_references.size();
+}
+
+bool BackupStore::ensureLoaded(QString *error)
+{
+    if (m_loaded) {
+        return true;
+    }
+    if (!QDir().mkpath(m_directory + "/objects")) {
+        if (error) *error = QString("Cannot create %1").arg(m_directory + "/objects");
+        return false;
+    }
+
+    QFile file(m_indexPath);
+    if (!file.exists()) {
+        m_loaded = true;
+        importLegacyBackups();
+        return true;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+
+    bool torn = false;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine();
+        ++m_indexRecords;
+        if (!line.endsWith('\n')) {
+            // Interrupted append; the entry never made it
+            torn = true;
+            break;
+        }
+        const QJsonObject record = QJsonDocument::fromJson(line).object();
+        const QString op = record["op"].toString();
+        const QString id = record["id"].toString();
+        if (op == "add" && !m_entries.contains(id)) {
+            BackupEntry entry;
+            entry.id = id;
+            entry.hash = record["hash"].toString().toLatin1();
+            entry.created = record["created"].toVariant().toLongLong();
+            insert(entry);
+        } else if (op == "remove" && m_entries.contains(id)) {
+            // The object went when the entry was removed; only the count is replayed
+            const QByteArray hash = m_entries.take(id).hash;
+            m_order.removeOne(id);
+            if (--m_references[hash] <= 0) {
+                m_references.remove(hash);
+            }
+        }
+    }
+    file.close();
+    m_loaded = true;
+
+    // Removals pile up as retention drops old entries
+    if (torn || m_indexRecords > 2 * m_order.size() + 64) {
+        QString compactError;
+        if (!compactIndex(&compactError)) {
+            qWarning() << "Failed to compact backup index" << m_indexPath << ":" << compactError;
+        }
+    }
+    return true;
+}
+
+void BackupStore::importLegacyBackups()
+{
+    // One file per backup, from before the index existed
+    QDir dir(m_directory);
+    const QFileInfoList files = dir.entryInfoList(QStringList() << "hyprdisplays_backup_*.json", QDir::Files);
+    if (files.isEmpty()) {
+        return;
+    }
+
+    struct Legacy { QFileInfo info; QJsonObject state; qint64 created; };
+    QList<Legacy> legacy;
+    for (const QFileInfo &info : files) {
+        QFile file(info.absoluteFilePath());
+        if (!file.open(QIODevice::ReadOnly)) continue;
+        QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+        if (!doc.isObject()) continue;
+        QJsonObject state = doc.object();
+        QDateTime timestamp = QDateTime::fromString(state.take("timestamp").toString(), Qt::ISODate);
+        if (!timestamp.isValid()) timestamp = info.lastModified();
+        legacy.append({info, state, timestamp.toMSecsSinceEpoch()});
+    }
+    std::sort(legacy.begin(), legacy.end(), [](const Legacy &a, const Legacy &b) {
+        return a.created < b.created;
+    });
+
+    for (const Legacy &backup : legacy) {
+        const QByteArray data = QJsonDocument(backup.state).toJson(QJsonDocument::Compact);
+        BackupEntry entry;
+        entry.hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+        entry.created = backup.created;
+        entry.id = uniqueId(entry.created);
+
+        QString error;
+        if ((!m_references.contains(entry.hash) && !writeObject(entry.hash, backup.state, data, &error))
+            || !appendToIndex({addRecord(entry)}, &error)) {
+            qWarning() << "Failed to import backup" << backup.info.fileName() << ":" << error;
+            continue;
+        }
+        insert(entry);
+        QFile::remove(backup.info.absoluteFilePath());
+    }
+    qInfo() << "Imported" << m_order.size() << "backups into" << m_indexPath;
+}
+
+QString BackupStore::uniqueId(qint64 created) const
+{
+    const QString base = "hyprdisplays_backup_"
+                       + QDateTime::fromMSecsSinceEpoch(created).toString("yyyyMMdd_hhmmss");
+    QString id = base;
+    for (int n = 2; m_entries.contains(id); ++n) {
+        id = base + '_' + QString::number(n);
+    }
+    return id;
+}
+
+bool BackupStore::writeObject(const QByteArray &hash, const QJsonObject &state, const QByteArray &json, QString *error)
+{
+    if (QFile::exists(objectPath(hash, SnapshotFormat::Json)) || QFile::exists(objectPath(hash, SnapshotFormat::Cbor))) {
+        return true;
+    }
+    const QByteArray data = m_format == SnapshotFormat::Json ? json : SnapshotFormat::encode(state, m_format, "backup");
+    QSaveFile file(objectPath(hash, m_format));
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool BackupStore::appendToIndex(const QList<QJsonObject> &records, QString *error)
+{
+    QByteArray data;
+    for (const QJsonObject &record : records) {
+        data += indexLine(record);
+    }
+    QFile file(m_indexPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append) || file.write(data) != data.size()) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    m_indexRecords += records.size();
+    return true;
+}
+
+bool BackupStore::compactIndex(QString *error)
+{
+    QByteArray data;
+    for (const QString &id : m_order) {
+        data += indexLine(addRecord(m_entries.value(id)));
+    }
+    QSaveFile file(m_indexPath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    m_indexRecords = m_order.size();
+    return true;
+}
+
+void BackupStore::insert(const BackupEntry &entry)
+{
+    m_entries.insert(entry.id, entry);
+    m_order.append(entry.id);
+    m_references[entry.hash] += 1;
+}
+
+void BackupStore::release(const QByteArray &hash)
+{
+    auto it = m_references.find(hash);
+    if (it == m_references.end()) {
+        return;
+    }
+    if (--it.value() > 0) {
+        return;
+    }
+    m_references.erase(it);
+    QFile::remove(objectPath(hash, SnapshotFormat::Json));
+    QFile::remove(objectPath(hash, SnapshotFormat::Cbor));
+}
+
+void BackupStore::prune()
+{
+    if (m_maxEntries <= 0 || m_order.size() <= m_maxEntries) {
+        return;
+    }
+
+    const int excess = m_order.size() - m_maxEntries;
+    QList<QJsonObject> records;
+    records.reserve(excess);
+    for (int i = 0; i < excess; ++i) {
+        records.append(removeRecord(m_order.at(i)));
+    }
+    QString error;
+    if (!appendToIndex(records, &error)) {
+        qWarning() << "Failed to prune backups:" << error;
+        return;
+    }
+    for (int i = 0; i < excess; ++i) {
+        const QString id = m_order.takeFirst();
+        release(m_entries.take(id).hash);
+    }
+
+    if (m_indexRecords > 2 * m_order.size() + 64 && !compactIndex(&error)) {
+        qWarning() << "Failed to compact backup index" << m_indexPath << ":" << error;
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef BACKUPSTORE_H
+#define BACKUPSTORE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "snapshotformat.h"
+
+// One backup in the index. Several entries may share a hash.
+struct BackupEntry {
+    QString id;         // hyprdisplays_backup_yyyyMMdd_hhmmss, with a suffix when taken in the same second
+    QByteArray hash;    // hex SHA-1 of the stored state
+    qint64 created = 0; // ms since epoch, UTC
+};
+
+// Backups stored by content hash: objects/<sha1>.json (or .cbor) holds a state once
+// however many entries refer to it, and an append-only index records the
+// entries with their timestamps. Listing reads the index only, adding writes
+// at most one object and one index line, and the oldest entries beyond the
+// retention limit are dropped as new ones arrive.
+class BackupStore
+{
+public:
+    explicit BackupStore(const QString &directory);
+
+    QString directory() const { return m_directory; }
+    int maxEntries() const { return m_maxEntries; }
+    // 0 keeps everything; applied on the next add()
+    void setMaxEntries(int maxEntries) { m_maxEntries = qMax(0, maxEntries); }
+    // Format of new objects. The hash is taken over the state, not the
+    // encoding, so switching formats does not duplicate existing backups.
+    void setFormat(SnapshotFormat::Format format) { m_format = format; }
+
+    // Stores state and returns the id of the new entry, or an empty string
+    QString add(const QJsonObject &state, QString *error = nullptr);
+    bool read(const QString &id, QJsonObject &state, QString *error = nullptr);
+    bool remove(const QString &id, QString *error = nullptr);
+    bool contains(const QString &id);
+    const BackupEntry *entry(const QString &id);
+
+    QStringList ids();  // newest first
+    int size();
+    int objectCount();
+    // Where the object is on disk, or where it would be written
+    QString objectPath(const QByteArray &hash) const;
+
+private:
+    bool ensureLoaded(QString *error);
+    void importLegacyBackups();
+    QString uniqueId(qint64 created) const;
+    QString objectPath(const QByteArray &hash, SnapshotFormat::Format format) const;
+    // json is state as compact JSON, already made for the hash
+    bool writeObject(const QByteArray &hash, const QJsonObject &state, const QByteArray &json, QString *error);
+    bool appendToIndex(const QList<QJsonObject> &records, QString *error);
+    bool compactIndex(QString *error);
+    void insert(const BackupEntry &entry);
+    void release(const QByteArray &hash);
+    void prune();
+
+    QString m_directory;
+    QString m_indexPath;
+    int m_maxEntries;
+    SnapshotFormat::Format m_format;
+    bool m_loaded;
+    int m_indexRecords;                  // lines in the index file, live or not
+    QList<QString> m_order;              // ids, oldest first
+    QHash<QString, BackupEntry> m_entries;
+    QHash<QByteArray, int> m_references; // hash -> entries using it
+};
+
+#endif // BACKUPSTORE_H
@@ -0,0 +1,319 @@
+#include "cli.h"
+#include "configmanager.h"
+#include "controlserver.h"
+#include "displaymanager.h"
+#include "layoutprofilestore.h"
+#include "monitorstatestore.h"
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QTextStream>
+#include <QTimer>
+#include <algorithm>
+
+namespace {
+
+const char *const Subcommands[] = {"list", "dump", "apply"};
+
+bool isSubcommandName(const QString &command)
+{
+    return std::any_of(std::begin(Subcommands), std::end(Subcommands),
+                       [&](const char *name) { return command == QLatin1String(name); });
+}
+
+// Hyprland answers in milliseconds; this only guards against a hung compositor
+const int ReplyTimeoutMs = 5000;
+
+struct Options {
+    QString command;
+    QStringList arguments;
+    bool json = false;
+    bool profiles = false;
+    bool dryRun = false;
+    bool cached = false;
+    QString monitorsPath;
+    QString profilesPath;
+};
+
+bool refreshLive(DisplayManager &displayManager, QTextStream &err)
+{
+    QEventLoop loop;
+    bool refreshed = false;
+    QObject::connect(&displayManager, &DisplayManager::refreshFinished, &loop, [&](bool ok) {
+        refreshed = ok;
+        loop.quit();
+    });
+    QTimer::singleShot(ReplyTimeoutMs, &loop, &QEventLoop::quit);
+    if (displayManager.refreshDisplays()) {
+        loop.exec();
+    }
+    if (!refreshed) {
+        err << "Failed to read monitors from Hyprland" << Qt::endl;
+    }
+    return refreshed;
+}
+
+bool loadProfiles(LayoutProfileStore &profiles, const QString &path, QTextStream &err)
+{
+    QString loadError;
+    if (!profiles.load(path, &loadError)) {
+        err << "Failed to read layout profiles from " << path << ": " << loadError << Qt::endl;
+        return false;
+    }
+    return true;
+}
+
+QJsonObject profileToJson(const LayoutProfile &profile)
+{
+    QJsonArray displays;
+    for (const DisplayInfo &display : profile.displays) {
+        QJsonObject json = display.toJson();
+        json.remove("availableModes");
+        displays.append(json);
+    }
+    QJsonObject json;
+    json["fingerprint"] = profile.fingerprint;
+    json["updated"] = profile.updated.toString(Qt::ISODate);
+    json["displays"] = displays;
+    return json;
+}
+
+QString describe(const DisplayInfo &display)
+{
+    if (!display.isEnabled()) {
+        return QString("%1  disabled").arg(display.name);
+    }
+    return QString("%1  %2@%3 at %4 scale %5%6  %7 %8")
+        .arg(display.name, display.resolution())
+        .arg(display.refreshRate, 0, 'f', 2)
+        .arg(display.position())
+        .arg(display.scale)
+        .arg(display.transform != DisplayTransform::Normal ? " " + display.transformName() : QString())
+        .arg(display.manufacturer, display.model);
+}
+
+int runList(const Options &options, QTextStream &out, QTextStream &err)
+{
+    if (options.profiles) {
+        LayoutProfileStore profiles;
+        if (!loadProfiles(profiles, options.profilesPath, err)) return 1;
+        QStringList fingerprints = profiles.fingerprints();
+        fingerprints.sort();
+        QJsonArray array;
+        for (const QString &fingerprint : fingerprints) {
+            const LayoutProfile *profile = profiles.find(fingerprint);
+            if (options.json) {
+                array.append(profileToJson(*profile));
+                continue;
+            }
+            QStringList names;
+            for (const DisplayInfo &display : profile->displays) names.append(display.name);
+            out << fingerprint.left(12) << "  " << profile->updated.toLocalTime().toString("yyyy-MM-dd hh:mm")
+                << "  " << names.join(", ") << Qt::endl;
+        }
+        if (options.json) out << QJsonDocument(array).toJson(QJsonDocument::Compact) << Qt::endl;
+        return 0;
+    }
+
+    QList<DisplayInfo> displays;
+    if (options.cached) {
+        // What the daemon or the window last read; no request reaches Hyprland
+        QJsonValue layout;
+        QString callError;
+        if (!ControlServer::call(ControlServer::defaultSocketPath(), "getLayout", QJsonObject(), layout, &callError)) {
+            err << "No answer on " << ControlServer::defaultSocketPath() << ": " << callError << Qt::endl;
+            return 1;
+        }
+        for (const QJsonValue &monitor : layout["monitors"].toArray()) {
+            displays.append(DisplayInfo::fromJson(monitor.toObject()));
+        }
+    } else {
+        DisplayManager displayManager;
+        if (!refreshLive(displayManager, err)) return 1;
+        displays = displayManager.snapshot()->displays;
+    }
+    if (options.json) {
+        QJsonArray array;
+        for (const DisplayInfo &display : displays) array.append(display.toJson());
+        out << QJsonDocument(array).toJson(QJsonDocument::Compact) << Qt::endl;
+        return 0;
+    }
+    for (const DisplayInfo &display : displays) {
+        out << describe(display) << Qt::endl;
+    }
+    return 0;
+}
+
+int runDump(const Options &options, QTextStream &out, QTextStream &err)
+{
+    DisplayManager displayManager;
+    if (!refreshLive(displayManager, err)) return 1;
+    const QList<DisplayInfo> &displays = displayManager.snapshot()->displays;
+
+    QJsonArray monitors;
+    for (const DisplayInfo &display : displays) monitors.append(display.toJson());
+
+    LayoutProfileStore profiles;
+    loadProfiles(profiles, options.profilesPath, err);
+    const QString fingerprint = LayoutProfileStore::fingerprint(displays);
+    const LayoutProfile *profile = profiles.find(fingerprint);
+
+    QJsonObject monitorsConf;
+    monitorsConf["path"] = options.monitorsPath;
+    if (QFile::exists(options.monitorsPath)) {
+        ConfigManager configManager;
+        if (configManager.loadHyprlandMonitors(options.monitorsPath)) {
+            monitorsConf["displays"] = configManager.getDisplayConfig()["displays"];
+        }
+    }
+
+    QJsonObject dump;
+    dump["monitors"] = monitors;
+    dump["fingerprint"] = fingerprint;
+    dump["profile"] = profile ? QJsonValue(profileToJson(*profile)) : QJsonValue();
+    dump["profileCount"] = profiles.size();
+    dump["monitorsConf"] = monitorsConf;
+    out << QJsonDocument(dump).toJson() << Qt::flush;
+    return 0;
+}
+
+int runApply(const Options &options, QTextStream &out, QTextStream &err)
+{
+    if (options.arguments.size() != 1) {
+        err << "Usage: hyprdisplays apply <fingerprint|auto> [--dry-run]" << Qt::endl;
+        return 2;
+    }
+    const QString wanted = options.arguments.first();
+
+    LayoutProfileStore profiles;
+    if (!loadProfiles(profiles, options.profilesPath, err)) return 1;
+    DisplayManager displayManager;
+    if (!refreshLive(displayManager, err)) return 1;
+    QList<DisplayInfo> live = displayManager.snapshot()->displays;
+
+    QString error;
+    const LayoutProfile *profile = profiles.resolve(wanted, live, &error);
+    if (!profile) {
+        err << error << Qt::endl;
+        return 1;
+    }
+    if (!profile->applyTo(live)) {
+        err << "Warning: some connected monitors are not part of profile " << profile->fingerprint.left(12) << Qt::endl;
+    }
+    displayManager.setDisplays(live);
+
+    if (options.dryRun) {
+        out << displayManager.dryRunConfiguration();
+        return 0;
+    }
+
+    QEventLoop loop;
+    bool applied = false;
+    bool finished = false;
+    QObject::connect(&displayManager, &DisplayManager::applyFinished, &loop, [&](bool ok) {
+        applied = ok;
+        finished = true;
+        loop.quit();
+    });
+    QTimer::singleShot(ReplyTimeoutMs, &loop, &QEventLoop::quit);
+    // applyConfiguration() finishes synchronously when there is nothing to change
+    if (!displayManager.applyConfiguration()) {
+        err << "Failed to apply profile " << profile->fingerprint.left(12) << Qt::endl;
+        return 1;
+    }
+    if (!finished) {
+        loop.exec();
+    }
+    if (!applied) {
+        const HyprlandBatchResult result = displayManager.lastApplyResult();
+        err << "Failed to apply profile " << profile->fingerprint.left(12)
+            << (result.error.isEmpty() ? QString() : ": " + result.error) << Qt::endl;
+        return 1;
+    }
+    out << "Applied profile " << profile->fingerprint.left(12) << " to " << live.size() << " monitors" << Qt::endl;
+    return 0;
+}
+
+}
+
+namespace Cli {
+
+bool isSubcommand(int argc, char *argv[])
+{
+    return argc >= 2 && isSubcommandName(QString::fromLocal8Bit(argv[1]));
+}
+
+int run(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("HyprDisplays");
+    app.setApplicationVersion("1.0.0");
+    app.setOrganizationName("HyprDisplays");
+    app.setOrganizationDomain("hyprdisplays.org");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Hyprland display management utility, without a window");
+    parser.addHelpOption();
+    parser.addPositionalArgument("command", "list, dump or apply");
+    parser.addPositionalArgument("profile", "For apply: a profile fingerprint (or a prefix of it) or \"auto\"", "[profile]");
+
+    QCommandLineOption jsonOption("json", "Print JSON instead of one line per monitor or profile");
+    QCommandLineOption profilesOption("profiles", "List the saved layout profiles instead of the connected monitors");
+    QCommandLineOption dryRunOption("dry-run", "Print the commands apply would send and exit");
+    QCommandLineOption cachedOption("cached", "List the monitors the daemon or the window last saw instead of asking Hyprland");
+    QCommandLineOption verboseOption(QStringList() << "v" << "verbose", "Log debug output to stderr");
+    QCommandLineOption monitorsPathOption(
+        QStringList() << "m" << "monitors-path",
+        "Path of the monitors.conf file",
+        "path",
+        QDir::homePath() + "/.config/hypr/monitors.conf"
+    );
+    QCommandLineOption profilesPathOption(
+        "profiles-path",
+        "Path of the saved layout profiles",
+        "path",
+        LayoutProfileStore::defaultPath()
+    );
+    parser.addOption(jsonOption);
+    parser.addOption(profilesOption);
+    parser.addOption(dryRunOption);
+    parser.addOption(cachedOption);
+    parser.addOption(verboseOption);
+    parser.addOption(monitorsPathOption);
+    parser.addOption(profilesPathOption);
+    parser.process(app);
+
+    // Output is meant for scripts; logging stays on stderr and only when asked for
+    if (!parser.isSet(verboseOption)) {
+        QLoggingCategory::setFilterRules("*.debug=false\n*.info=false");
+    }
+
+    Options options;
+    options.arguments = parser.positionalArguments();
+    // hyprdisplays-cli gets here without a command; hyprdisplays only with one
+    if (options.arguments.isEmpty() || !isSubcommandName(options.arguments.first())) {
+        parser.showHelp(2);
+    }
+    options.command = options.arguments.takeFirst();
+    options.json = parser.isSet(jsonOption);
+    options.profiles = parser.isSet(profilesOption);
+    options.dryRun = parser.isSet(dryRunOption);
+    options.cached = parser.isSet(cachedOption);
+    options.monitorsPath = parser.value(monitorsPathOption);
+    options.profilesPath = parser.value(profilesPathOption);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    if (options.command == QLatin1String("list")) return runList(options, out, err);
+    if (options.command == QLatin1String("dump")) return runDump(options, out, err);
+    return runApply(options, out, err);
+}
+
+}
@@ -0,0 +1,21 @@
+#ifndef CLI_H
+#define CLI_H
+
+// Subcommands that run without a window, for hotplug hooks and login
+// scripts:
+//   hyprdisplays list [--json] [--profiles] [--cached]
+//   hyprdisplays dump
+//   hyprdisplays apply <profile|auto> [--dry-run]
+// They run on a QCoreApplication against the same DisplayManager and
+// ConfigManager code as the window, so no widget, style or tray code runs.
+// hyprdisplays-cli takes the same commands and does not load the GUI
+// libraries at all.
+namespace Cli {
+
+// Checked before any application object exists
+bool isSubcommand(int argc, char *argv[]);
+int run(int argc, char *argv[]);
+
+}
+
+#endif // CLI_H
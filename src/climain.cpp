@@ -0,0 +1,12 @@
+#include "cli.h"
+#include "hotplugdaemon.h"
+
+// hyprdisplays-cli: the headless subcommands and the daemon, linked
+// against the core library only
+int main(int argc, char *argv[])
+{
+    if (HotplugDaemon::isRequested(argc, argv)) {
+        return HotplugDaemon::run(argc, argv);
+    }
+    return Cli::run(argc, argv);
+}
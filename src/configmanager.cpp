@@ -1,4 +1,5 @@
 #include "configmanager.h"
+#include "monitorsconfwriter.h"
 #include <QSettings>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -13,9 +14,13 @@
 #include <QVariant>
 #include <QVariantMap>
 #include <QVariantList>
+#include <QDateTime>
 #include <QDir>
+#include <QFileInfo>
 #include <QStandardPaths>
 #include <QDebug>
+#include <QPair>
+#include <utility>
 
 ConfigManager::ConfigManager(QObject *parent)
     : QObject(parent)
@@ -25,13 +30,18 @@ ConfigManager::ConfigManager(QObject *parent)
     , m_autoSave(true)
     , m_autoBackup(true)
     , m_maxBackups(5)
+    , m_snapshotFormat(SnapshotFormat::Json)
     , m_strictValidation(true)
+    , m_watcher(nullptr)
+    , m_reloadTimer(nullptr)
+    , m_reloadDelayMs(200)
     , m_enableImportExport(true)
 {
     // Initialize paths
     m_configPath = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation) + "/HyprDisplays";
     m_settingsPath = m_configPath + "/settings.json";
     m_backupPath = m_configPath + "/backups";
+    m_hyprlandConfPath = QDir::homePath() + "/.config/hypr/hyprland.conf";
     m_monitorsPath = QDir::homePath() + "/.config/hypr/monitors.conf";
     m_workspacesPath = QDir::homePath() + "/.config/hypr/workspaces.conf";
     
@@ -42,12 +52,22 @@ ConfigManager::ConfigManager(QObject *parent)
     // Initialize settings
     m_settings = new QSettings("HyprDisplays", "HyprDisplays", this);
     
-    // Setup backup file regex
-    m_backupFileRegex = QRegularExpression(R"(hyprdisplays_backup_\d{8}_\d{6}\.json)");
+    // Backups are stored by content and listed from the store's index
+    m_backupStore.reset(new BackupStore(m_backupPath));
     
     // Setup supported formats
     m_supportedFormats = {"json", "conf", "txt"};
     
+    // Watch every loaded Hyprland file and the directories holding them, so
+    // saves that rename a new file into place are seen too. An editor's
+    // write/rename/chmod burst is coalesced into one reload.
+    m_watcher = new QFileSystemWatcher(this);
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &ConfigManager::onFileChanged);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &ConfigManager::onDirectoryChanged);
+    m_reloadTimer = new QTimer(this);
+    m_reloadTimer->setSingleShot(true);
+    connect(m_reloadTimer, &QTimer::timeout, this, &ConfigManager::reloadChangedFiles);
+    
     // Load initial settings
     loadApplicationSettings();
 }
@@ -79,8 +99,12 @@ bool ConfigManager::loadApplicationSettings()
             m_autoSave = m_applicationConfig["autoSave"].toBool(true);
             m_autoBackup = m_applicationConfig["autoBackup"].toBool(true);
             m_maxBackups = m_applicationConfig["maxBackups"].toInt(5);
+            m_backupStore->setMaxEntries(m_maxBackups);
+            m_snapshotFormat = SnapshotFormat::fromName(m_applicationConfig["snapshotFormat"].toString());
+            m_backupStore->setFormat(m_snapshotFormat);
             m_strictValidation = m_applicationConfig["strictValidation"].toBool(true);
             m_enableImportExport = m_applicationConfig["enableImportExport"].toBool(true);
+            m_reloadDelayMs = qMax(0, m_applicationConfig["reloadDelayMs"].toInt(200));
         }
     }
     
@@ -103,6 +127,8 @@ bool ConfigManager::saveApplicationSettings()
     m_applicationConfig["maxBackups"] = m_maxBackups;
     m_applicationConfig["strictValidation"] = m_strictValidation;
     m_applicationConfig["enableImportExport"] = m_enableImportExport;
+    m_applicationConfig["reloadDelayMs"] = m_reloadDelayMs;
+    m_applicationConfig["snapshotFormat"] = SnapshotFormat::name(m_snapshotFormat);
     
     QJsonDocument doc(m_applicationConfig);
     QFile file(m_settingsPath);
@@ -131,25 +157,38 @@ void ConfigManager::resetApplicationSettings()
     m_autoSave = true;
     m_autoBackup = true;
     m_maxBackups = 5;
+    m_backupStore->setMaxEntries(m_maxBackups);
+    m_snapshotFormat = SnapshotFormat::Json;
+    m_backupStore->setFormat(m_snapshotFormat);
     m_strictValidation = true;
     m_enableImportExport = true;
+    m_reloadDelayMs = 200;
     
     saveApplicationSettings();
     emit settingsChanged();
 }
 
+void ConfigManager::setSnapshotFormat(SnapshotFormat::Format format)
+{
+    m_snapshotFormat = format;
+    m_backupStore->setFormat(format);
+}
+
+void ConfigManager::setReloadDelay(int ms)
+{
+    m_reloadDelayMs = qMax(0, ms);
+}
+
 bool ConfigManager::loadHyprlandConfig()
 {
-    QFile file(m_configPath + "/hyprland.conf");
-    if (!file.open(QIODevice::ReadOnly)) {
-        emit error("Failed to open Hyprland config file");
+    const HyprConfig *config = loadHyprlandFile(m_hyprlandConfPath, HyprlandFile);
+    if (!config) {
+        emit error(QString("Failed to open Hyprland config file: %1").arg(m_hyprlandConfPath));
         return false;
     }
     
-    QString content = QString::fromUtf8(file.readAll());
-    file.close();
-    
-    if (!parseHyprlandMonitorsConfig(content)) {
+    if (!parseHyprlandMonitorsConfig(config->values("monitor")) ||
+        !parseHyprlandWorkspacesConfig(config->values("workspace"))) {
         emit error("Failed to parse Hyprland config");
         return false;
     }
@@ -160,35 +199,20 @@ bool ConfigManager::loadHyprlandConfig()
 
 bool ConfigManager::saveHyprlandConfig(const QString &path)
 {
-    QString configContent = generateHyprlandMonitorsConfig(m_displayConfig);
-    
-    QFile file(path.isEmpty() ? m_monitorsPath : path);
-    if (!file.open(QIODevice::WriteOnly)) {
-        emit error(QString("Failed to open file for writing: %1").arg(file.fileName()));
-        return false;
-    }
-    
-    file.write(configContent.toUtf8());
-    file.close();
-    
-    emit success("Hyprland config saved successfully");
-    return true;
+    return saveHyprlandMonitors(path);
 }
 
 bool ConfigManager::loadHyprlandMonitors(const QString &path)
 {
     QString filePath = path.isEmpty() ? m_monitorsPath : path;
     
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
+    const HyprConfig *config = loadHyprlandFile(filePath, MonitorsFile);
+    if (!config) {
         emit error(QString("Failed to open monitors file: %1").arg(filePath));
         return false;
     }
     
-    QString content = QString::fromUtf8(file.readAll());
-    file.close();
-    
-    if (!parseHyprlandMonitorsConfig(content)) {
+    if (!parseHyprlandMonitorsConfig(config->values("monitor"))) {
         emit error("Failed to parse monitors configuration");
         return false;
     }
@@ -199,35 +223,52 @@ bool ConfigManager::loadHyprlandMonitors(const QString &path)
 
 bool ConfigManager::saveHyprlandMonitors(const QString &path)
 {
-    QString configContent = generateHyprlandMonitorsConfig(m_displayConfig);
+    MonitorsConfWriter writer(path.isEmpty() ? m_monitorsPath : path);
     
-    QFile file(path.isEmpty() ? m_monitorsPath : path);
-    if (!file.open(QIODevice::WriteOnly)) {
-        emit error(QString("Failed to open file for writing: %1").arg(file.fileName()));
-        return false;
+    // Only rules whose settings changed are rewritten; comments, other
+    // keywords and rules for unplugged monitors stay as they are
+    QJsonArray displays = m_displayConfig["displays"].toArray();
+    for (const QJsonValue &value : displays) {
+        QJsonObject display = value.toObject();
+        QString name = display["name"].toString();
+        QString rule = generateMonitorRule(display);
+        QString existing = writer.rule(name);
+        if (existing.isNull()) {
+            writer.setRule(name, rule);
+        } else if (generateMonitorRule(parseMonitorRule(existing)) != rule) {
+            writer.setRule(name, mergeMonitorRule(existing, rule));
+        }
     }
     
-    file.write(configContent.toUtf8());
-    file.close();
+    QString saveError;
+    switch (writer.save(&saveError)) {
+    case MonitorsConfWriter::Unchanged:
+        qDebug() << "monitors.conf already up to date, not rewritten:" << writer.path();
+        emit success("Monitors configuration is already up to date");
+        return true;
+    case MonitorsConfWriter::Saved:
+        rememberOwnWrite(writer.path());
+        emit success("Monitors configuration saved successfully");
+        return true;
+    case MonitorsConfWriter::Failed:
+        break;
+    }
     
-    emit success("Monitors configuration saved successfully");
-    return true;
+    emit error(QString("Failed to write %1: %2").arg(writer.path(), saveError));
+    return false;
 }
 
 bool ConfigManager::loadHyprlandWorkspaces(const QString &path)
 {
     QString filePath = path.isEmpty() ? m_workspacesPath : path;
     
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
+    const HyprConfig *config = loadHyprlandFile(filePath, WorkspacesFile);
+    if (!config) {
         emit error(QString("Failed to open workspaces file: %1").arg(filePath));
         return false;
     }
     
-    QString content = QString::fromUtf8(file.readAll());
-    file.close();
-    
-    if (!parseHyprlandWorkspacesConfig(content)) {
+    if (!parseHyprlandWorkspacesConfig(config->values("workspace"))) {
         emit error("Failed to parse workspaces configuration");
         return false;
     }
@@ -246,8 +287,10 @@ bool ConfigManager::saveHyprlandWorkspaces(const QString &path)
         return false;
     }
     
-    file.write(configContent.toUtf8());
+    QByteArray data = configContent.toUtf8();
+    file.write(data);
     file.close();
+    rememberOwnWrite(file.fileName());
     
     emit success("Workspaces configuration saved successfully");
     return true;
@@ -277,54 +320,66 @@ void ConfigManager::setWorkspaceConfig(const QJsonObject &config)
 
 bool ConfigManager::createBackup(const QString &path)
 {
-    QString backupPath = path;
-    if (backupPath.isEmpty()) {
-        QDateTime now = QDateTime::currentDateTime();
-        backupPath = m_backupPath + QString("/hyprdisplays_backup_%1.json")
-                    .arg(now.toString("yyyyMMdd_hhmmss"));
-    }
-    
     QJsonObject backupData;
     backupData["displayConfig"] = m_displayConfig;
     backupData["workspaceConfig"] = m_workspaceConfig;
     backupData["applicationConfig"] = m_applicationConfig;
-    backupData["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
     backupData["version"] = "1.0.0";
     
-    QJsonDocument doc(backupData);
-    QFile file(backupPath);
+    if (path.isEmpty()) {
+        // The timestamp lives in the index so identical states share one object
+        QString storeError;
+        QString id = m_backupStore->add(backupData, &storeError);
+        if (id.isEmpty()) {
+            emit error(QString("Failed to create backup: %1").arg(storeError));
+            return false;
+        }
+        emit backupCreated(id);
+        emit success("Backup created successfully");
+        return true;
+    }
+    
+    backupData["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    QFile file(path);
     
     if (!file.open(QIODevice::WriteOnly)) {
-        emit error(QString("Failed to create backup: %1").arg(backupPath));
+        emit error(QString("Failed to create backup: %1").arg(path));
         return false;
     }
     
-    file.write(doc.toJson());
+    file.write(SnapshotFormat::encode(backupData, m_snapshotFormat, "backup"));
     file.close();
     
-    emit backupCreated(backupPath);
+    emit backupCreated(path);
     emit success("Backup created successfully");
     return true;
 }
 
 bool ConfigManager::restoreBackup(const QString &path)
 {
-    QFile file(path);
-    if (!file.open(QIODevice::ReadOnly)) {
-        emit error(QString("Failed to open backup file: %1").arg(path));
-        return false;
-    }
-    
-    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-    file.close();
-    
-    if (doc.isNull()) {
-        emit error("Invalid backup file format");
-        return false;
+    QJsonObject backupData;
+    if (m_backupStore->contains(path)) {
+        QString storeError;
+        if (!m_backupStore->read(path, backupData, &storeError)) {
+            emit error(QString("Failed to read backup %1: %2").arg(path, storeError));
+            return false;
+        }
+    } else {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            emit error(QString("Failed to open backup file: %1").arg(path));
+            return false;
+        }
+        
+        const QByteArray data = file.readAll();
+        file.close();
+        
+        if (!SnapshotFormat::decode(data, backupData)) {
+            emit error("Invalid backup file format");
+            return false;
+        }
     }
     
-    QJsonObject backupData = doc.object();
-    
     m_displayConfig = backupData["displayConfig"].toObject();
     m_workspaceConfig = backupData["workspaceConfig"].toObject();
     m_applicationConfig = backupData["applicationConfig"].toObject();
@@ -336,28 +391,15 @@ bool ConfigManager::restoreBackup(const QString &path)
 
 QStringList ConfigManager::getBackups() const
 {
-    QStringList backups;
-    QDir backupDir(m_backupPath);
-    
-    QFileInfoList files = backupDir.entryInfoList(QStringList() << "*.json", QDir::Files);
-    for (const QFileInfo &fileInfo : files) {
-        if (m_backupFileRegex.match(fileInfo.fileName()).hasMatch()) {
-            backups.append(fileInfo.absoluteFilePath());
-        }
-    }
-    
-    // Sort by modification time (newest first)
-    std::sort(backups.begin(), backups.end(), [](const QString &a, const QString &b) {
-        return QFileInfo(a).lastModified() > QFileInfo(b).lastModified();
-    });
-    
-    return backups;
+    return m_backupStore->ids();
 }
 
 bool ConfigManager::deleteBackup(const QString &path)
 {
-    QFile file(path);
-    if (file.remove()) {
+    QString storeError;
+    bool removed = m_backupStore->contains(path) ? m_backupStore->remove(path, &storeError)
+                                                 : QFile::remove(path);
+    if (removed) {
         emit backupDeleted(path);
         emit success("Backup deleted successfully");
         return true;
@@ -470,14 +512,148 @@ void ConfigManager::onWorkspaceConfigChanged()
 
 void ConfigManager::onFileChanged(const QString &path)
 {
-    Q_UNUSED(path)
-    // TODO: Implement file change monitoring
+    m_pendingChanges.insert(path);
+    m_reloadTimer->start(m_reloadDelayMs);
 }
 
 void ConfigManager::onDirectoryChanged(const QString &path)
 {
-    Q_UNUSED(path)
-    // TODO: Implement directory change monitoring
+    // A file was created, removed or renamed in path; which one is sorted out
+    // against the parse caches when the burst is over
+    for (const QString &file : m_watchedFiles) {
+        if (QFileInfo(file).absolutePath() == path) {
+            m_pendingChanges.insert(file);
+        }
+    }
+    m_reloadTimer->start(m_reloadDelayMs);
+}
+
+void ConfigManager::reloadChangedFiles()
+{
+    QSet<QString> changed;
+    for (const QString &path : std::as_const(m_pendingChanges)) {
+        // Our own saves come back as change events too
+        if (!isOwnWrite(path)) {
+            changed.insert(path);
+        }
+    }
+    m_pendingChanges.clear();
+    
+    // Reload only the roots that include a file whose mtime or size really
+    // changed; their parse cache then re-reads just those files
+    QList<QPair<QString, HyprlandFileKind>> roots;
+    QStringList edited;
+    for (auto it = m_hyprlandFiles.cbegin(); it != m_hyprlandFiles.cend(); ++it) {
+        bool affected = false;
+        for (const QString &stale : it->config.staleFiles()) {
+            if (changed.contains(stale)) {
+                affected = true;
+                if (!edited.contains(stale)) edited.append(stale);
+            }
+        }
+        if (affected) {
+            roots.append(qMakePair(it.key(), it->kind));
+        }
+    }
+    
+    for (const QString &path : edited) {
+        qInfo() << "Hyprland config edited externally:" << path;
+        emit hyprlandFileChanged(path);
+    }
+    for (const auto &root : roots) {
+        switch (root.second) {
+        case HyprlandFile:
+            if (loadHyprlandConfig()) {
+                emit hyprlandMonitorsReloaded();
+                emit hyprlandWorkspacesReloaded();
+            }
+            break;
+        case MonitorsFile:
+            if (loadHyprlandMonitors(root.first)) {
+                emit hyprlandMonitorsReloaded();
+            }
+            break;
+        case WorkspacesFile:
+            if (loadHyprlandWorkspaces(root.first)) {
+                emit hyprlandWorkspacesReloaded();
+            }
+            break;
+        }
+    }
+    
+    // Saves that rename over a file drop its watch; put it back
+    updateWatchedFiles();
+}
+
+void ConfigManager::updateWatchedFiles()
+{
+    QStringList files;
+    for (const LoadedHyprlandFile &loaded : std::as_const(m_hyprlandFiles)) {
+        for (const QString &path : loaded.config.files()) {
+            if (!files.contains(path)) files.append(path);
+        }
+    }
+    QStringList directories;
+    for (const QString &path : files) {
+        QString directory = QFileInfo(path).absolutePath();
+        if (!directories.contains(directory)) directories.append(directory);
+    }
+    
+    // Compare with what the watcher really has, not with m_watchedFiles
+    const QStringList watchedFiles = m_watcher->files();
+    const QStringList watchedDirectories = m_watcher->directories();
+    QStringList stale;
+    for (const QString &path : watchedFiles) {
+        if (!files.contains(path)) stale.append(path);
+    }
+    for (const QString &path : watchedDirectories) {
+        if (!directories.contains(path)) stale.append(path);
+    }
+    if (!stale.isEmpty()) {
+        m_watcher->removePaths(stale);
+    }
+    
+    QStringList added;
+    for (const QString &path : files) {
+        if (!watchedFiles.contains(path) && QFileInfo::exists(path)) added.append(path);
+    }
+    for (const QString &path : directories) {
+        if (!watchedDirectories.contains(path)) added.append(path);
+    }
+    if (!added.isEmpty()) {
+        for (const QString &path : m_watcher->addPaths(added)) {
+            qWarning() << "Cannot watch" << path;
+        }
+    }
+    
+    m_watchedFiles = files;
+    m_watchedDirectories = directories;
+}
+
+void ConfigManager::rememberOwnWrite(const QString &path)
+{
+    QFileInfo info(path);
+    QString canonical = info.canonicalFilePath();
+    if (!canonical.isEmpty()) {
+        m_ownWrites.insert(canonical, OwnWrite{info.size(), info.lastModified()});
+    }
+}
+
+bool ConfigManager::isOwnWrite(const QString &path)
+{
+    auto it = m_ownWrites.find(path);
+    if (it == m_ownWrites.end()) {
+        return false;
+    }
+    
+    // A stat is enough: any later write moves the mtime on
+    QFileInfo info(path);
+    if (info.exists() && info.size() == it->size && info.lastModified() == it->modified) {
+        return true;
+    }
+    // Someone else has written to it since
+    m_ownWrites.erase(it);
+    return false;
 }
 
 bool ConfigManager::readJsonFile(const QString &path, QJsonObject &json)
@@ -487,27 +663,21 @@ bool ConfigManager::readJsonFile(const QString &path, QJsonObject &json)
         return false;
     }
     
-    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    const QByteArray data = file.readAll();
     file.close();
     
-    if (doc.isNull()) {
-        return false;
-    }
-    
-    json = doc.object();
-    return true;
+    return SnapshotFormat::decode(data, json);
 }
 
 bool ConfigManager::writeJsonFile(const QString &path, const QJsonObject &json)
 {
-    QJsonDocument doc(json);
     QFile file(path);
     
     if (!file.open(QIODevice::WriteOnly)) {
         return false;
     }
     
-    file.write(doc.toJson());
+    file.write(SnapshotFormat::encode(json, m_snapshotFormat));
     file.close();
     return true;
 }
@@ -536,118 +706,37 @@ bool ConfigManager::writeTextFile(const QString &path, const QString &content)
     return true;
 }
 
-bool ConfigManager::parseHyprlandMonitorsConfig(const QString &content)
+const HyprConfig *ConfigManager::loadHyprlandFile(const QString &path, HyprlandFileKind kind)
+{
+    // Each root keeps its own parse cache, so files unchanged since its last
+    // load are not read again
+    LoadedHyprlandFile &loaded = m_hyprlandFiles[path];
+    loaded.kind = kind;
+    bool ok = loaded.config.load(path);
+    for (const QString &problem : loaded.config.errors()) {
+        qWarning() << "Hyprland config:" << problem;
+    }
+    qDebug() << "Loaded" << path << "-" << loaded.config.files().size() << "files,"
+             << loaded.config.reparsedFiles().size() << "re-parsed";
+    
+    const HyprConfig *config = &loaded.config;
+    if (!ok) {
+        m_hyprlandFiles.remove(path);
+        config = nullptr;
+    }
+    updateWatchedFiles();
+    return config;
+}
+
+bool ConfigManager::parseHyprlandMonitorsConfig(const QList<HyprConfigValue> &rules)
 {
     m_displayConfig = QJsonObject();
     QJsonArray displaysArray;
     
-    QStringList lines = content.split('\n', Qt::SkipEmptyParts);
-    for (const QString &line : lines) {
-        QString trimmedLine = line.trimmed();
-        if (trimmedLine.startsWith("monitor=")) {
-            QString monitorConfig = trimmedLine.mid(8); // Remove "monitor="
-            
-            // Parse monitor configuration
-            QStringList parts = monitorConfig.split(',');
-            if (parts.size() >= 4) {
-                QJsonObject display;
-                display["name"] = parts[0];
-                
-                // Parse resolution and refresh rate
-                QString resolution = parts[1];
-                int atIndex = resolution.indexOf('@');
-                if (atIndex > 0) {
-                    QString res = resolution.left(atIndex);
-                    QString refresh = resolution.mid(atIndex + 1);
-                    
-                    QStringList resParts = res.split('x');
-                    if (resParts.size() == 2) {
-                        display["width"] = resParts[0].toInt();
-                        display["height"] = resParts[1].toInt();
-                        display["refreshRate"] = refresh.toDouble();
-                    }
-                }
-                
-                // Parse position
-                QString position = parts[2];
-                QStringList posParts = position.split('x');
-                if (posParts.size() == 2) {
-                    display["x"] = posParts[0].toInt();
-                    display["y"] = posParts[1].toInt();
-                }
-                
-                // Parse scale
-                if (parts.size() > 3) {
-                    display["scale"] = parts[3].toDouble();
-                }
-                
-                // Parse additional parameters
-                int vrrMode = 0;
-                bool hdrEnabled = false;
-                double sdrBrightness = 1.0;
-                double sdrSaturation = 1.0;
-                bool tenBit = false;
-                bool wideGamut = false;
-                
-                for (int i = 4; i < parts.size(); ++i) {
-                    QString part = parts[i];
-                    if (part == "cm") {
-                        // Color management enabled - check next part for type
-                        if (i + 1 < parts.size()) {
-                            QString cmType = parts[i + 1];
-                            if (cmType == "hdr") {
-                                hdrEnabled = true;
-                                i++; // Skip the cm type since we consumed it
-                            } else if (cmType == "wide") {
-                                wideGamut = true;
-                                i++; // Skip the cm type since we consumed it
-                            }
-                        }
-                    } else if (part == "bitdepth") {
-                        // Check if the next part is "10" for 10-bit
-                        if (i + 1 < parts.size() && parts[i + 1] == "10") {
-                            tenBit = true;
-                            i++; // Skip the next part since we consumed it
-                        }
-                    } else if (part == "vrr") {
-                        // VRR mode follows
-                        if (i + 1 < parts.size()) {
-                            vrrMode = parts[i + 1].toInt();
-                            i++; // Skip the next part since we consumed it
-                        }
-                    } else if (part == "sdrbrightness") {
-                        // SDR brightness follows
-                        if (i + 1 < parts.size()) {
-                            sdrBrightness = parts[i + 1].toDouble();
-                            i++; // Skip the next part since we consumed it
-                        }
-                    } else if (part == "sdrsaturation") {
-                        // SDR saturation follows
-                        if (i + 1 < parts.size()) {
-                            sdrSaturation = parts[i + 1].toDouble();
-                            i++; // Skip the next part since we consumed it
-                        }
-                    } else if (part == "mirror") {
-                        // Mirror target follows
-                        if (i + 1 < parts.size()) {
-                            display["mirrorOf"] = parts[i + 1];
-                            i++; // Skip the next part since we consumed it
-                        }
-                    } else if (!part.isEmpty() && part != "auto") {
-                        // Assume it's a transform
-                        display["transform"] = part;
-                    }
-                }
-                
-                display["vrrMode"] = vrrMode;
-                display["hdr"] = hdrEnabled;
-                display["sdrBrightness"] = sdrBrightness;
-                display["sdrSaturation"] = sdrSaturation;
-                display["tenBit"] = tenBit;
-                display["wideGamut"] = wideGamut;
-                
-                displaysArray.append(display);
-            }
+    for (const HyprConfigValue &rule : rules) {
+        QJsonObject display = parseMonitorRule(rule.value);
+        if (!display.isEmpty()) {
+            displaysArray.append(display);
         }
     }
     
@@ -655,29 +744,135 @@ bool ConfigManager::parseHyprlandMonitorsConfig(const QString &content)
     return true;
 }
 
-bool ConfigManager::parseHyprlandWorkspacesConfig(const QString &content)
+QJsonObject ConfigManager::parseMonitorRule(const QString &rule)
+{
+    // Parse monitor configuration
+    QStringList parts = rule.split(',');
+    for (QString &part : parts) {
+        part = part.trimmed();
+    }
+    if (parts.size() < 4) {
+        return QJsonObject();
+    }
+    
+    QJsonObject display;
+    display["name"] = parts[0];
+    
+    // Parse resolution and refresh rate
+    QString resolution = parts[1];
+    int atIndex = resolution.indexOf('@');
+    if (atIndex > 0) {
+        QString res = resolution.left(atIndex);
+        QString refresh = resolution.mid(atIndex + 1);
+        
+        QStringList resParts = res.split('x');
+        if (resParts.size() == 2) {
+            display["width"] = resParts[0].toInt();
+            display["height"] = resParts[1].toInt();
+            display["refreshRate"] = refresh.toDouble();
+        }
+    }
+    
+    // Parse position
+    QString position = parts[2];
+    QStringList posParts = position.split('x');
+    if (posParts.size() == 2) {
+        display["x"] = posParts[0].toInt();
+        display["y"] = posParts[1].toInt();
+    }
+    
+    // Parse scale
+    if (parts.size() > 3) {
+        display["scale"] = parts[3].toDouble();
+    }
+    
+    // Parse additional parameters
+    int vrrMode = 0;
+    bool hdrEnabled = false;
+    double sdrBrightness = 1.0;
+    double sdrSaturation = 1.0;
+    bool tenBit = false;
+    bool wideGamut = false;
+    
+    for (int i = 4; i < parts.size(); ++i) {
+        QString part = parts[i];
+        if (part == "cm") {
+            // Color management enabled - check next part for type
+            if (i + 1 < parts.size()) {
+                QString cmType = parts[i + 1];
+                if (cmType == "hdr") {
+                    hdrEnabled = true;
+                    i++; // Skip the cm type since we consumed it
+                } else if (cmType == "wide") {
+                    wideGamut = true;
+                    i++; // Skip the cm type since we consumed it
+                }
+            }
+        } else if (part == "bitdepth") {
+            // Check if the next part is "10" for 10-bit
+            if (i + 1 < parts.size() && parts[i + 1] == "10") {
+                tenBit = true;
+                i++; // Skip the next part since we consumed it
+            }
+        } else if (part == "vrr") {
+            // VRR mode follows
+            if (i + 1 < parts.size()) {
+                vrrMode = parts[i + 1].toInt();
+                i++; // Skip the next part since we consumed it
+            }
+        } else if (part == "sdrbrightness") {
+            // SDR brightness follows
+            if (i + 1 < parts.size()) {
+                sdrBrightness = parts[i + 1].toDouble();
+                i++; // Skip the next part since we consumed it
+            }
+        } else if (part == "sdrsaturation") {
+            // SDR saturation follows
+            if (i + 1 < parts.size()) {
+                sdrSaturation = parts[i + 1].toDouble();
+                i++; // Skip the next part since we consumed it
+            }
+        } else if (part == "mirror") {
+            // Mirror target follows
+            if (i + 1 < parts.size()) {
+                display["mirrorOf"] = parts[i + 1];
+                i++; // Skip the next part since we consumed it
+            }
+        } else if (!part.isEmpty() && part != "auto") {
+            // Assume it's a transform
+            display["transform"] = part;
+        }
+    }
+    
+    display["vrrMode"] = vrrMode;
+    display["hdr"] = hdrEnabled;
+    display["sdrBrightness"] = sdrBrightness;
+    display["sdrSaturation"] = sdrSaturation;
+    display["tenBit"] = tenBit;
+    display["wideGamut"] = wideGamut;
+    return display;
+}
+
+bool ConfigManager::parseHyprlandWorkspacesConfig(const QList<HyprConfigValue> &rules)
 {
     m_workspaceConfig = QJsonObject();
     QJsonArray workspacesArray;
     
-    QStringList lines = content.split('\n', Qt::SkipEmptyParts);
-    for (const QString &line : lines) {
-        QString trimmedLine = line.trimmed();
-        if (trimmedLine.startsWith("workspace=")) {
-            QString workspaceConfig = trimmedLine.mid(10); // Remove "workspace="
+    for (const HyprConfigValue &rule : rules) {
+        // Parse workspace configuration
+        QStringList parts = rule.value.split(',');
+        for (QString &part : parts) {
+            part = part.trimmed();
+        }
+        if (parts.size() >= 2) {
+            QJsonObject workspace;
+            workspace["name"] = parts[0];
             
-            // Parse workspace configuration
-            QStringList parts = workspaceConfig.split(',');
-            if (parts.size() >= 2) {
-                QJsonObject workspace;
-                workspace["name"] = parts[0];
-                
-                if (parts[1].startsWith("monitor:")) {
-                    workspace["monitor"] = parts[1].mid(8); // Remove "monitor:"
-                }
-                
-                workspacesArray.append(workspace);
+            if (parts[1].startsWith("monitor:")) {
+                workspace["monitor"] = parts[1].mid(8); // Remove "monitor:"
             }
+            
+            workspacesArray.append(workspace);
         }
     }
     
@@ -690,67 +885,85 @@ QString ConfigManager::generateHyprlandMonitorsConfig(const QJsonObject &config)
     QString content;
     QJsonArray displays = config["displays"].toArray();
     for (const QJsonValue &value : displays) {
-        QJsonObject display = value.toObject();
-        QString name = display["name"].toString();
-        int width = display["width"].toInt();
-        int height = display["height"].toInt();
-        double refresh = display["refreshRate"].toDouble();
-        int x = display["x"].toInt();
-        int y = display["y"].toInt();
-        double scale = display["scale"].toDouble(1.0);
-        QString line = QString("monitor=%1,%2x%3@%4,%5x%6,%7")
-            .arg(name)
-            .arg(width)
-            .arg(height)
-            .arg(refresh, 0, 'f', 2)
-            .arg(x)
-            .arg(y)
-            .arg(scale, 0, 'f', 2);
-
-        // Hyprland HDR/CM options
-        bool hdrEnabled = display.contains("hdr") && display["hdr"].toBool();
-        bool tenBit = display.contains("tenBit") && display["tenBit"].toBool();
-        bool wideGamut = display.contains("wideGamut") && display["wideGamut"].toBool();
-        
-        qDebug() << "Generating config for" << name << "HDR:" << hdrEnabled << "10-bit:" << tenBit << "Wide gamut:" << wideGamut;
-        
-        // Build additional options list
-        QStringList additionalOptions;
-        
-        // Handle HDR and wide gamut options (they go together with cm)
-        if (hdrEnabled || wideGamut) {
-            additionalOptions << "cm";
-            if (hdrEnabled) {
-                additionalOptions << "hdr";
-                double sdrb = display.contains("sdrBrightness") ? display["sdrBrightness"].toDouble(1.0) : 1.0;
-                double sdrs = display.contains("sdrSaturation") ? display["sdrSaturation"].toDouble(1.0) : 1.0;
-                additionalOptions << QString("sdrbrightness,%1").arg(sdrb, 0, 'f', 2) << QString("sdrsaturation,%1").arg(sdrs, 0, 'f', 2);
-            } else if (wideGamut) {
-                additionalOptions << "wide";
-            }
-        }
-        
-        if (tenBit) {
-            additionalOptions << "bitdepth,10";
-        }
-        
-        // Hyprland VRR option
-        if (display.contains("vrrMode")) {
-            int vrr = display["vrrMode"].toInt();
-            if (vrr != 0) {
-                additionalOptions << QString("vrr,%1").arg(vrr);
-            }
+        content += "monitor=" + generateMonitorRule(value.toObject()) + "\n";
+    }
+    return content;
+}
+
+QString ConfigManager::generateMonitorRule(const QJsonObject &display)
+{
+    QString name = display["name"].toString();
+    int width = display["width"].toInt();
+    int height = display["height"].toInt();
+    double refresh = display["refreshRate"].toDouble();
+    int x = display["x"].toInt();
+    int y = display["y"].toInt();
+    double scale = display["scale"].toDouble(1.0);
+    QString rule = QString("%1,%2x%3@%4,%5x%6,%7")
+        .arg(name)
+        .arg(width)
+        .arg(height)
+        .arg(refresh, 0, 'f', 2)
+        .arg(x)
+        .arg(y)
+        .arg(scale, 0, 'f', 2);
+
+    // Hyprland HDR/CM options
+    bool hdrEnabled = display.contains("hdr") && display["hdr"].toBool();
+    bool tenBit = display.contains("tenBit") && display["tenBit"].toBool();
+    bool wideGamut = display.contains("wideGamut") && display["wideGamut"].toBool();
+    
+    qDebug() << "Generating config for" << name << "HDR:" << hdrEnabled << "10-bit:" << tenBit << "Wide gamut:" << wideGamut;
+    
+    // Build additional options list
+    QStringList additionalOptions;
+    
+    // Handle HDR and wide gamut options (they go together with cm)
+    if (hdrEnabled || wideGamut) {
+        additionalOptions << "cm";
+        if (hdrEnabled) {
+            additionalOptions << "hdr";
+            double sdrb = display.contains("sdrBrightness") ? display["sdrBrightness"].toDouble(1.0) : 1.0;
+            double sdrs = display.contains("sdrSaturation") ? display["sdrSaturation"].toDouble(1.0) : 1.0;
+            additionalOptions << QString("sdrbrightness,%1").arg(sdrb, 0, 'f', 2) << QString("sdrsaturation,%1").arg(sdrs, 0, 'f', 2);
+        } else if (wideGamut) {
+            additionalOptions << "wide";
         }
-        
-        // Add all additional options to the line
-        if (!additionalOptions.isEmpty()) {
-            line += "," + additionalOptions.join(",");
+    }
+    
+    if (tenBit) {
+        additionalOptions << "bitdepth,10";
+    }
+    
+    // Hyprland VRR option
+    if (display.contains("vrrMode")) {
+        int vrr = display["vrrMode"].toInt();
+        if (vrr != 0) {
+            additionalOptions << QString("vrr,%1").arg(vrr);
         }
+    }
+    
+    // Add all additional options to the line
+    if (!additionalOptions.isEmpty()) {
+        rule += "," + additionalOptions.join(",");
+    }
+    
+    return rule;
+}
 
-        qDebug() << "Generated line:" << line;
-        content += line + "\n";
+QString ConfigManager::mergeMonitorRule(const QString &existing, const QString &generated)
+{
+    // Options after the first four fields are name,value pairs. Keep the
+    // ones this tool does not manage (transform, mirror, ...) as written.
+    static const QStringList managedOptions = {"cm", "sdrbrightness", "sdrsaturation", "bitdepth", "vrr"};
+    QStringList parts = existing.split(',');
+    QStringList kept;
+    for (int i = 4; i < parts.size(); i += 2) {
+        if (!managedOptions.contains(parts[i].trimmed())) {
+            kept << parts.mid(i, 2);
+        }
     }
-    return content;
+    return kept.isEmpty() ? generated : generated + "," + kept.join(",");
 }
 
 QString ConfigManager::generateHyprlandWorkspacesConfig(const QJsonObject &config)
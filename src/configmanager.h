@@ -9,6 +9,7 @@
 #include <QJsonValue>
 #include <QJsonParseError>
 #include <QFile>
+#include <QFileSystemWatcher>
 #include <QDir>
 #include <QStandardPaths>
 #include <QDebug>
@@ -16,11 +17,17 @@
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
 #include <QStringList>
+#include <QSet>
+#include <QTimer>
 #include <QVariant>
 #include <QVariantMap>
 #include <QVariantList>
+#include <QScopedPointer>
+#include <QDateTime>
 
 #include "displaymanager.h"
+#include "hyprconfig.h"
+#include "backupstore.h"
 
 class ConfigManager : public QObject
 {
@@ -34,6 +41,12 @@ public:
     bool loadApplicationSettings();
     bool saveApplicationSettings();
     void resetApplicationSettings();
+    // How long to wait for an editor's save burst to settle before reloading
+    int reloadDelay() const { return m_reloadDelayMs; }
+    void setReloadDelay(int ms);
+    // Format of backups, profiles and other saved state; readers take either
+    SnapshotFormat::Format snapshotFormat() const { return m_snapshotFormat; }
+    void setSnapshotFormat(SnapshotFormat::Format format);
     
     // Hyprland configuration
     bool loadHyprlandConfig();
@@ -55,10 +68,12 @@ public:
     QJsonObject getWorkspaceConfig() const;
     void setWorkspaceConfig(const QJsonObject &config);
     
-    // Backup and restore
+    // Backup and restore. Without a path createBackup() adds to the backup
+    // store and the others take the ids from getBackups(); a path names a
+    // standalone export file instead.
     bool createBackup(const QString &path);
     bool restoreBackup(const QString &path);
-    QStringList getBackups() const;
+    QStringList getBackups() const;  // newest first
     bool deleteBackup(const QString &path);
     
     // Validation
@@ -87,12 +102,18 @@ signals:
     void backupCreated(const QString &path);
     void backupRestored(const QString &path);
     void backupDeleted(const QString &path);
+    void hyprlandFileChanged(const QString &path);  // edited outside HyprDisplays
+    // Emitted after an external edit has been re-parsed into the display or
+    // workspace config; not for loads and sets made through this class
+    void hyprlandMonitorsReloaded();
+    void hyprlandWorkspacesReloaded();
     void error(const QString &message);
     void success(const QString &message);
 
 private slots:
     void onFileChanged(const QString &path);
     void onDirectoryChanged(const QString &path);
+    void reloadChangedFiles();
 
 private:
     // File operations
@@ -102,9 +123,23 @@ private:
     bool writeTextFile(const QString &path, const QString &content);
     
     // Configuration parsing
-    bool parseHyprlandMonitorsConfig(const QString &content);
-    bool parseHyprlandWorkspacesConfig(const QString &content);
+    bool parseHyprlandMonitorsConfig(const QList<HyprConfigValue> &rules);
+    bool parseHyprlandWorkspacesConfig(const QList<HyprConfigValue> &rules);
+    enum HyprlandFileKind { HyprlandFile, MonitorsFile, WorkspacesFile };
+    struct LoadedHyprlandFile {
+        HyprConfig config;
+        HyprlandFileKind kind = HyprlandFile;
+    };
+    const HyprConfig *loadHyprlandFile(const QString &path, HyprlandFileKind kind);
+    
+    // File watching
+    void updateWatchedFiles();
+    void rememberOwnWrite(const QString &path);
+    bool isOwnWrite(const QString &path);
     QString generateHyprlandMonitorsConfig(const QJsonObject &config);
+    static QJsonObject parseMonitorRule(const QString &rule);
+    static QString generateMonitorRule(const QJsonObject &display);
+    static QString mergeMonitorRule(const QString &existing, const QString &generated);
     QString generateHyprlandWorkspacesConfig(const QJsonObject &config);
     
     // Path management
@@ -141,11 +176,13 @@ private:
     QJsonObject m_displayConfig;
     QJsonObject m_workspaceConfig;
     QJsonObject m_hyprlandConfig;
+    QHash<QString, LoadedHyprlandFile> m_hyprlandFiles;  // by root path
     
     // Paths
     QString m_configPath;
     QString m_settingsPath;
     QString m_backupPath;
+    QString m_hyprlandConfPath;
     QString m_monitorsPath;
     QString m_workspacesPath;
     
@@ -155,6 +192,7 @@ private:
     bool m_autoSave;
     bool m_autoBackup;
     int m_maxBackups;
+    SnapshotFormat::Format m_snapshotFormat;
     
     // Validation
     QStringList m_validationErrors;
@@ -163,10 +201,18 @@ private:
     // File watchers
     QList<QString> m_watchedFiles;
     QList<QString> m_watchedDirectories;
+    QFileSystemWatcher *m_watcher;
+    QTimer *m_reloadTimer;
+    int m_reloadDelayMs;
+    QSet<QString> m_pendingChanges;
+    struct OwnWrite {
+        qint64 size = -1;
+        QDateTime modified;
+    };
+    QHash<QString, OwnWrite> m_ownWrites;  // path -> the file as we last left it
     
     // Backup management
-    QStringList m_backupFiles;
-    QRegularExpression m_backupFileRegex;
+    QScopedPointer<BackupStore> m_backupStore;
     
     // Import/Export
     bool m_enableImportExport;
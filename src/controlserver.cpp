@@ -0,0 +1,477 @@
+#include "controlserver.h"
+#include "applyplanner.h"
+#include "hotplugprofileapplier.h"
+#include "layoutprofilestore.h"
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QStandardPaths>
+#include <algorithm>
+
+namespace {
+
+// A line longer than this is not a request; the client is dropped
+const qsizetype MaxLineBytes = 1 << 20;
+
+QByteArray toCompactJson(const QJsonValue &value)
+{
+    if (value.isObject()) {
+        return QJsonDocument(value.toObject()).toJson(QJsonDocument::Compact);
+    }
+    if (value.isArray()) {
+        return QJsonDocument(value.toArray()).toJson(QJsonDocument::Compact);
+    }
+    if (value.isDouble() && value.toDouble() == double(value.toInteger())) {
+        return QByteArray::number(value.toInteger());
+    }
+    // Scalars only serialize inside a container: "[x]" -> "x"
+    const QByteArray wrapped = QJsonDocument(QJsonArray{value}).toJson(QJsonDocument::Compact);
+    return wrapped.mid(1, wrapped.size() - 2);
+}
+
+}
+
+ControlServer::ControlServer(DisplayManager *displayManager, HotplugProfileApplier *applier, QObject *parent)
+    : QObject(parent)
+    , m_displayManager(displayManager)
+    , m_applier(applier)
+    , m_server(new QLocalServer(this))
+    , m_requests(0)
+    , m_layoutProfiles(-1)
+    , m_applyInFlight(false)
+    , m_applyStarting(false)
+    , m_applyClient(nullptr)
+    , m_applyDisplayId(0)
+{
+    connect(m_server, &QLocalServer::newConnection, this, &ControlServer::onNewConnection);
+    // The working copy changes with every edit in the window; what scripts see
+    // changes with refreshes and applies
+    connect(m_displayManager, &DisplayManager::displaysChanged, this, &ControlServer::onDisplaysChanged);
+    connect(m_displayManager, &DisplayManager::refreshFinished, this, &ControlServer::onDisplaysChanged);
+    connect(m_displayManager, &DisplayManager::applyFinished, this, &ControlServer::onApplyFinished);
+    if (m_applier) {
+        connect(m_applier, &HotplugProfileApplier::profileApplied, this, &ControlServer::onProfileApplied);
+    }
+}
+
+ControlServer::~ControlServer()
+{
+    m_server->close();
+    qDeleteAll(m_clients);
+}
+
+QString ControlServer::defaultSocketPath()
+{
+    QString runtimeDir = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+    if (runtimeDir.isEmpty()) {
+        runtimeDir = QDir::tempPath();
+    }
+    return runtimeDir + "/hyprdisplays/control.sock";
+}
+
+bool ControlServer::listen(const QString &path, QString *error)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QLocalSocket probe;
+    probe.connectToServer(path);
+    if (probe.waitForConnected(200)) {
+        if (error) *error = QString("Another process is already listening on %1").arg(path);
+        return false;
+    }
+    QLocalServer::removeServer(path);
+
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    if (!m_server->listen(path)) {
+        if (error) *error = m_server->errorString();
+        return false;
+    }
+    qInfo() << "Control socket listening on" << path;
+    return true;
+}
+
+QString ControlServer::socketPath() const
+{
+    return m_server->fullServerName();
+}
+
+bool ControlServer::isListening() const
+{
+    return m_server->isListening();
+}
+
+bool ControlServer::call(const QString &socketPath, const QString &method, const QJsonObject &params,
+                         QJsonValue &result, QString *error, int timeoutMs)
+{
+    QLocalSocket socket;
+    socket.connectToServer(socketPath);
+    if (!socket.waitForConnected(timeoutMs)) {
+        if (error) *error = socket.errorString();
+        return false;
+    }
+
+    QJsonObject request;
+    request["jsonrpc"] = "2.0";
+    request["id"] = 1;
+    request["method"] = method;
+    if (!params.isEmpty()) {
+        request["params"] = params;
+    }
+    socket.write(QJsonDocument(request).toJson(QJsonDocument::Compact) + '\n');
+
+    QDeadlineTimer deadline(timeoutMs);
+    QByteArray data;
+    while (!data.contains('\n') && socket.waitForReadyRead(int(deadline.remainingTime()))) {
+        data += socket.readAll();
+    }
+    if (!data.contains('\n')) {
+        if (error) *error = QString("No answer on %1").arg(socketPath);
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonObject response = QJsonDocument::fromJson(data.left(data.indexOf('\n')), &parseError).object();
+    if (response.contains("error")) {
+        if (error) *error = response["error"].toObject()["message"].toString();
+        return false;
+    }
+    if (!response.contains("result")) {
+        if (error) *error = parseError.error != QJsonParseError::NoError ? parseError.errorString()
+                                                                         : QString("Malformed answer");
+        return false;
+    }
+    result = response["result"];
+    return true;
+}
+
+void ControlServer::onNewConnection()
+{
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        Client *client = new Client;
+        client->socket = socket;
+        m_clients.insert(socket, client);
+        connect(socket, &QLocalSocket::readyRead, this, [this, client]() { onReadyRead(client); });
+        // Queued: a failed write may report the hang-up while the client's queue is being handled
+        connect(socket, &QLocalSocket::disconnected, this, [this, client]() { onDisconnected(client); },
+                Qt::QueuedConnection);
+    }
+}
+
+void ControlServer::onReadyRead(Client *client)
+{
+    client->queue.append(client->framer.feed(client->socket->readAll()));
+    if (client->framer.pendingSize() > MaxLineBytes) {
+        qWarning() << "Control client sent a line over" << MaxLineBytes << "bytes, disconnecting";
+        client->queue.clear();
+        client->socket->abort();
+        return;
+    }
+    processQueue(client);
+}
+
+void ControlServer::onDisconnected(Client *client)
+{
+    if (!m_clients.contains(client->socket)) {
+        return;
+    }
+    m_clients.remove(client->socket);
+    if (m_applyClient == client) {
+        // The apply goes on; there is just nobody left to answer
+        m_applyClient = nullptr;
+    }
+    client->socket->deleteLater();
+    delete client;
+}
+
+void ControlServer::processQueue(Client *client)
+{
+    while (!client->applying && !client->queue.isEmpty()) {
+        handle(client, client->queue.takeFirst());
+    }
+}
+
+void ControlServer::handle(Client *client, const QByteArray &line)
+{
+    ++m_requests;
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+    if (doc.isNull()) {
+        replyError(client, QJsonValue(QJsonValue::Null), ParseError, parseError.errorString());
+        return;
+    }
+    const QJsonObject request = doc.object();
+    const QJsonValue id = request.value("id");
+    const QString method = request.value("method").toString();
+    const QJsonValue paramsValue = request.value("params");
+    if (!doc.isObject() || method.isEmpty() || !(paramsValue.isUndefined() || paramsValue.isObject())) {
+        replyError(client, id.isUndefined() ? QJsonValue(QJsonValue::Null) : id, InvalidRequest,
+                   "Expected {\"method\": ..., \"params\": {...}}");
+        return;
+    }
+    const QJsonObject params = paramsValue.toObject();
+
+    if (method == QLatin1String("getLayout")) {
+        replyRaw(client, id, layoutResult());
+    } else if (method == QLatin1String("getStatus")) {
+        QJsonObject status = m_statusProvider ? m_statusProvider() : QJsonObject();
+        status["clients"] = m_clients.size();
+        status["requests"] = m_requests;
+        status["applying"] = m_applyInFlight;
+        reply(client, id, status);
+    } else if (method == QLatin1String("subscribe") || method == QLatin1String("unsubscribe")) {
+        client->subscribed = method == QLatin1String("subscribe");
+        reply(client, id, QJsonObject{{"subscribed", client->subscribed}});
+    } else if (method == QLatin1String("dryRun")) {
+        QList<DisplayInfo> displays = liveDisplays();
+        QString fingerprint;
+        QString error;
+        bool ok = true;
+        if (params.contains("profile")) {
+            ok = profileLayout(params, displays, fingerprint, error);
+        } else if (params.contains("name")) {
+            ok = monitorLayout(params, displays, error);
+        }
+        if (!ok) {
+            replyError(client, id, InvalidParams, error);
+            return;
+        }
+        const ApplyPlan plan = ApplyPlanner::plan(liveDisplays(), displays);
+        QJsonObject result;
+        result["commands"] = QJsonArray::fromStringList(plan.commands());
+        result["modesets"] = plan.modesetCount();
+        result["description"] = plan.describe();
+        reply(client, id, result);
+    } else if (method == QLatin1String("applyProfile") || method == QLatin1String("setMonitor")) {
+        // Ours, or one from the window or the hotplug handler
+        if (m_applyInFlight || m_displayManager->isApplying()) {
+            replyError(client, id, Busy, "Another apply is in progress");
+            return;
+        }
+        // Planned against no live monitors, every one would be re-enabled with a full modeset
+        if (!m_displayManager->hyprlandSnapshot()) {
+            replyError(client, id, NotReady, "The monitors have not been read from Hyprland yet");
+            return;
+        }
+        QList<DisplayInfo> displays;
+        QString fingerprint;
+        QString error;
+        const bool ok = method == QLatin1String("applyProfile") ? profileLayout(params, displays, fingerprint, error)
+                                                                : monitorLayout(params, displays, error);
+        if (!ok) {
+            replyError(client, id, InvalidParams, error);
+            return;
+        }
+        startApply(client, id, displays, fingerprint);
+    } else {
+        replyError(client, id, MethodNotFound, QString("Unknown method %1").arg(method));
+    }
+}
+
+void ControlServer::startApply(Client *client, const QJsonValue &id, const QList<DisplayInfo> &displays,
+                               const QString &fingerprint)
+{
+    m_applyInFlight = true;
+    m_applyClient = client;
+    m_applyId = id;
+    m_applyFingerprint = fingerprint;
+    client->applying = true;
+
+    // The window's working copy and its unapplied edits are left alone
+    m_applyStarting = true;
+    const bool started = m_displayManager->applyLayout(displays);
+    m_applyStarting = false;
+    m_applyDisplayId = m_displayManager->lastApplyId();
+    if (!started) {
+        m_applyInFlight = false;
+        m_applyClient = nullptr;
+        client->applying = false;
+        replyError(client, id, ApplyFailed, "No monitors to apply");
+    }
+}
+
+void ControlServer::onApplyFinished(bool ok)
+{
+    onDisplaysChanged();
+    // Applies from the window or the hotplug handler are not ours to answer;
+    // one that finishes inside applyLayout() can only be ours
+    if (!m_applyInFlight || (!m_applyStarting && m_displayManager->finishedApplyId() != m_applyDisplayId)) {
+        return;
+    }
+    m_applyInFlight = false;
+    Client *client = m_applyClient;
+    m_applyClient = nullptr;
+    if (!client) {
+        return;
+    }
+    client->applying = false;
+
+    const HyprlandBatchResult result = m_displayManager->lastApplyResult();
+    if (ok) {
+        QJsonObject answer;
+        answer["applied"] = true;
+        answer["commands"] = QJsonArray::fromStringList(result.commands);
+        if (!m_applyFingerprint.isEmpty()) {
+            answer["profile"] = m_applyFingerprint;
+        }
+        reply(client, m_applyId, answer);
+    } else {
+        replyError(client, m_applyId, ApplyFailed,
+                   result.error.isEmpty() ? QString("Hyprland rejected the monitor rules") : result.error);
+    }
+    // Applies that finish inside applyConfiguration() return to processQueue() anyway
+    if (!m_applyStarting) {
+        processQueue(client);
+    }
+}
+
+void ControlServer::onDisplaysChanged()
+{
+    if (m_displayManager->hyprlandSnapshot() == m_notifiedSnapshot) {
+        return;
+    }
+    m_notifiedSnapshot = m_displayManager->hyprlandSnapshot();
+    const bool anySubscribed = std::any_of(m_clients.cbegin(), m_clients.cend(),
+                                           [](const Client *client) { return client->subscribed; });
+    if (anySubscribed) {
+        notify("layoutChanged", layoutResult());
+    }
+}
+
+void ControlServer::onProfileApplied(const QString &fingerprint, qint64 latencyMs)
+{
+    QJsonObject params;
+    params["profile"] = fingerprint;
+    params["latencyMs"] = latencyMs;
+    notify("profileApplied", QJsonDocument(params).toJson(QJsonDocument::Compact));
+}
+
+bool ControlServer::profileLayout(const QJsonObject &params, QList<DisplayInfo> &displays, QString &fingerprint,
+                                  QString &error) const
+{
+    const QString wanted = params.value("profile").toString();
+    if (wanted.isEmpty()) {
+        error = "\"profile\" must be a fingerprint, a prefix of one, or \"auto\"";
+        return false;
+    }
+    if (!m_applier) {
+        error = "No saved layouts";
+        return false;
+    }
+    m_applier->reloadIfChanged();
+    displays = liveDisplays();
+    const LayoutProfile *profile = m_applier->profiles().resolve(wanted, displays, &error);
+    if (!profile) {
+        return false;
+    }
+    profile->applyTo(displays);
+    fingerprint = profile->fingerprint;
+    return true;
+}
+
+bool ControlServer::monitorLayout(const QJsonObject &params, QList<DisplayInfo> &displays, QString &error) const
+{
+    const QString name = params.value("name").toString();
+    displays = liveDisplays();
+    auto monitor = std::find_if(displays.begin(), displays.end(),
+                                [&](const DisplayInfo &display) { return display.name == name; });
+    if (monitor == displays.end()) {
+        error = name.isEmpty() ? QString("\"name\" is required") : QString("No monitor named %1").arg(name);
+        return false;
+    }
+
+    // Fields not given keep their current values
+    QJsonObject json = monitor->toJson();
+    if (params.contains("resolution")) {
+        json.remove("width");
+        json.remove("height");
+    }
+    for (auto field = params.begin(); field != params.end(); ++field) {
+        json[field.key()] = field.value();
+    }
+    json["name"] = name;
+    *monitor = DisplayInfo::fromJson(json);
+    return true;
+}
+
+QList<DisplayInfo> ControlServer::liveDisplays() const
+{
+    MonitorSnapshotPtr live = m_displayManager->hyprlandSnapshot();
+    return live ? live->displays : QList<DisplayInfo>();
+}
+
+const QByteArray &ControlServer::layoutResult()
+{
+    MonitorSnapshotPtr current = m_displayManager->hyprlandSnapshot();
+    const int profiles = m_applier ? m_applier->profiles().size() : 0;
+    if (!m_layout.isEmpty() && current == m_layoutSnapshot && profiles == m_layoutProfiles) {
+        return m_layout;
+    }
+
+    const QList<DisplayInfo> displays = current ? current->displays : QList<DisplayInfo>();
+    QJsonArray monitors;
+    for (const DisplayInfo &display : displays) {
+        monitors.append(display.toJson());
+    }
+    const QString fingerprint = LayoutProfileStore::fingerprint(displays);
+    QJsonObject layout;
+    layout["monitors"] = monitors;
+    layout["fingerprint"] = fingerprint;
+    layout["hasProfile"] = m_applier && m_applier->profiles().find(fingerprint) != nullptr;
+
+    m_layout = QJsonDocument(layout).toJson(QJsonDocument::Compact);
+    m_layoutSnapshot = current;
+    m_layoutProfiles = profiles;
+    return m_layout;
+}
+
+void ControlServer::reply(Client *client, const QJsonValue &id, const QJsonValue &result)
+{
+    replyRaw(client, id, toCompactJson(result));
+}
+
+void ControlServer::replyRaw(Client *client, const QJsonValue &id, const QByteArray &result)
+{
+    // A request without an id is a notification and gets no answer
+    if (id.isUndefined()) {
+        return;
+    }
+    QByteArray message;
+    message.reserve(result.size() + 48);
+    message += "{\"jsonrpc\":\"2.0\",\"id\":";
+    message += toCompactJson(id);
+    message += ",\"result\":";
+    message += result;
+    message += "}\n";
+    client->socket->write(message);
+}
+
+void ControlServer::replyError(Client *client, const QJsonValue &id, int code, const QString &message)
+{
+    if (id.isUndefined()) {
+        return;
+    }
+    QJsonObject error;
+    error["code"] = code;
+    error["message"] = message;
+    QJsonObject response;
+    response["jsonrpc"] = "2.0";
+    response["id"] = id;
+    response["error"] = error;
+    client->socket->write(QJsonDocument(response).toJson(QJsonDocument::Compact) + '\n');
+}
+
+void ControlServer::notify(const QString &method, const QByteArray &params)
+{
+    QByteArray message = "{\"jsonrpc\":\"2.0\",\"method\":\"" + method.toUtf8() + "\",\"params\":" + params + "}\n";
+    for (Client *client : std::as_const(m_clients)) {
+        if (client->subscribed) {
+            client->socket->write(message);
+        }
+    }
+}
@@ -0,0 +1,127 @@
+#ifndef CONTROLSERVER_H
+#define CONTROLSERVER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <functional>
+
+#include "displaymanager.h"
+#include "hyprlandeventsocket.h"
+
+class HotplugProfileApplier;
+class QLocalServer;
+class QLocalSocket;
+
+// JSON-RPC 2.0 on a local socket, one message per line, for scripts that
+// would otherwise parse hyprctl output. Queries are answered from what
+// DisplayManager last read from or applied to Hyprland, without a request;
+// the window's working copy and its unapplied edits are never seen or
+// touched.
+//
+//   getLayout                         monitors, fingerprint, hasProfile
+//   getStatus                         whatever the host reports, plus counters
+//   applyProfile {profile}            a fingerprint, a prefix of one, or "auto"
+//   setMonitor {name, ...fields}      DisplayInfo JSON fields to change
+//   dryRun {profile} | {name, ...}    the commands either would send
+//   subscribe / unsubscribe           layoutChanged and profileApplied notifications
+//
+// Clients may pipeline: requests are handled in the order they arrive and
+// answered in that order, an apply holding back the requests behind it.
+class ControlServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum ErrorCode {
+        ParseError = -32700,
+        InvalidRequest = -32600,
+        MethodNotFound = -32601,
+        InvalidParams = -32602,
+        Busy = -32000,          // another client's apply is in flight
+        ApplyFailed = -32001,
+        NotReady = -32002,      // the monitors have not been read from Hyprland yet
+    };
+
+    using StatusProvider = std::function<QJsonObject()>;
+
+    ControlServer(DisplayManager *displayManager, HotplugProfileApplier *applier, QObject *parent = nullptr);
+    ~ControlServer();
+
+    // $XDG_RUNTIME_DIR/hyprdisplays/control.sock
+    static QString defaultSocketPath();
+    // Fails when another process answers on path; a socket file nobody
+    // answers on is left over from a process that was killed and is replaced
+    bool listen(const QString &path, QString *error = nullptr);
+    QString socketPath() const;
+    bool isListening() const;
+    void setStatusProvider(StatusProvider provider) { m_statusProvider = std::move(provider); }
+    int clientCount() const { return m_clients.size(); }
+    qint64 requestCount() const { return m_requests; }
+
+    // One request on a fresh connection, for the CLI and the benchmarks.
+    // On an error reply, error holds its message.
+    static bool call(const QString &socketPath, const QString &method, const QJsonObject &params,
+                     QJsonValue &result, QString *error = nullptr, int timeoutMs = 1000);
+
+private slots:
+    void onNewConnection();
+    void onDisplaysChanged();
+    void onApplyFinished(bool ok);
+    void onProfileApplied(const QString &fingerprint, qint64 latencyMs);
+
+private:
+    struct Client {
+        QLocalSocket *socket = nullptr;
+        LineFramer framer;
+        QList<QByteArray> queue;  // complete lines not handled yet
+        bool applying = false;    // answer to the head of the queue comes from onApplyFinished()
+        bool subscribed = false;
+    };
+
+    void onReadyRead(Client *client);
+    void onDisconnected(Client *client);
+    void processQueue(Client *client);
+    void handle(Client *client, const QByteArray &line);
+    // The answer follows once Hyprland acknowledges the batch; the client's
+    // queue waits until then
+    void startApply(Client *client, const QJsonValue &id, const QList<DisplayInfo> &displays, const QString &fingerprint);
+
+    // Target layouts of applyProfile and setMonitor, shared with dryRun
+    bool profileLayout(const QJsonObject &params, QList<DisplayInfo> &displays, QString &fingerprint, QString &error) const;
+    bool monitorLayout(const QJsonObject &params, QList<DisplayInfo> &displays, QString &error) const;
+    QList<DisplayInfo> liveDisplays() const;
+    const QByteArray &layoutResult();
+
+    void reply(Client *client, const QJsonValue &id, const QJsonValue &result);
+    void replyRaw(Client *client, const QJsonValue &id, const QByteArray &result);
+    void replyError(Client *client, const QJsonValue &id, int code, const QString &message);
+    void notify(const QString &method, const QByteArray &params);
+
+    DisplayManager *m_displayManager;
+    HotplugProfileApplier *m_applier;
+    QLocalServer *m_server;
+    QHash<QLocalSocket *, Client *> m_clients;
+    StatusProvider m_statusProvider;
+    qint64 m_requests;
+
+    // getLayout is by far the most frequent call; it is serialized once per snapshot
+    QByteArray m_layout;
+    MonitorSnapshotPtr m_layoutSnapshot;
+    int m_layoutProfiles;
+    MonitorSnapshotPtr m_notifiedSnapshot;  // layoutChanged was last sent for this
+
+    // At most one apply at a time; the client is cleared if it hangs up first
+    bool m_applyInFlight;
+    bool m_applyStarting;  // inside applyConfiguration(), which may finish synchronously
+    Client *m_applyClient;
+    QJsonValue m_applyId;
+    quint64 m_applyDisplayId;  // DisplayManager's id for the apply, to tell its applyFinished() apart
+    QString m_applyFingerprint;
+};
+
+#endif // CONTROLSERVER_H
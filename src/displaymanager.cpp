@@ -1,16 +1,100 @@
 #include "displaymanager.h"
+#include "hyprlandipc.h"
+#include "applyplanner.h"
+#include "ipcexecutor.h"
+#include "monitorstatestore.h"
+#include "monitorjsondecoder.h"
 #include <QProcess>
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QCborStreamReader>
+#include <QCborStreamWriter>
 #include <QFile>
 #include <QTextStream>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
+#include <utility>
 
 // DisplayInfo implementation
+namespace {
+
+const char *const TransformNames[] = {
+    "normal", "90", "180", "270", "flipped", "flipped-90", "flipped-180", "flipped-270"
+};
+
+QString normalizedMirror(const QString &mirror)
+{
+    return mirror == "none" ? QString() : mirror;
+}
+
+// hyprctl, the mode list and monitors.conf all carry refresh rates to 0.01 Hz,
+// so a rate that went through one of them is off by up to 5 mHz
+const int RefreshToleranceMilliHz = 5;
+
+// Scale and SDR values are written and shown with two decimals
+const double SettingTolerance = 0.0051;
+
+bool sameRefresh(double a, double b)
+{
+    return qAbs(ModeTable::toMilliHertz(a) - ModeTable::toMilliHertz(b)) <= RefreshToleranceMilliHz;
+}
+
+bool sameSetting(double a, double b)
+{
+    return qAbs(a - b) < SettingTolerance;
+}
+
+// Focus and the active workspace move without anyone touching the layout
+const DisplayFields RuntimeFields = DisplayField::Primary | DisplayField::Workspace;
+
+// A working copy differs from the live monitor in more than focus and workspace
+bool hasEdits(const DisplayInfo &working, const DisplayInfo &live)
+{
+    return (working.diff(live) & ~RuntimeFields).toInt() != 0;
+}
+
+} // namespace
+
+bool DisplayInfo::setResolution(const QString &resolution)
+{
+    const int sep = resolution.indexOf('x');
+    bool okWidth = false;
+    bool okHeight = false;
+    const int w = QStringView(resolution).left(sep).toInt(&okWidth);
+    const int h = QStringView(resolution).mid(sep + 1).toInt(&okHeight);
+    if (sep <= 0 || !okWidth || !okHeight) {
+        return false;
+    }
+    width = w;
+    height = h;
+    return true;
+}
+
+QString DisplayInfo::transformName(DisplayTransform transform)
+{
+    return QString::fromLatin1(TransformNames[static_cast<int>(transform) & 7]);
+}
+
+DisplayTransform DisplayInfo::parseTransform(const QString &text, bool *ok)
+{
+    // Hyprland reports 0-7; monitors.conf and the UI use names
+    const QString trimmed = text.trimmed();
+    bool isNumber = false;
+    int value = trimmed.toInt(&isNumber);
+    if (!isNumber || value < 0 || value > 7) {
+        value = trimmed.isEmpty() ? 0 : -1;
+        for (int i = 0; i < 8 && value < 0; ++i) {
+            if (trimmed == QLatin1String(TransformNames[i])) value = i;
+        }
+    }
+    if (ok) *ok = value >= 0;
+    return value >= 0 ? static_cast<DisplayTransform>(value) : DisplayTransform::Normal;
+}
+
 QJsonObject DisplayInfo::toJson() const
 {
     QJsonObject json;
@@ -25,24 +109,24 @@ QJsonObject DisplayInfo::toJson() const
     json["x"] = x;
     json["y"] = y;
     json["scale"] = scale;
-    json["enabled"] = enabled;
-    json["primary"] = primary;
-    json["resolution"] = resolution;
-    json["position"] = position;
-    json["transform"] = transform;
+    json["enabled"] = isEnabled();
+    json["primary"] = isPrimary();
+    json["resolution"] = resolution();
+    json["position"] = position();
+    json["transform"] = transformNumber();
     json["mirrorOf"] = mirrorOf;
     json["workspace"] = workspace;
-    json["hdr"] = hdr;
+    json["hdr"] = isHdr();
     json["sdrBrightness"] = sdrBrightness;
     json["sdrSaturation"] = sdrSaturation;
     json["vrrMode"] = vrrMode;
     QJsonArray modesArray;
     for (const QString &mode : availableModes) modesArray.append(mode);
     json["availableModes"] = modesArray;
-    json["vrrCapable"] = vrrCapable;
-    json["hdrCapable"] = hdrCapable;
-    json["tenBit"] = tenBit;
-    json["wideGamut"] = wideGamut;
+    json["vrrCapable"] = isVrrCapable();
+    json["hdrCapable"] = isHdrCapable();
+    json["tenBit"] = isTenBit();
+    json["wideGamut"] = isWideGamut();
     return json;
 }
 
@@ -56,112 +140,146 @@ DisplayInfo DisplayInfo::fromJson(const QJsonObject &json)
     info.serial = json["serial"].toString();
     info.width = json["width"].toInt();
     info.height = json["height"].toInt();
-    info.refreshRate = json["refreshRate"].toInt();
+    if (!json.contains("width") || !json.contains("height")) {
+        info.setResolution(json["resolution"].toString());
+    }
+    info.refreshRate = json["refreshRate"].toDouble();
     info.x = json["x"].toInt();
     info.y = json["y"].toInt();
     info.scale = json["scale"].toDouble();
-    info.enabled = json["enabled"].toBool();
-    info.primary = json["primary"].toBool();
-    info.resolution = json["resolution"].toString();
-    info.position = json["position"].toString();
-    info.transform = json["transform"].toString();
+    info.setEnabled(json["enabled"].toBool());
+    info.setPrimary(json["primary"].toBool());
+    info.transform = parseTransform(json["transform"].toVariant().toString());
     info.mirrorOf = json["mirrorOf"].toString();
     info.workspace = json["workspace"].toString();
-    info.hdr = json["hdr"].toBool();
+    info.setHdr(json["hdr"].toBool());
     info.sdrBrightness = json["sdrBrightness"].toDouble(1.0);
     info.sdrSaturation = json["sdrSaturation"].toDouble(1.0);
     info.vrrMode = json.contains("vrrMode") ? json["vrrMode"].toInt() : 0;
     QJsonArray modesArray = json["availableModes"].toArray();
     for (const QJsonValue &val : modesArray) info.availableModes.append(val.toString());
-    info.vrrCapable = json["vrrCapable"].toBool();
-    info.hdrCapable = json["hdrCapable"].toBool();
-    info.tenBit = json["tenBit"].toBool();
-    info.wideGamut = json["wideGamut"].toBool();
+    info.modeTable = ModeTable::fromModes(info.availableModes);
+    info.setVrrCapable(json["vrrCapable"].toBool());
+    info.setHdrCapable(json["hdrCapable"].toBool());
+    info.setTenBit(json["tenBit"].toBool());
+    info.setWideGamut(json["wideGamut"].toBool());
     return info;
 }
 
+DisplayFields DisplayInfo::diff(const DisplayInfo &other) const
+{
+    const DisplayFlags changedFlags = flags ^ other.flags;
+    DisplayFields fields;
+    if (description != other.description || manufacturer != other.manufacturer
+        || model != other.model || serial != other.serial) {
+        fields |= DisplayField::Identity;
+    }
+    if (width != other.width || height != other.height || !sameRefresh(refreshRate, other.refreshRate)) {
+        fields |= DisplayField::Mode;
+    }
+    if (x != other.x || y != other.y) {
+        fields |= DisplayField::Position;
+    }
+    if (!sameSetting(scale, other.scale)) {
+        fields |= DisplayField::Scale;
+    }
+    if (transform != other.transform) {
+        fields |= DisplayField::Transform;
+    }
+    if (normalizedMirror(mirrorOf) != normalizedMirror(other.mirrorOf)) {
+        fields |= DisplayField::Mirror;
+    }
+    if (changedFlags.testFlag(DisplayFlag::Enabled)) {
+        fields |= DisplayField::Enabled;
+    }
+    if (changedFlags.testFlag(DisplayFlag::Primary)) {
+        fields |= DisplayField::Primary;
+    }
+    if (workspace != other.workspace) {
+        fields |= DisplayField::Workspace;
+    }
+    if (changedFlags.testFlag(DisplayFlag::Hdr) || changedFlags.testFlag(DisplayFlag::TenBit)
+        || changedFlags.testFlag(DisplayFlag::WideGamut)
+        || (isHdr() && (!sameSetting(sdrBrightness, other.sdrBrightness)
+                        || !sameSetting(sdrSaturation, other.sdrSaturation)))) {
+        fields |= DisplayField::ColorManagement;
+    }
+    if (vrrMode != other.vrrMode) {
+        fields |= DisplayField::Vrr;
+    }
+    if (availableModes != other.availableModes
+        || changedFlags.testFlag(DisplayFlag::VrrCapable) || changedFlags.testFlag(DisplayFlag::HdrCapable)) {
+        fields |= DisplayField::Capabilities;
+    }
+    return fields;
+}
+
 // DisplayManager implementation
 DisplayManager::DisplayManager(QObject *parent)
     : QObject(parent)
+    , m_store(new MonitorStateStore(this))
     , m_numWorkspaces(10)
-    , m_hyprctlProcess(nullptr)
-    , m_refreshTimer(nullptr)
     , m_isRefreshing(false)
+    , m_refreshPending(false)
+    , m_refreshRequestId(0)
 {
-    m_hyprctlProcess = new QProcess(this);
-    m_refreshTimer = new QTimer(this);
-    m_refreshTimer->setInterval(5000); // Refresh every 5 seconds
-    
-    connect(m_hyprctlProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, &DisplayManager::onProcessFinished);
-    connect(m_hyprctlProcess, &QProcess::errorOccurred, this, &DisplayManager::onProcessError);
-    connect(m_refreshTimer, &QTimer::timeout, this, &DisplayManager::refreshDisplays);
 }
 
 DisplayManager::~DisplayManager()
 {
-    if (m_hyprctlProcess) {
-        m_hyprctlProcess->kill();
-    }
+}
+
+MonitorSnapshotPtr DisplayManager::snapshot() const
+{
+    return m_store->snapshot();
+}
+
+MonitorStateStore *DisplayManager::stateStore() const
+{
+    return m_store;
 }
 
 QList<DisplayInfo> DisplayManager::getDisplays() const
 {
-    return m_displays;
+    return m_store->snapshot()->displays;
 }
 
 DisplayInfo DisplayManager::getDisplay(const QString &name) const
 {
-    for (const DisplayInfo &display : m_displays) {
-        if (display.name == name) {
-            return display;
-        }
-    }
-    return DisplayInfo();
+    MonitorSnapshotPtr current = m_store->snapshot();
+    const DisplayInfo *display = current->find(name);
+    return display ? *display : DisplayInfo();
+}
+
+void DisplayManager::setDisplays(const QList<DisplayInfo> &displays)
+{
+    m_store->publish(displays);
+    emit displaysChanged();
 }
 
 void DisplayManager::setDisplay(const DisplayInfo &display)
 {
-    for (int i = 0; i < m_displays.size(); ++i) {
-        if (m_displays[i].name == display.name) {
-            m_displays[i] = display;
-            emit displaysChanged();
-            return;
-        }
-    }
-    
-    m_displays.append(display);
+    m_store->update(display);
     emit displaysChanged();
 }
 
 void DisplayManager::updateDisplayInMemory(const DisplayInfo &display)
 {
-    for (int i = 0; i < m_displays.size(); ++i) {
-        if (m_displays[i].name == display.name) {
-            m_displays[i] = display;
-            // Don't emit displaysChanged() to avoid triggering onDisplayChanged
-            return;
-        }
-    }
-    
-    m_displays.append(display);
+    m_store->update(display);
     // Don't emit displaysChanged() to avoid triggering onDisplayChanged
 }
 
 void DisplayManager::removeDisplay(const QString &name)
 {
-    for (int i = 0; i < m_displays.size(); ++i) {
-        if (m_displays[i].name == name) {
-            m_displays.removeAt(i);
-            emit displaysChanged();
-            return;
-        }
+    if (m_store->snapshot()->contains(name)) {
+        m_store->remove(name);
+        emit displaysChanged();
     }
 }
 
 void DisplayManager::clearDisplays()
 {
-    m_displays.clear();
+    m_store->clear();
     emit displaysChanged();
 }
 
@@ -170,88 +288,244 @@ bool DisplayManager::refreshDisplays()
     qDebug() << "DisplayManager::refreshDisplays() called";
     
     if (m_isRefreshing) {
-        qDebug() << "Already refreshing, skipping";
+        // Run once more after the current request so the newest state wins
+        qDebug() << "Already refreshing, queueing another refresh";
+        m_refreshPending = true;
         return false;
     }
     
     m_isRefreshing = true;
-    
-    // Execute hyprctl monitors command (JSON output)
-    qDebug() << "Executing hyprctl monitors command...";
-    QString output = executeHyprctlCommand({"-j", "monitors"});
-    if (output.isEmpty()) {
-        qWarning() << "Failed to get monitor information from Hyprland";
+    m_refreshPending = false;
+    
+    // Execute hyprctl monitors command (JSON output) on the IPC thread. "all"
+    // includes disabled outputs: they are part of the connected set a layout
+    // profile is fingerprinted on, and the window can turn them back on
+    qDebug() << "Requesting hyprctl monitors all...";
+    m_refreshRequestId = IpcExecutor::instance()->hyprctl({"-j", "monitors", "all"}, this,
+        [this](quint64 id, const HyprlandReply &reply) { onMonitorsReply(id, reply); });
+    if (m_refreshRequestId == 0) {
         m_isRefreshing = false;
         emit error("Failed to get monitor information from Hyprland");
+        emit refreshFinished(false);
         return false;
     }
+    return true;
+}
+
+void DisplayManager::onMonitorsReply(quint64 id, const HyprlandReply &reply)
+{
+    if (id != m_refreshRequestId) {
+        return;
+    }
+    m_isRefreshing = false;
     
-    qDebug() << "Got output from hyprctl, length:" << output.length();
-    qDebug() << "Output preview:" << output.left(200) << "...";
-    
-    if (!parseHyprctlOutput(output)) {
-        qWarning() << "Failed to parse monitor information";
-        m_isRefreshing = false;
-        emit error("Failed to parse monitor information");
-        return false;
+    bool ok = false;
+    if (!reply.ok) {
+        qWarning() << "Failed to get monitor information from Hyprland:" << reply.error;
+        emit error("Failed to get monitor information from Hyprland");
+    } else if (reply.data == m_lastMonitorsReply) {
+        // Byte-identical to the last answer, nothing can have changed
+        qDebug() << "hyprctl monitors answered in" << reply.elapsedUs << "us, unchanged";
+        ok = true;
+    } else {
+        qDebug() << "hyprctl monitors answered in" << reply.elapsedUs << "us"
+                 << (reply.viaSocket ? "(socket)" : "(process)") << "length:" << reply.data.size();
+        
+        QList<DisplayInfo> fresh;
+        if (!parseHyprctlOutput(reply.data, fresh)) {
+            qWarning() << "Failed to parse monitor information";
+            emit error("Failed to parse monitor information");
+        } else {
+            ok = true;
+            m_lastMonitorsReply = reply.data;
+            MonitorChangeSet changes = reconcile(fresh);
+            qDebug() << "Reconciled monitors, count:" << fresh.size() << "version:" << m_store->version()
+                     << "added:" << changes.added << "removed:" << changes.removed
+                     << "changed:" << changes.changed.keys();
+            if (!changes.isEmpty()) {
+                emit displaysChanged();
+                emit success("Displays refreshed successfully");
+            }
+        }
     }
     
-    qDebug() << "Successfully parsed monitors, count:" << m_displays.size();
-    m_isRefreshing = false;
-    emit displaysChanged();
-    emit success("Displays refreshed successfully");
-    return true;
+    emit refreshFinished(ok);
+    
+    if (m_refreshPending) {
+        refreshDisplays();
+    }
 }
 
 bool DisplayManager::applyConfiguration()
 {
-    if (m_displays.isEmpty()) {
+    return applySnapshot(m_store->snapshot());
+}
+
+bool DisplayManager::applyLayout(const QList<DisplayInfo> &displays)
+{
+    return applySnapshot(MonitorSnapshot::create(displays, m_hyprlandSnapshot ? m_hyprlandSnapshot->version + 1 : 1));
+}
+
+bool DisplayManager::applySnapshot(MonitorSnapshotPtr desired)
+{
+    if (desired->isEmpty()) {
         emit error("No displays to configure");
         return false;
     }
+    const quint64 applyId = ++m_applySequence;
+    
+    QElapsedTimer planTimer;
+    planTimer.start();
+    QList<DisplayInfo> live = m_hyprlandSnapshot ? m_hyprlandSnapshot->displays : QList<DisplayInfo>();
+    ApplyPlan plan = ApplyPlanner::plan(live, desired->displays);
+    qint64 planUs = planTimer.nsecsElapsed() / 1000;
+    
+    if (plan.isEmpty()) {
+        qInfo() << "Apply plan is empty, monitors already match the configuration";
+        m_lastApplyResult = HyprlandBatchResult();
+        m_lastApplyResult.ok = true;
+        m_finishedApplyId = applyId;
+        emit success("Configuration already applied, nothing to change");
+        emit applyFinished(true);
+        return true;
+    }
     
-    bool success = true;
-    QStringList commands;
-    
-    for (const DisplayInfo &display : m_displays) {
-        if (!display.enabled) {
-            continue;
+    QStringList commands = plan.commands();
+    qInfo().noquote() << plan.describe();
+    
+    // Send the whole layout in one request so Hyprland reconfigures once
+    int modesets = plan.modesetCount();
+    ++m_appliesInFlight;
+    IpcExecutor::instance()->batch(commands, this,
+        [this, desired, applyId, modesets, planUs](quint64, const HyprlandBatchResult &result) {
+        --m_appliesInFlight;
+        m_finishedApplyId = applyId;
+        m_lastApplyResult = result;
+        qInfo() << "Applied" << result.commands.size() << "of" << desired->size() << "monitor rules in 1"
+                << (result.viaSocket ? "socket request" : "hyprctl --batch call")
+                << "in" << result.elapsedUs << "us"
+                << "(planned in" << planUs << "us," << modesets << "modesets)";
+        
+        if (!result.ok) {
+            emit error(QString("Failed to apply configuration: %1").arg(result.error));
+            emit applyFinished(false);
+            return;
         }
         
-        QString command = buildMonitorCommand(display);
-        if (!command.isEmpty()) {
-            commands.append(command);
+        bool success = true;
+        for (int i = 0; i < result.commands.size(); ++i) {
+            if (!result.commandSucceeded(i)) {
+                success = false;
+                emit error(QString("Failed to apply command: %1 (%2)")
+                           .arg(result.commands[i], result.replies.value(i).trimmed()));
+            }
         }
-    }
+        
+        if (success) {
+            // Hyprland now runs what we sent, so the next plan starts from here
+            MonitorSnapshotPtr previous = std::exchange(m_hyprlandSnapshot, desired);
+            m_lastMonitorsReply.clear();
+            if (desired != m_store->snapshot()) {
+                followAppliedLayout(previous, desired);
+            }
+            emit this->success(QString("Configuration applied successfully (%1 monitors, %2 modesets, %3 ms)")
+                               .arg(result.commands.size())
+                               .arg(modesets)
+                               .arg(result.elapsedUs / 1000.0, 0, 'f', 1));
+        }
+        emit applyFinished(success);
+    });
     
-    // Apply each command
-    for (const QString &command : commands) {
-        if (!executeHyprctlCommandAsync({"dispatch", "keyword", command})) {
-            success = false;
-            emit error(QString("Failed to apply command: %1").arg(command));
+    return true;
+}
+
+void DisplayManager::followAppliedLayout(MonitorSnapshotPtr previous, MonitorSnapshotPtr applied)
+{
+    // A layout applied from elsewhere replaces the working copy of monitors
+    // nobody has edited; unapplied edits stay
+    QList<DisplayInfo> working = m_store->snapshot()->displays;
+    for (DisplayInfo &display : working) {
+        const DisplayInfo *was = previous ? previous->find(display.name) : nullptr;
+        const DisplayInfo *now = applied->find(display.name);
+        if (was && now && !hasEdits(display, *was)) {
+            display = *now;
         }
     }
-    
-    if (success) {
-        emit this->success(QString("Configuration applied successfully"));
+    const MonitorChangeSet changes = m_store->publish(working);
+    if (changes.isEmpty()) {
+        return;
     }
-    
-    return success;
+    for (auto it = changes.changed.cbegin(); it != changes.changed.cend(); ++it) {
+        emit displayFieldsChanged(it.key(), it.value());
+    }
+    emit displaysChanged();
 }
 
-bool DisplayManager::saveConfiguration(const QString &path)
+ApplyPlan DisplayManager::planConfiguration() const
 {
-    QJsonObject config;
-    QJsonArray displaysArray;
-    
-    for (const DisplayInfo &display : m_displays) {
-        displaysArray.append(display.toJson());
+    QList<DisplayInfo> live = m_hyprlandSnapshot ? m_hyprlandSnapshot->displays : QList<DisplayInfo>();
+    return ApplyPlanner::plan(live, m_store->snapshot()->displays);
+}
+
+QString DisplayManager::dryRunConfiguration() const
+{
+    return planConfiguration().describe();
+}
+
+DisplayInfo DisplayManager::mergeWithConfig(const DisplayInfo &live, const QJsonObject &config)
+{
+    DisplayInfo merged = live;
+    merged.vrrMode = config["vrrMode"].toInt(0);
+    merged.setHdr(config["hdr"].toBool(false));
+    merged.sdrBrightness = config["sdrBrightness"].toDouble(1.0);
+    merged.sdrSaturation = config["sdrSaturation"].toDouble(1.0);
+    merged.scale = config["scale"].toDouble(1.0);
+    merged.setTenBit(config["tenBit"].toBool(false));
+    merged.setWideGamut(config["wideGamut"].toBool(false));
+    // Update resolution and refresh rate if they differ
+    if (config.contains("width") && config.contains("height")) {
+        merged.width = config["width"].toInt();
+        merged.height = config["height"].toInt();
+    }
+    if (config.contains("refreshRate")) {
+        merged.refreshRate = config["refreshRate"].toDouble();
+    }
+    // "auto" positions leave x and y out; the compositor's placement stands
+    if (config.contains("x") && config.contains("y")) {
+        merged.x = config["x"].toInt();
+        merged.y = config["y"].toInt();
+    }
+    // A rule without them means an upright, unmirrored output
+    merged.transform = DisplayInfo::parseTransform(config["transform"].toVariant().toString());
+    merged.mirrorOf = config["mirrorOf"].toString();
+    return merged;
+}
+
+bool DisplayManager::saveConfiguration(const QString &path, SnapshotFormat::Format format)
+{
+    const QList<DisplayInfo> &current = m_store->snapshot()->displays;
+    QByteArray data;
+    if (format == SnapshotFormat::Cbor) {
+        QCborStreamWriter writer(&data);
+        SnapshotFormat::beginDocument(writer, "displays");
+        writer.append("numWorkspaces");
+        writer.append(qint64(m_numWorkspaces));
+        writer.append("displays");
+        SnapshotFormat::writeDisplays(writer, current);
+        writer.endMap();
+    } else {
+        QJsonObject config;
+        QJsonArray displaysArray;
+        
+        for (const DisplayInfo &display : current) {
+            displaysArray.append(display.toJson());
+        }
+        
+        config["displays"] = displaysArray;
+        config["numWorkspaces"] = m_numWorkspaces;
+        data = QJsonDocument(config).toJson();
     }
     
-    config["displays"] = displaysArray;
-    config["numWorkspaces"] = m_numWorkspaces;
-    
-    QJsonDocument doc(config);
     QFile file(path);
     
     if (!file.open(QIODevice::WriteOnly)) {
@@ -259,7 +533,7 @@ bool DisplayManager::saveConfiguration(const QString &path)
         return false;
     }
     
-    file.write(doc.toJson());
+    file.write(data);
     file.close();
     
     emit success("Configuration saved successfully");
@@ -274,24 +548,50 @@ bool DisplayManager::loadConfiguration(const QString &path)
         return false;
     }
     
-    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    const QByteArray data = file.readAll();
     file.close();
     
-    if (doc.isNull()) {
-        emit error("Invalid JSON configuration file");
-        return false;
-    }
-    
-    QJsonObject config = doc.object();
-    QJsonArray displaysArray = config["displays"].toArray();
-    
-    m_displays.clear();
-    for (const QJsonValue &value : displaysArray) {
-        DisplayInfo display = DisplayInfo::fromJson(value.toObject());
-        m_displays.append(display);
+    QList<DisplayInfo> displays;
+    int numWorkspaces = 10;
+    if (SnapshotFormat::isCbor(data)) {
+        QCborStreamReader reader(data);
+        QString readError;
+        bool ok = SnapshotFormat::enterDocument(reader, &readError);
+        while (ok && reader.lastError() == QCborError::NoError && reader.hasNext()) {
+            const QString key = SnapshotFormat::readString(reader);
+            if (key == "displays") {
+                ok = SnapshotFormat::readDisplays(reader, displays);
+            } else if (key == "numWorkspaces") {
+                numWorkspaces = int(SnapshotFormat::readInteger(reader, 10));
+            } else {
+                reader.next();
+            }
+        }
+        if (!ok || reader.lastError() != QCborError::NoError) {
+            emit error(QString("Invalid configuration snapshot: %1")
+                       .arg(readError.isEmpty() ? reader.lastError().toString() : readError));
+            return false;
+        }
+    } else {
+        QJsonDocument doc = QJsonDocument::fromJson(data);
+        
+        if (doc.isNull()) {
+            emit error("Invalid JSON configuration file");
+            return false;
+        }
+        
+        QJsonObject config = doc.object();
+        QJsonArray displaysArray = config["displays"].toArray();
+        
+        displays.reserve(displaysArray.size());
+        for (const QJsonValue &value : displaysArray) {
+            displays.append(DisplayInfo::fromJson(value.toObject()));
+        }
+        numWorkspaces = config["numWorkspaces"].toInt(10);
     }
+    m_store->publish(displays);
     
-    m_numWorkspaces = config["numWorkspaces"].toInt(10);
+    m_numWorkspaces = numWorkspaces;
     
     emit displaysChanged();
     emit success("Configuration loaded successfully");
@@ -312,7 +612,7 @@ void DisplayManager::setConfiguration(const QJsonObject &config)
 QStringList DisplayManager::getDisplayNames() const
 {
     QStringList names;
-    for (const DisplayInfo &display : m_displays) {
+    for (const DisplayInfo &display : m_store->snapshot()->displays) {
         names.append(display.name);
     }
     return names;
@@ -349,127 +649,118 @@ void DisplayManager::onConfigurationChanged()
     emit configurationChanged();
 }
 
-void DisplayManager::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+HyprlandBatchResult DisplayManager::lastApplyResult() const
 {
-    if (exitCode != 0) {
-        emit error(QString("Process finished with exit code: %1").arg(exitCode));
-    }
+    return m_lastApplyResult;
 }
 
-void DisplayManager::onProcessError(QProcess::ProcessError error)
+MonitorChangeSet DisplayManager::reconcile(const QList<DisplayInfo> &fresh)
 {
-    QString errorMsg;
-    switch (error) {
-        case QProcess::FailedToStart:
-            errorMsg = "Failed to start hyprctl process";
-            break;
-        case QProcess::Crashed:
-            errorMsg = "hyprctl process crashed";
-            break;
-        case QProcess::Timedout:
-            errorMsg = "hyprctl process timed out";
-            break;
-        case QProcess::WriteError:
-            errorMsg = "Write error to hyprctl process";
-            break;
-        case QProcess::ReadError:
-            errorMsg = "Read error from hyprctl process";
-            break;
-        default:
-            errorMsg = "Unknown process error";
-            break;
+    MonitorSnapshotPtr working = m_store->snapshot();
+    MonitorSnapshotPtr live = m_hyprlandSnapshot;
+    
+    // Monitors whose rules Hyprland reports unchanged keep their working copy,
+    // so edits that have not been applied yet survive a refresh; focus and
+    // workspace are copied onto it rather than replacing it
+    QList<DisplayInfo> next;
+    next.reserve(fresh.size());
+    bool liveChanged = !live || live->size() != fresh.size();
+    for (const DisplayInfo &display : fresh) {
+        const DisplayInfo *before = live ? live->find(display.name) : nullptr;
+        const DisplayInfo *edited = working->find(display.name);
+        if (before && edited && !hasEdits(display, *before)) {
+            DisplayInfo kept = *edited;
+            kept.setPrimary(display.isPrimary());
+            kept.workspace = display.workspace;
+            next.append(kept);
+            if (display.diff(*before).toInt() != 0) {
+                liveChanged = true;
+            }
+        } else {
+            liveChanged = true;
+            next.append(display);
+        }
+    }
+    
+    if (!liveChanged) {
+        return MonitorChangeSet();
+    }
+    
+    m_hyprlandSnapshot = MonitorSnapshot::create(fresh, live ? live->version + 1 : 1);
+    MonitorChangeSet changes = m_store->publish(next);
+    
+    for (const QString &name : std::as_const(changes.added)) {
+        emit displayAdded(name);
+    }
+    for (const QString &name : std::as_const(changes.removed)) {
+        emit displayRemoved(name);
     }
-    emit this->error(QString(errorMsg));
+    for (auto it = changes.changed.cbegin(); it != changes.changed.cend(); ++it) {
+        emit displayFieldsChanged(it.key(), it.value());
+    }
+    return changes;
 }
 
-QString DisplayManager::executeHyprctlCommand(const QStringList &args)
+void DisplayManager::setFocusedMonitor(const QString &name, const QString &workspace)
 {
-    m_hyprctlProcess->start("hyprctl", args);
-    m_hyprctlProcess->waitForFinished(5000); // Wait up to 5 seconds
-    
-    if (m_hyprctlProcess->exitCode() != 0) {
-        qWarning() << "hyprctl command failed:" << args << "Exit code:" << m_hyprctlProcess->exitCode();
-        return QString();
+    updateRuntimeFields([&](DisplayInfo &display) {
+        display.setPrimary(display.name == name);
+        if (display.name == name && !workspace.isEmpty()) {
+            display.workspace = workspace;
+        }
+    });
+}
+
+void DisplayManager::setActiveWorkspace(const QString &workspace)
+{
+    // workspace>>NAME is about the focused monitor
+    updateRuntimeFields([&](DisplayInfo &display) {
+        if (display.isPrimary()) {
+            display.workspace = workspace;
+        }
+    });
+}
+
+void DisplayManager::updateRuntimeFields(const std::function<void(DisplayInfo &)> &update)
+{
+    if (m_hyprlandSnapshot) {
+        QList<DisplayInfo> live = m_hyprlandSnapshot->displays;
+        for (DisplayInfo &display : live) {
+            update(display);
+        }
+        m_hyprlandSnapshot = MonitorSnapshot::create(live, m_hyprlandSnapshot->version + 1);
     }
+    // The next reply differs from the last one in these fields at most; let it through
+    m_lastMonitorsReply.clear();
     
-    return QString::fromUtf8(m_hyprctlProcess->readAllStandardOutput());
-}
-
-bool DisplayManager::executeHyprctlCommandAsync(const QStringList &args)
-{
-    m_hyprctlProcess->start("hyprctl", args);
-    return m_hyprctlProcess->waitForStarted(5000);
-}
-
-bool DisplayManager::parseHyprctlOutput(const QString &output)
-{
-    m_displays.clear();
-    QJsonDocument doc = QJsonDocument::fromJson(output.toUtf8());
-    if (!doc.isArray()) return false;
-    QJsonArray arr = doc.array();
-    for (const QJsonValue &val : arr) {
-        QJsonObject obj = val.toObject();
-        DisplayInfo di;
-        di.name = obj["name"].toString();
-        di.description = obj["description"].toString();
-        di.manufacturer = obj["make"].toString();
-        di.model = obj["model"].toString();
-        di.serial = obj["serial"].toString();
-        di.width = obj["width"].toInt();
-        di.height = obj["height"].toInt();
-        di.refreshRate = obj["refreshRate"].toDouble();
-        di.x = obj["x"].toInt();
-        di.y = obj["y"].toInt();
-        di.scale = obj["scale"].toDouble();
-        di.enabled = !obj["disabled"].toBool();
-        di.primary = obj["focused"].toBool();
-        di.resolution = QString("%1x%2").arg(di.width).arg(di.height);
-        di.position = QString("%1x%2").arg(di.x).arg(di.y);
-        di.transform = QString::number(obj["transform"].toInt());
-        di.mirrorOf = obj["mirrorOf"].toString();
-        di.workspace = obj["activeWorkspace"].toObject()["name"].toString();
-        di.hdr = obj.contains("hdr") ? obj["hdr"].toBool() : false;
-        di.sdrBrightness = obj.contains("sdrBrightness") ? obj["sdrBrightness"].toDouble(1.0) : 1.0;
-        di.sdrSaturation = obj.contains("sdrSaturation") ? obj["sdrSaturation"].toDouble(1.0) : 1.0;
-        di.vrrMode = obj.contains("vrrMode") ? obj["vrrMode"].toInt() : 0;
-        di.vrrCapable = obj.contains("vrr");
-        di.hdrCapable = true;
-        di.tenBit = obj.contains("tenBit") ? obj["tenBit"].toBool() : false;
-        di.wideGamut = obj.contains("wideGamut") ? obj["wideGamut"].toBool() : false;
-        QJsonArray modes = obj["availableModes"].toArray();
-        for (const QJsonValue &mode : modes) di.availableModes.append(mode.toString());
-        m_displays.append(di);
-    }
-    sortDisplays();
+    QList<DisplayInfo> working = m_store->snapshot()->displays;
+    for (DisplayInfo &display : working) {
+        update(display);
+    }
+    const MonitorChangeSet changes = m_store->publish(working);
+    if (changes.isEmpty()) {
+        return;
+    }
+    for (auto it = changes.changed.cbegin(); it != changes.changed.cend(); ++it) {
+        emit displayFieldsChanged(it.key(), it.value());
+    }
     emit displaysChanged();
-    return !m_displays.isEmpty();
 }
 
-QString DisplayManager::buildMonitorCommand(const DisplayInfo &monitor)
+bool DisplayManager::parseHyprctlOutput(const QByteArray &output, QList<DisplayInfo> &displays) const
 {
-    QString command = QString("monitor,%1,%2x%3@%4,%5x%6,%7")
-                     .arg(monitor.name)
-                     .arg(monitor.width)
-                     .arg(monitor.height)
-                     .arg(monitor.refreshRate)
-                     .arg(monitor.x)
-                     .arg(monitor.y)
-                     .arg(monitor.scale);
-    
-    if (!monitor.transform.isEmpty() && monitor.transform != "normal") {
-        command += QString(",%1").arg(monitor.transform);
-    }
-    
-    if (!monitor.mirrorOf.isEmpty()) {
-        command += QString(",mirror,%1").arg(monitor.mirrorOf);
+    QString decodeError;
+    if (!MonitorJsonDecoder::decode(output, displays, &decodeError)) {
+        qWarning() << "Invalid hyprctl monitors reply:" << decodeError;
+        return false;
     }
-    
-    return command;
+    sortDisplays(displays);
+    return !displays.isEmpty();
 }
 
-void DisplayManager::sortDisplays()
+void DisplayManager::sortDisplays(QList<DisplayInfo> &displays)
 {
-    std::sort(m_displays.begin(), m_displays.end(), [](const DisplayInfo &a, const DisplayInfo &b) {
+    std::sort(displays.begin(), displays.end(), [](const DisplayInfo &a, const DisplayInfo &b) {
         if (a.y != b.y) {
             return a.y < b.y; // Sort by Y first
         }
@@ -3,55 +3,136 @@
 
 #include <QObject>
 #include <QList>
+#include <QSharedPointer>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QProcess>
 #include <QTimer>
-#include <QScreen>
-#include <QApplication>
 #include <QDebug>
 #include <QDir>
 #include <QFile>
 #include <QTextStream>
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
+#include <functional>
 
+#include "hyprlandipc.h"
+#include "modetable.h"
+#include "snapshotformat.h"
+
+// Groups of DisplayInfo fields, used to describe what differs between two
+// states of the same monitor
+enum class DisplayField : quint32 {
+    None             = 0,
+    Identity         = 1 << 0,   // description, make, model, serial
+    Mode             = 1 << 1,   // width, height, refresh rate
+    Position         = 1 << 2,
+    Scale            = 1 << 3,
+    Transform        = 1 << 4,
+    Mirror           = 1 << 5,
+    Enabled          = 1 << 6,
+    Primary          = 1 << 7,
+    Workspace        = 1 << 8,
+    ColorManagement  = 1 << 9,   // hdr, 10-bit, wide gamut, SDR brightness/saturation
+    Vrr              = 1 << 10,
+    Capabilities     = 1 << 11,  // available modes, VRR/HDR capability
+};
+Q_DECLARE_FLAGS(DisplayFields, DisplayField)
+Q_DECLARE_OPERATORS_FOR_FLAGS(DisplayFields)
+
+// Output transform, numbered like Hyprland's "transform" field
+enum class DisplayTransform : quint8 {
+    Normal = 0,
+    Rotate90,
+    Rotate180,
+    Rotate270,
+    Flipped,
+    Flipped90,
+    Flipped180,
+    Flipped270,
+};
+
+// On/off state of a monitor, packed into DisplayInfo::flags
+enum class DisplayFlag : quint16 {
+    None        = 0,
+    Enabled     = 1 << 0,
+    Primary     = 1 << 1,
+    Hdr         = 1 << 2,
+    TenBit      = 1 << 3,
+    WideGamut   = 1 << 4,
+    VrrCapable  = 1 << 5,
+    HdrCapable  = 1 << 6,
+};
+Q_DECLARE_FLAGS(DisplayFlags, DisplayFlag)
+Q_DECLARE_OPERATORS_FOR_FLAGS(DisplayFlags)
+
+// Resolution, position and transform names are derived on demand from
+// width/height, x/y and the transform enum.
 struct DisplayInfo {
     QString name;
     QString description;
     QString manufacturer;
     QString model;
     QString serial;
-    int width;
-    int height;
-    int refreshRate;
-    int x;
-    int y;
-    double scale;
-    bool enabled;
-    bool primary;
-    QString resolution;
-    QString position;
-    QString transform;
     QString mirrorOf;
     QString workspace;
-    
-    // New Hyprland properties
-    bool hdr;
-    double sdrBrightness;
-    double sdrSaturation;
-    int vrrMode;  // 0=disabled, 1=global, 2=fullscreen only
     QList<QString> availableModes;
-    bool vrrCapable;
-    bool hdrCapable;
-    bool tenBit;
-    bool wideGamut;
+    ModeTablePtr modeTable;  // availableModes parsed and sorted, shared between copies
+    
+    double refreshRate = 0.0;  // Hz, exact (59.94)
+    double scale = 1.0;
+    double sdrBrightness = 1.0;
+    double sdrSaturation = 1.0;
+    int width = 0;
+    int height = 0;
+    int x = 0;
+    int y = 0;
+    int vrrMode = 0;  // 0=disabled, 1=global, 2=fullscreen only
+    DisplayTransform transform = DisplayTransform::Normal;
+    DisplayFlags flags;
+    
+    bool isEnabled() const { return flags.testFlag(DisplayFlag::Enabled); }
+    void setEnabled(bool on) { flags.setFlag(DisplayFlag::Enabled, on); }
+    bool isPrimary() const { return flags.testFlag(DisplayFlag::Primary); }
+    void setPrimary(bool on) { flags.setFlag(DisplayFlag::Primary, on); }
+    bool isHdr() const { return flags.testFlag(DisplayFlag::Hdr); }
+    void setHdr(bool on) { flags.setFlag(DisplayFlag::Hdr, on); }
+    bool isTenBit() const { return flags.testFlag(DisplayFlag::TenBit); }
+    void setTenBit(bool on) { flags.setFlag(DisplayFlag::TenBit, on); }
+    bool isWideGamut() const { return flags.testFlag(DisplayFlag::WideGamut); }
+    void setWideGamut(bool on) { flags.setFlag(DisplayFlag::WideGamut, on); }
+    bool isVrrCapable() const { return flags.testFlag(DisplayFlag::VrrCapable); }
+    void setVrrCapable(bool on) { flags.setFlag(DisplayFlag::VrrCapable, on); }
+    bool isHdrCapable() const { return flags.testFlag(DisplayFlag::HdrCapable); }
+    void setHdrCapable(bool on) { flags.setFlag(DisplayFlag::HdrCapable, on); }
+    
+    // "2560x1440" and "0x0"
+    QString resolution() const { return QString("%1x%2").arg(width).arg(height); }
+    QString position() const { return QString("%1x%2").arg(x).arg(y); }
+    bool setResolution(const QString &resolution);
+    
+    // Hyprland's number ("0".."7") and the monitors.conf style name ("normal", "flipped-90")
+    QString transformNumber() const { return QString::number(static_cast<int>(transform)); }
+    QString transformName() const { return transformName(transform); }
+    static QString transformName(DisplayTransform transform);
+    // Accepts either form; unknown values leave ok false and return Normal
+    static DisplayTransform parseTransform(const QString &text, bool *ok = nullptr);
     
     QJsonObject toJson() const;
     static DisplayInfo fromJson(const QJsonObject &json);
+    
+    // Fields of this monitor that differ from other
+    DisplayFields diff(const DisplayInfo &other) const;
 };
 
+
+struct ApplyPlan;
+struct MonitorSnapshot;
+struct MonitorChangeSet;
+class MonitorStateStore;
+using MonitorSnapshotPtr = QSharedPointer<const MonitorSnapshot>;
+
 class DisplayManager : public QObject
 {
     Q_OBJECT
@@ -60,16 +141,41 @@ public:
     explicit DisplayManager(QObject *parent = nullptr);
     ~DisplayManager();
 
+    // Current monitor list; O(1), shares the data of the published snapshot
+    MonitorSnapshotPtr snapshot() const;
+    // Last state read from Hyprland or acknowledged by it; null before the first refresh
+    MonitorSnapshotPtr hyprlandSnapshot() const { return m_hyprlandSnapshot; }
+    MonitorStateStore *stateStore() const;
+    
     QList<DisplayInfo> getDisplays() const;
     DisplayInfo getDisplay(const QString &name) const;
+    void setDisplays(const QList<DisplayInfo> &displays);
     void setDisplay(const DisplayInfo &display);
     void updateDisplayInMemory(const DisplayInfo &display);
     void removeDisplay(const QString &name);
     void clearDisplays();
     
+    // Both return immediately; completion is reported through
+    // refreshFinished()/applyFinished() once Hyprland has answered
     bool refreshDisplays();
+    // True while a refresh is queued behind the one in flight
+    bool isRefreshPending() const { return m_refreshPending; }
     bool applyConfiguration();
-    bool saveConfiguration(const QString &path);
+    // Applies displays without touching the working copy; monitors nobody
+    // has edited follow the new layout once Hyprland accepts it
+    bool applyLayout(const QList<DisplayInfo> &displays);
+    // Every apply gets an id; applyFinished() reports finishedApplyId()
+    bool isApplying() const { return m_appliesInFlight > 0; }
+    quint64 lastApplyId() const { return m_applySequence; }
+    quint64 finishedApplyId() const { return m_finishedApplyId; }
+    HyprlandBatchResult lastApplyResult() const;
+    ApplyPlan planConfiguration() const;
+    QString dryRunConfiguration() const;
+    
+    // Overlays the settings saved in monitors.conf onto a live monitor
+    static DisplayInfo mergeWithConfig(const DisplayInfo &live, const QJsonObject &config);
+    // loadConfiguration() reads either format
+    bool saveConfiguration(const QString &path, SnapshotFormat::Format format = SnapshotFormat::Json);
     bool loadConfiguration(const QString &path);
     
     QJsonObject getConfiguration() const;
@@ -84,40 +190,54 @@ public:
 public slots:
     void onDisplayChanged();
     void onConfigurationChanged();
+    // Focus and active workspace from the event socket, applied without a
+    // round trip to Hyprland; they never replace unapplied edits
+    void setFocusedMonitor(const QString &name, const QString &workspace);
+    void setActiveWorkspace(const QString &workspace);
 
 signals:
     void displaysChanged();
     void configurationChanged();
+    void refreshFinished(bool ok);
+    // Fine-grained results of a refresh; displaysChanged() follows only if one of these fired
+    void displayAdded(const QString &name);
+    void displayRemoved(const QString &name);
+    void displayFieldsChanged(const QString &name, DisplayFields fields);
+    void applyFinished(bool ok);
     void error(const QString &message);
     void success(const QString &message);
 
-private slots:
-    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
-    void onProcessError(QProcess::ProcessError error);
-
 private:
-    bool parseHyprctlOutput(const QString &output);
+    void onMonitorsReply(quint64 id, const HyprlandReply &reply);
+    bool parseHyprctlOutput(const QByteArray &output, QList<DisplayInfo> &displays) const;
+    MonitorChangeSet reconcile(const QList<DisplayInfo> &fresh);
+    bool applySnapshot(MonitorSnapshotPtr desired);
+    void followAppliedLayout(MonitorSnapshotPtr previous, MonitorSnapshotPtr applied);
+    // Rewrites the runtime fields in both the live snapshot and the working copy
+    void updateRuntimeFields(const std::function<void(DisplayInfo &)> &update);
     bool parseMonitorOutput(const QString &output);
     bool parseDeviceOutput(const QString &output);
     bool parseWorkspaceOutput(const QString &output);
     
-    QString executeHyprctlCommand(const QStringList &args);
-    bool executeHyprctlCommandAsync(const QStringList &args);
-    
     void updateDisplayPositions();
     void validateConfiguration();
-    void sortDisplays();
-    QString buildMonitorCommand(const DisplayInfo &monitor);
+    static void sortDisplays(QList<DisplayInfo> &displays);
     
-    QList<DisplayInfo> m_displays;
+    MonitorStateStore *m_store;
+    MonitorSnapshotPtr m_hyprlandSnapshot;  // last state read from Hyprland
+    QByteArray m_lastMonitorsReply;
     QJsonObject m_configuration;
     int m_numWorkspaces;
     
-    QProcess *m_hyprctlProcess;
-    QTimer *m_refreshTimer;
+    HyprlandBatchResult m_lastApplyResult;
+    quint64 m_applySequence = 0;
+    quint64 m_finishedApplyId = 0;
+    int m_appliesInFlight = 0;
     
     QStringList m_workspaceNames;
     bool m_isRefreshing;
+    bool m_refreshPending;
+    quint64 m_refreshRequestId;
 };
 
 #endif // DISPLAYMANAGER_H 
\ No newline at end of file
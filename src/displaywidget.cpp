@@ -22,8 +22,8 @@ DisplayWidget::DisplayWidget(const DisplayInfo &display, QWidget *parent)
     , m_originalDisplayInfo(display)
     , m_hasChanges(false)
     , m_isSelected(false)
-    , m_isPrimary(display.primary)
-    , m_isEnabled(display.enabled)
+    , m_isPrimary(display.isPrimary())
+    , m_isEnabled(display.isEnabled())
     , m_isDragging(false)
     , m_isHovered(false)
     , m_isPressed(false)
@@ -111,7 +111,7 @@ void DisplayWidget::setPrimary(bool primary)
 {
     if (m_isPrimary != primary) {
         m_isPrimary = primary;
-        m_displayInfo.primary = primary;
+        m_displayInfo.setPrimary(primary);
         update();
         emit settingsChanged();
     }
@@ -126,7 +126,7 @@ void DisplayWidget::setEnabled(bool enabled)
 {
     if (m_isEnabled != enabled) {
         m_isEnabled = enabled;
-        m_displayInfo.enabled = enabled;
+        m_displayInfo.setEnabled(enabled);
         update();
         emit settingsChanged();
     }
@@ -135,14 +135,14 @@ void DisplayWidget::setEnabled(bool enabled)
 void DisplayWidget::updateFromDisplayInfo()
 {
     if (m_nameLabel) m_nameLabel->setText(m_displayInfo.name);
-    if (m_resolutionLabel) m_resolutionLabel->setText(m_displayInfo.resolution);
+    if (m_resolutionLabel) m_resolutionLabel->setText(m_displayInfo.resolution());
     if (m_refreshLabel) m_refreshLabel->setText(QString("%1 Hz").arg(m_displayInfo.refreshRate));
     if (m_scaleLabel) m_scaleLabel->setText(QString("%1x").arg(m_displayInfo.scale));
-    if (m_positionLabel) m_positionLabel->setText(m_displayInfo.position);
+    if (m_positionLabel) m_positionLabel->setText(m_displayInfo.position());
     if (m_workspaceLabel) m_workspaceLabel->setText(m_displayInfo.workspace);
     
-    if (m_enabledCheckBox) m_enabledCheckBox->setChecked(m_displayInfo.enabled);
-    if (m_primaryCheckBox) m_primaryCheckBox->setChecked(m_displayInfo.primary);
+    if (m_enabledCheckBox) m_enabledCheckBox->setChecked(m_displayInfo.isEnabled());
+    if (m_primaryCheckBox) m_primaryCheckBox->setChecked(m_displayInfo.isPrimary());
     
     updatePreview();
     update();
@@ -196,10 +196,10 @@ void DisplayWidget::setupUI()
     m_nameLabel->setAlignment(Qt::AlignCenter);
     m_nameLabel->setStyleSheet("font-weight: bold;");
     
-    m_resolutionLabel = new QLabel(m_displayInfo.resolution, m_previewFrame);
+    m_resolutionLabel = new QLabel(m_displayInfo.resolution(), m_previewFrame);
     m_refreshLabel = new QLabel(QString("%1 Hz").arg(m_displayInfo.refreshRate), m_previewFrame);
     m_scaleLabel = new QLabel(QString("%1x").arg(m_displayInfo.scale), m_previewFrame);
-    m_positionLabel = new QLabel(m_displayInfo.position, m_previewFrame);
+    m_positionLabel = new QLabel(m_displayInfo.position(), m_previewFrame);
     m_workspaceLabel = new QLabel(m_displayInfo.workspace, m_previewFrame);
     
     previewLayout->addWidget(m_previewLabel);
@@ -215,20 +215,20 @@ void DisplayWidget::setupUI()
     m_basicLayout->setSpacing(8);
     
     m_enabledCheckBox = new QCheckBox("Enabled", this);
-    m_enabledCheckBox->setChecked(m_displayInfo.enabled);
+    m_enabledCheckBox->setChecked(m_displayInfo.isEnabled());
     
     m_primaryCheckBox = new QCheckBox("Primary", this);
-    m_primaryCheckBox->setChecked(m_displayInfo.primary);
+    m_primaryCheckBox->setChecked(m_displayInfo.isPrimary());
     
     m_resolutionComboBox = new QComboBox(this);
-    m_resolutionComboBox->addItem(m_displayInfo.resolution);
+    m_resolutionComboBox->addItem(m_displayInfo.resolution());
     m_resolutionComboBox->addItem("1920x1080");
     m_resolutionComboBox->addItem("2560x1440");
     m_resolutionComboBox->addItem("3840x2160");
     
     m_refreshRateSpinBox = new QSpinBox(this);
     m_refreshRateSpinBox->setRange(30, 360);
-    m_refreshRateSpinBox->setValue(m_displayInfo.refreshRate);
+    m_refreshRateSpinBox->setValue(qRound(m_displayInfo.refreshRate));
     m_refreshRateSpinBox->setSuffix(" Hz");
     
     m_scaleSpinBox = new QDoubleSpinBox(this);
@@ -239,7 +239,7 @@ void DisplayWidget::setupUI()
     
     m_transformComboBox = new QComboBox(this);
     m_transformComboBox->addItems({"normal", "90", "180", "270", "flipped", "flipped-90"});
-    m_transformComboBox->setCurrentText(m_displayInfo.transform);
+    m_transformComboBox->setCurrentText(m_displayInfo.transformName());
     
     m_workspaceComboBox = new QComboBox(this);
     m_workspaceComboBox->addItem("Auto", "");
@@ -346,13 +346,11 @@ void DisplayWidget::setupConnections()
     // Position connections
     connect(m_xSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int value) {
         m_displayInfo.x = value;
-        m_displayInfo.position = QString("%1x%2").arg(value).arg(m_displayInfo.y);
         onPositionChanged();
     });
     
     connect(m_ySpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int value) {
         m_displayInfo.y = value;
-        m_displayInfo.position = QString("%1x%2").arg(m_displayInfo.x).arg(value);
         onPositionChanged();
     });
     
@@ -377,7 +375,7 @@ void DisplayWidget::updatePreview()
     // Update preview based on display info
     if (m_previewLabel) {
         QString previewText = QString("%1\n%2@%3Hz\nScale: %4x")
-                             .arg(m_displayInfo.resolution)
+                             .arg(m_displayInfo.resolution())
                              .arg(m_displayInfo.refreshRate)
                              .arg(m_displayInfo.scale);
         m_previewLabel->setText(previewText);
@@ -498,8 +496,8 @@ void DisplayWidget::enterEvent(QEnterEvent *event)
     update();
     setToolTip(QString("Display: %1\nResolution: %2\nPosition: %3")
                .arg(m_displayInfo.name)
-               .arg(m_displayInfo.resolution)
-               .arg(m_displayInfo.position));
+               .arg(m_displayInfo.resolution())
+               .arg(m_displayInfo.position()));
 }
 
 void DisplayWidget::leaveEvent(QEvent *event)
@@ -563,11 +561,7 @@ void DisplayWidget::onEnabledToggled(bool enabled)
 
 void DisplayWidget::onResolutionChanged(const QString &resolution)
 {
-    QStringList parts = resolution.split('x');
-    if (parts.size() == 2) {
-        m_displayInfo.width = parts[0].toInt();
-        m_displayInfo.height = parts[1].toInt();
-        m_displayInfo.resolution = resolution;
+    if (m_displayInfo.setResolution(resolution)) {
         updatePreview();
         onSettingsChanged();
     }
@@ -589,7 +583,7 @@ void DisplayWidget::onScaleChanged(double scale)
 
 void DisplayWidget::onTransformChanged(const QString &transform)
 {
-    m_displayInfo.transform = transform;
+    m_displayInfo.transform = DisplayInfo::parseTransform(transform);
     onSettingsChanged();
 }
 
@@ -671,31 +665,31 @@ void DisplayWidget::onSetSecondaryClicked()
 
 void DisplayWidget::onRotate90Clicked()
 {
-    m_displayInfo.transform = "90";
+    m_displayInfo.transform = DisplayTransform::Rotate90;
     onSettingsChanged();
 }
 
 void DisplayWidget::onRotate180Clicked()
 {
-    m_displayInfo.transform = "180";
+    m_displayInfo.transform = DisplayTransform::Rotate180;
     onSettingsChanged();
 }
 
 void DisplayWidget::onRotate270Clicked()
 {
-    m_displayInfo.transform = "270";
+    m_displayInfo.transform = DisplayTransform::Rotate270;
     onSettingsChanged();
 }
 
 void DisplayWidget::onFlipHorizontalClicked()
 {
-    m_displayInfo.transform = "flipped";
+    m_displayInfo.transform = DisplayTransform::Flipped;
     onSettingsChanged();
 }
 
 void DisplayWidget::onFlipVerticalClicked()
 {
-    m_displayInfo.transform = "flipped-90";
+    m_displayInfo.transform = DisplayTransform::Flipped90;
     onSettingsChanged();
 }
 
@@ -0,0 +1,231 @@
+#include "hotplugdaemon.h"
+#include "configmanager.h"
+#include "controlserver.h"
+#include "displaymanager.h"
+#include "hotplugprofileapplier.h"
+#include "hyprlandinterface.h"
+#include "hyprlandipc.h"
+#include "monitorstatestore.h"
+#include <QAbstractEventDispatcher>
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QEvent>
+#include <QFile>
+#include <QFileInfo>
+#include <QLoggingCategory>
+#include <QSocketNotifier>
+#include <QTextStream>
+
+#include <csignal>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+// SIGTERM and SIGINT are turned into a byte on this pair, so the daemon
+// leaves the event loop and removes its socket instead of dying in place
+int signalFds[2] = {-1, -1};
+
+void onSignal(int)
+{
+    const char byte = 1;
+    const ssize_t written = ::write(signalFds[1], &byte, 1);
+    Q_UNUSED(written);
+}
+
+bool installSignalHandlers(QObject *context)
+{
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, signalFds) != 0) {
+        return false;
+    }
+    auto *notifier = new QSocketNotifier(signalFds[0], QSocketNotifier::Read, context);
+    QObject::connect(notifier, &QSocketNotifier::activated, context, [notifier]() {
+        char byte;
+        const ssize_t read = ::read(signalFds[0], &byte, 1);
+        Q_UNUSED(read);
+        notifier->setEnabled(false);
+        QCoreApplication::quit();
+    });
+
+    struct sigaction action = {};
+    action.sa_handler = onSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    return ::sigaction(SIGTERM, &action, nullptr) == 0 && ::sigaction(SIGINT, &action, nullptr) == 0;
+}
+
+}
+
+HotplugDaemon::HotplugDaemon(const QString &profilesPath, const QString &socketPath, QObject *parent)
+    : QObject(parent)
+    , m_profilesPath(profilesPath)
+    , m_socketPath(socketPath)
+    , m_configManager(new ConfigManager(this))
+    , m_displayManager(new DisplayManager(this))
+    , m_hyprlandInterface(new HyprlandInterface(this))
+    , m_applier(nullptr)
+    , m_controlServer(nullptr)
+{
+    // The event socket says when Hyprland goes away; no hyprctl probe every 10 s
+    m_hyprlandInterface->setConnectionPolling(false);
+    m_hyprlandInterface->setMonitorStore(m_displayManager->stateStore());
+
+    m_applier = new HotplugProfileApplier(m_displayManager, m_profilesPath, this);
+    m_applier->setSnapshotFormat(m_configManager->snapshotFormat());
+    connect(m_applier, &HotplugProfileApplier::profileApplied, this, [this]() {
+        ++m_statistics.profilesApplied;
+    });
+
+    auto onHotplug = [this](const QString &name) {
+        qInfo() << "Hotplug:" << name;
+        ++m_statistics.hotplugs;
+        m_applier->onHotplug();
+    };
+    connect(m_hyprlandInterface, &HyprlandInterface::monitorAdded, this, onHotplug);
+    connect(m_hyprlandInterface, &HyprlandInterface::monitorRemoved, this, onHotplug);
+    // Keeps the state clients read current; identical replies are dropped by the refresh
+    connect(m_hyprlandInterface, &HyprlandInterface::configurationChanged, m_displayManager, &DisplayManager::refreshDisplays);
+    // Focus and workspace come with the event; a focus move costs no request
+    connect(m_hyprlandInterface, &HyprlandInterface::monitorFocused, m_displayManager, &DisplayManager::setFocusedMonitor);
+    connect(m_hyprlandInterface, &HyprlandInterface::activeWorkspaceChanged, m_displayManager, &DisplayManager::setActiveWorkspace);
+    connect(m_hyprlandInterface, &HyprlandInterface::disconnected, this, [this]() {
+        // A restarted Hyprland is a new instance with its own sockets and its own daemon
+        if (!QFileInfo::exists(HyprlandIpc::eventSocketPath())) {
+            qInfo() << "Hyprland exited, stopping the daemon";
+            emit finished();
+        }
+    });
+
+    m_controlServer = new ControlServer(m_displayManager, m_applier, this);
+    m_controlServer->setStatusProvider([this]() { return status(); });
+}
+
+HotplugDaemon::~HotplugDaemon()
+{
+}
+
+qint64 HotplugDaemon::residentKb()
+{
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    // "VmRSS:	   10240 kB"
+    for (const QByteArray &line : status.readAll().split('\n')) {
+        if (line.startsWith("VmRSS:")) {
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+        }
+    }
+    return 0;
+}
+
+bool HotplugDaemon::start(QString *error)
+{
+    if (!m_controlServer->listen(m_socketPath, error)) {
+        return false;
+    }
+
+    // Counted for the idle check in tests/bench_daemon.cpp; both must stay flat while nothing happens
+    if (QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance()) {
+        connect(dispatcher, &QAbstractEventDispatcher::awake, this, [this]() { ++m_statistics.wakeups; });
+    }
+    QCoreApplication::instance()->installEventFilter(this);
+
+    m_hyprlandInterface->startEventMonitoring();
+    // Monitors plugged in while nothing was running get their layout now, and
+    // the refresh fills the state clients read
+    m_applier->onHotplug();
+    qInfo() << "HyprDisplays daemon started";
+    return true;
+}
+
+QJsonObject HotplugDaemon::status() const
+{
+    QJsonObject statistics;
+    statistics["wakeups"] = m_statistics.wakeups;
+    statistics["timerEvents"] = m_statistics.timerEvents;
+    statistics["hotplugs"] = m_statistics.hotplugs;
+    statistics["profilesApplied"] = m_statistics.profilesApplied;
+    statistics["residentKb"] = residentKb();
+
+    QJsonObject json;
+    json["role"] = "daemon";
+    json["connected"] = m_hyprlandInterface->isConnected();
+    json["statistics"] = statistics;
+    return json;
+}
+
+bool HotplugDaemon::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Timer) {
+        ++m_statistics.timerEvents;
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+bool HotplugDaemon::isRequested(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--daemon") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int HotplugDaemon::run(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("HyprDisplays");
+    app.setApplicationVersion("1.0.0");
+    app.setOrganizationName("HyprDisplays");
+    app.setOrganizationDomain("hyprdisplays.org");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Applies saved monitor layouts on hotplug, without a window");
+    parser.addHelpOption();
+    QCommandLineOption daemonOption("daemon", "Stay resident and apply the saved layout when monitors change");
+    QCommandLineOption verboseOption(QStringList() << "v" << "verbose", "Log debug output to stderr");
+    QCommandLineOption profilesPathOption(
+        "profiles-path",
+        "Path of the saved layout profiles",
+        "path",
+        LayoutProfileStore::defaultPath()
+    );
+    QCommandLineOption socketPathOption(
+        "socket-path",
+        "Path of the JSON-RPC control socket",
+        "path",
+        ControlServer::defaultSocketPath()
+    );
+    parser.addOption(daemonOption);
+    parser.addOption(verboseOption);
+    parser.addOption(profilesPathOption);
+    parser.addOption(socketPathOption);
+    parser.process(app);
+
+    // Hotplugs and applied layouts stay in the journal; the rest only when asked for
+    if (!parser.isSet(verboseOption)) {
+        QLoggingCategory::setFilterRules("*.debug=false");
+    }
+
+    QTextStream err(stderr);
+    if (qEnvironmentVariableIsEmpty("HYPRLAND_INSTANCE_SIGNATURE")) {
+        err << "HYPRLAND_INSTANCE_SIGNATURE is not set; start the daemon from Hyprland (exec-once)" << Qt::endl;
+        return 1;
+    }
+
+    HotplugDaemon daemon(parser.value(profilesPathOption), parser.value(socketPathOption));
+    QObject::connect(&daemon, &HotplugDaemon::finished, &app, &QCoreApplication::quit);
+    QString error;
+    if (!daemon.start(&error)) {
+        err << "Failed to start the daemon: " << error << Qt::endl;
+        return 1;
+    }
+    if (!installSignalHandlers(&app)) {
+        qWarning() << "Failed to install signal handlers; SIGTERM leaves the socket behind";
+    }
+    return app.exec();
+}
@@ -0,0 +1,68 @@
+#ifndef HOTPLUGDAEMON_H
+#define HOTPLUGDAEMON_H
+
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+
+class ConfigManager;
+class ControlServer;
+class DisplayManager;
+class HotplugProfileApplier;
+class HyprlandInterface;
+
+// hyprdisplays --daemon: stays resident for the session and applies the
+// saved layout whenever monitors are plugged in or removed, with or without
+// the window. It wakes only when Hyprland writes to the event socket or a
+// client connects; there is no poll of any kind, so an idle daemon sleeps
+// in the event loop. Scripts query and change the layout through its
+// ControlServer without a round trip to the compositor.
+class HotplugDaemon : public QObject
+{
+    Q_OBJECT
+
+public:
+    // What an idle daemon must keep at zero, and what it costs
+    struct Statistics {
+        qint64 wakeups = 0;      // returns from the event dispatcher
+        qint64 timerEvents = 0;  // QTimer and startTimer() expirations
+        qint64 hotplugs = 0;
+        qint64 profilesApplied = 0;
+    };
+
+    HotplugDaemon(const QString &profilesPath, const QString &socketPath, QObject *parent = nullptr);
+    ~HotplugDaemon();
+
+    // VmRSS of this process in KiB, 0 where /proc is not available
+    static qint64 residentKb();
+
+    // Connects to Hyprland, listens on the control socket and applies the
+    // layout for the monitors connected now
+    bool start(QString *error = nullptr);
+    const Statistics &statistics() const { return m_statistics; }
+    // getStatus of the control socket: connection state and statistics
+    QJsonObject status() const;
+
+    // Checked before any application object exists
+    static bool isRequested(int argc, char *argv[]);
+    static int run(int argc, char *argv[]);
+
+signals:
+    // Hyprland exited; the daemon has nothing left to do
+    void finished();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    QString m_profilesPath;
+    QString m_socketPath;
+    ConfigManager *m_configManager;
+    DisplayManager *m_displayManager;
+    HyprlandInterface *m_hyprlandInterface;
+    HotplugProfileApplier *m_applier;
+    ControlServer *m_controlServer;
+    Statistics m_statistics;
+};
+
+#endif // HOTPLUGDAEMON_H
@@ -0,0 +1,134 @@
+#include "hotplugprofileapplier.h"
+#include "displaymanager.h"
+#include "monitorstatestore.h"
+#include <QDebug>
+#include <QFileInfo>
+
+HotplugProfileApplier::HotplugProfileApplier(DisplayManager *displayManager, const QString &profilesPath, QObject *parent)
+    : QObject(parent)
+    , m_displayManager(displayManager)
+    , m_profilesPath(profilesPath)
+    , m_state(Idle)
+    , m_hotplugPending(false)
+    , m_latencyBudgetMs(250)
+    , m_format(SnapshotFormat::Json)
+    , m_fileSize(-1)
+{
+    reloadIfChanged();
+    qInfo() << "Loaded" << m_profiles.size() << "layout profiles";
+
+    connect(m_displayManager, &DisplayManager::refreshFinished, this, &HotplugProfileApplier::onRefreshFinished);
+    connect(m_displayManager, &DisplayManager::applyFinished, this, &HotplugProfileApplier::onApplyFinished);
+}
+
+void HotplugProfileApplier::reloadIfChanged()
+{
+    const QFileInfo info(m_profilesPath);
+    const qint64 size = info.exists() ? info.size() : -1;
+    if (size == m_fileSize && info.lastModified() == m_fileModified) {
+        return;
+    }
+    QString loadError;
+    if (!m_profiles.load(m_profilesPath, &loadError)) {
+        qWarning() << "Failed to load layout profiles from" << m_profilesPath << ":" << loadError;
+    }
+    rememberFileState();
+}
+
+void HotplugProfileApplier::rememberFileState()
+{
+    const QFileInfo info(m_profilesPath);
+    m_fileSize = info.exists() ? info.size() : -1;
+    m_fileModified = info.lastModified();
+}
+
+void HotplugProfileApplier::onHotplug()
+{
+    if (m_state == Applying) {
+        m_hotplugPending = true;
+        return;
+    }
+    if (m_state == Idle) {
+        // Latency is counted from the first event of a burst
+        m_sinceEvent.start();
+        m_state = Refreshing;
+    }
+    m_displayManager->refreshDisplays();
+}
+
+void HotplugProfileApplier::onRefreshFinished(bool ok)
+{
+    // Refreshes requested by anyone else, or an answer that a queued one will supersede
+    if (m_state != Refreshing || m_displayManager->isRefreshPending()) {
+        return;
+    }
+    if (!ok) {
+        m_state = Idle;
+        return;
+    }
+
+    QList<DisplayInfo> live = m_displayManager->snapshot()->displays;
+    m_fingerprint = LayoutProfileStore::fingerprint(live);
+    reloadIfChanged();
+    const LayoutProfile *profile = m_profiles.find(m_fingerprint);
+    if (!profile) {
+        qInfo() << "No saved layout for" << live.size() << "connected monitors, fingerprint" << m_fingerprint;
+        emit noProfile(m_fingerprint);
+        finish();
+        return;
+    }
+
+    profile->applyTo(live);
+    m_displayManager->setDisplays(live);
+
+    // applyConfiguration() sends one batch and may finish synchronously
+    m_state = Applying;
+    if (!m_displayManager->applyConfiguration()) {
+        finish();
+    }
+}
+
+void HotplugProfileApplier::onApplyFinished(bool ok)
+{
+    if (m_state != Applying) {
+        // Applied from the window or the CLI: that is the layout wanted for this set of monitors
+        // An empty plan finishes before the first refresh; there is no accepted layout to remember then
+        MonitorSnapshotPtr accepted = m_displayManager->hyprlandSnapshot();
+        if (ok && accepted) {
+            // Merged into what the other process may have saved meanwhile
+            reloadIfChanged();
+            // What Hyprland accepted, not the working copy, which may hold unapplied edits
+            QString fingerprint = m_profiles.remember(accepted->displays);
+            QString saveError;
+            if (!m_profiles.save(m_profilesPath, &saveError, m_format)) {
+                qWarning() << "Failed to save layout profiles:" << saveError;
+            }
+            rememberFileState();
+            qInfo() << "Saved layout profile" << fingerprint;
+        }
+        return;
+    }
+
+    const qint64 latencyMs = m_sinceEvent.elapsed();
+    const bool withinBudget = latencyMs <= m_latencyBudgetMs;
+    if (withinBudget) {
+        qInfo() << "Hotplug layout" << m_fingerprint << (ok ? "applied" : "failed") << "in" << latencyMs
+                << "ms, budget" << m_latencyBudgetMs << "ms";
+    } else {
+        qWarning() << "Hotplug layout" << m_fingerprint << (ok ? "applied" : "failed") << "in" << latencyMs
+                   << "ms, over the" << m_latencyBudgetMs << "ms budget";
+    }
+    if (ok) {
+        emit profileApplied(m_fingerprint, latencyMs, withinBudget);
+    }
+    finish();
+}
+
+void HotplugProfileApplier::finish()
+{
+    m_state = Idle;
+    if (m_hotplugPending) {
+        m_hotplugPending = false;
+        onHotplug();
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef HOTPLUGPROFILEAPPLIER_H
+#define HOTPLUGPROFILEAPPLIER_H
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+
+#include "layoutprofilestore.h"
+
+class DisplayManager;
+
+// Applies the saved layout for the connected set of monitors as soon as
+// Hyprland reports a hotplug, and remembers every layout that is applied
+// successfully by other means. The time from the first hotplug event of a
+// burst to Hyprland acknowledging the batch is logged, with a warning when
+// it exceeds latencyBudget().
+class HotplugProfileApplier : public QObject
+{
+    Q_OBJECT
+
+public:
+    HotplugProfileApplier(DisplayManager *displayManager, const QString &profilesPath, QObject *parent = nullptr);
+
+    const LayoutProfileStore &profiles() const { return m_profiles; }
+    // The daemon and the window share the file; what the other one learned
+    // is read back before a lookup or a save. A stat when nothing changed.
+    void reloadIfChanged();
+    int latencyBudget() const { return m_latencyBudgetMs; }
+    void setLatencyBudget(int ms) { m_latencyBudgetMs = ms; }
+    // Format profiles are written in; either is read
+    void setSnapshotFormat(SnapshotFormat::Format format) { m_format = format; }
+
+public slots:
+    // Connected to HyprlandInterface::monitorAdded/monitorRemoved
+    void onHotplug();
+
+signals:
+    void profileApplied(const QString &fingerprint, qint64 latencyMs, bool withinBudget);
+    void noProfile(const QString &fingerprint);
+
+private slots:
+    void onRefreshFinished(bool ok);
+    void onApplyFinished(bool ok);
+
+private:
+    enum State { Idle, Refreshing, Applying };
+
+    void finish();
+    void rememberFileState();
+
+    DisplayManager *m_displayManager;
+    LayoutProfileStore m_profiles;
+    QString m_profilesPath;
+    State m_state;
+    bool m_hotplugPending;  // another event arrived while applying
+    QString m_fingerprint;
+    QElapsedTimer m_sinceEvent;
+    int m_latencyBudgetMs;
+    SnapshotFormat::Format m_format;
+    QDateTime m_fileModified;  // of the profiles file as last read or written
+    qint64 m_fileSize;
+};
+
+#endif // HOTPLUGPROFILEAPPLIER_H
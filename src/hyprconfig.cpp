@@ -0,0 +1,341 @@
+#include "hyprconfig.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <cstring>
+
+namespace {
+
+// Hyprland stops at the same depth
+const int MaxIncludeDepth = 32;
+
+bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+bool isNameChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+bool equals(QByteArrayView a, QByteArrayView b)
+{
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size()) == 0;
+}
+
+void trim(const char *base, int &start, int &end)
+{
+    while (start < end && isBlank(base[start])) ++start;
+    while (end > start && isBlank(base[end - 1])) --end;
+}
+
+}
+
+HyprConfigFilePtr HyprConfigFile::parse(const QString &path, QByteArray data, const QDateTime &modified)
+{
+    auto file = QSharedPointer<HyprConfigFile>::create();
+    file->path = path;
+    file->data = std::move(data);
+    file->modified = modified;
+    file->size = file->data.size();
+
+    const char *base = file->data.constData();
+    const int size = file->data.size();
+    QList<int> openCategories;
+    int lineNumber = 0;
+    int pos = 0;
+    while (pos < size) {
+        ++lineNumber;
+        const char *newline = static_cast<const char *>(std::memchr(base + pos, '\n', size - pos));
+        const int lineEnd = newline ? int(newline - base) : size;
+        int start = pos;
+        pos = lineEnd + 1;
+
+        // A single # starts a comment, ## is an escaped literal #
+        int end = lineEnd;
+        int assign = -1;
+        bool escapedHash = false;
+        for (int i = start; i < lineEnd; ++i) {
+            if (base[i] == '#') {
+                if (i + 1 < lineEnd && base[i + 1] == '#') {
+                    escapedHash = true;
+                    ++i;
+                    continue;
+                }
+                end = i;
+                break;
+            }
+            if (base[i] == '=' && assign < 0) {
+                assign = i;
+            }
+        }
+        trim(base, start, end);
+        if (start == end) continue;
+
+        if (assign < 0) {
+            if (base[end - 1] == '{') {
+                int nameEnd = end - 1;
+                trim(base, start, nameEnd);
+                QByteArray name(base + start, nameEnd - start);
+                if (!openCategories.isEmpty()) {
+                    name = file->categories.at(openCategories.last()) + ':' + name;
+                }
+                file->categories.append(name);
+                openCategories.append(file->categories.size() - 1);
+            } else if (base[start] == '}' && !openCategories.isEmpty()) {
+                openCategories.removeLast();
+            }
+            continue;
+        }
+
+        HyprConfigLine line;
+        int keyEnd = assign;
+        int valueStart = assign + 1;
+        trim(base, start, keyEnd);
+        trim(base, valueStart, end);
+        line.keyStart = start;
+        line.keyLength = keyEnd - start;
+        line.valueStart = valueStart;
+        line.valueLength = end - valueStart;
+        line.line = lineNumber;
+        line.category = openCategories.isEmpty() ? -1 : openCategories.last();
+        line.needsExpansion = escapedHash || std::memchr(base + valueStart, '$', end - valueStart);
+        file->lines.append(line);
+    }
+    return file;
+}
+
+bool HyprConfigFile::keyIs(const HyprConfigLine &line, QByteArrayView fullKey) const
+{
+    const QByteArrayView name = key(line);
+    if (line.category < 0) {
+        return equals(name, fullKey);
+    }
+    const QByteArray &category = categories.at(line.category);
+    return fullKey.size() == category.size() + 1 + name.size()
+        && fullKey.at(category.size()) == ':'
+        && equals(fullKey.first(category.size()), category)
+        && equals(fullKey.sliced(category.size() + 1), name);
+}
+
+bool HyprConfig::load(const QString &path)
+{
+    m_rootPath = path;
+    m_entries.clear();
+    m_variables.clear();
+    m_files.clear();
+    m_reparsedFiles.clear();
+    m_errors.clear();
+    m_active.clear();
+
+    const QString canonical = QFileInfo(path).canonicalFilePath();
+    HyprConfigFilePtr root = canonical.isEmpty() ? HyprConfigFilePtr() : parsedFile(canonical);
+    if (!root) {
+        m_errors.append(QString("Cannot read %1").arg(path));
+        return false;
+    }
+    walk(root, 0);
+
+    // Forget files that are no longer sourced from anywhere
+    for (auto it = m_cache.begin(); it != m_cache.end();) {
+        if (m_files.contains(it.key())) {
+            ++it;
+        } else {
+            it = m_cache.erase(it);
+        }
+    }
+    return true;
+}
+
+void HyprConfig::clear()
+{
+    m_rootPath.clear();
+    m_cache.clear();
+    m_entries.clear();
+    m_variables.clear();
+    m_files.clear();
+    m_reparsedFiles.clear();
+    m_errors.clear();
+    m_active.clear();
+}
+
+QList<HyprConfigValue> HyprConfig::values(const QString &key) const
+{
+    const QByteArray wanted = key.toUtf8();
+    QList<HyprConfigValue> result;
+    for (const Entry &entry : m_entries) {
+        const HyprConfigLine &line = entry.file->lines.at(entry.line);
+        if (!entry.file->keyIs(line, wanted)) continue;
+
+        HyprConfigValue value;
+        value.value = QString::fromUtf8(line.needsExpansion ? QByteArrayView(entry.expanded)
+                                                            : entry.file->value(line));
+        value.file = entry.file->path;
+        value.line = line.line;
+        result.append(value);
+    }
+    return result;
+}
+
+QString HyprConfig::variable(const QString &name) const
+{
+    const QString bare = name.startsWith('$') ? name.mid(1) : name;
+    return QString::fromUtf8(m_variables.value(bare.toUtf8()));
+}
+
+QStringList HyprConfig::staleFiles() const
+{
+    QStringList stale;
+    for (const QString &path : m_files) {
+        QFileInfo info(path);
+        HyprConfigFilePtr cached = m_cache.value(path);
+        if (!cached || !info.isFile() || cached->size != info.size() || cached->modified != info.lastModified()) {
+            stale.append(path);
+        }
+    }
+    return stale;
+}
+
+HyprConfigFilePtr HyprConfig::parsedFile(const QString &path)
+{
+    QFileInfo info(path);
+    if (!info.isFile()) {
+        return {};
+    }
+
+    HyprConfigFilePtr cached = m_cache.value(path);
+    if (cached && cached->size == info.size() && cached->modified == info.lastModified()) {
+        return cached;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    HyprConfigFilePtr parsed = HyprConfigFile::parse(path, file.readAll(), info.lastModified());
+    m_cache.insert(path, parsed);
+    m_reparsedFiles.append(path);
+    return parsed;
+}
+
+void HyprConfig::walk(const HyprConfigFilePtr &file, int depth)
+{
+    if (!m_files.contains(file->path)) {
+        m_files.append(file->path);
+    }
+    m_active.insert(file->path);
+
+    const QString dir = QFileInfo(file->path).absolutePath();
+    for (int i = 0; i < file->lines.size(); ++i) {
+        const HyprConfigLine &line = file->lines.at(i);
+        const QByteArrayView key = file->key(line);
+
+        // Variables are substituted as they are defined, so a line only
+        // sees the definitions above it
+        QByteArray expanded = line.needsExpansion ? expand(file->value(line)) : QByteArray();
+        const QByteArrayView value = line.needsExpansion ? QByteArrayView(expanded) : file->value(line);
+
+        if (line.category < 0 && key.size() > 1 && key.at(0) == '$') {
+            m_variables.insert(key.sliced(1).toByteArray(), value.toByteArray());
+            continue;
+        }
+        if (line.category < 0 && equals(key, "source")) {
+            include(QString::fromUtf8(value), dir, depth + 1);
+            continue;
+        }
+
+        Entry entry;
+        entry.file = file;
+        entry.line = i;
+        entry.expanded = std::move(expanded);
+        m_entries.append(std::move(entry));
+    }
+
+    m_active.remove(file->path);
+}
+
+void HyprConfig::include(const QString &pattern, const QString &fromDir, int depth)
+{
+    if (depth > MaxIncludeDepth) {
+        m_errors.append(QString("source=%1: includes nested too deeply").arg(pattern));
+        return;
+    }
+
+    QString path = pattern;
+    if (path == "~" || path.startsWith("~/")) {
+        path = QDir::homePath() + path.mid(1);
+    }
+    if (QDir::isRelativePath(path)) {
+        path = fromDir + '/' + path;
+    }
+
+    // Like Hyprland, wildcards are expanded in the file name and the
+    // matches are read in name order
+    QFileInfo info(QDir::cleanPath(path));
+    QStringList matches;
+    const QString name = info.fileName();
+    if (name.contains('*') || name.contains('?') || name.contains('[')) {
+        QDir dir(info.absolutePath());
+        for (const QString &entry : dir.entryList(QStringList() << name, QDir::Files, QDir::Name)) {
+            matches.append(dir.absoluteFilePath(entry));
+        }
+    } else {
+        matches.append(info.absoluteFilePath());
+    }
+
+    for (const QString &match : matches) {
+        const QString canonical = QFileInfo(match).canonicalFilePath();
+        if (canonical.isEmpty()) {
+            m_errors.append(QString("source=%1: %2 does not exist").arg(pattern, match));
+            continue;
+        }
+        if (m_active.contains(canonical)) {
+            m_errors.append(QString("source=%1: %2 includes itself").arg(pattern, canonical));
+            continue;
+        }
+        HyprConfigFilePtr file = parsedFile(canonical);
+        if (!file) {
+            m_errors.append(QString("source=%1: cannot read %2").arg(pattern, canonical));
+            continue;
+        }
+        walk(file, depth);
+    }
+}
+
+QByteArray HyprConfig::expand(QByteArrayView value) const
+{
+    QByteArray out;
+    out.reserve(value.size());
+    const qsizetype size = value.size();
+    for (qsizetype i = 0; i < size; ++i) {
+        const char c = value.at(i);
+        if (c == '#' && i + 1 < size && value.at(i + 1) == '#') {
+            out.append('#');
+            ++i;
+            continue;
+        }
+        if (c != '$') {
+            out.append(c);
+            continue;
+        }
+
+        // Hyprland substitutes the longest defined name, so $gapsIn wins
+        // over $gaps and an undefined $gapsX still expands $gaps
+        qsizetype nameEnd = i + 1;
+        while (nameEnd < size && isNameChar(value.at(nameEnd))) ++nameEnd;
+        bool replaced = false;
+        for (qsizetype length = nameEnd - i - 1; length > 0 && !replaced; --length) {
+            auto it = m_variables.constFind(value.sliced(i + 1, length).toByteArray());
+            if (it != m_variables.constEnd()) {
+                out.append(it.value());
+                i += length;
+                replaced = true;
+            }
+        }
+        if (!replaced) {
+            out.append(c);
+        }
+    }
+    return out;
+}
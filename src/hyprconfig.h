@@ -0,0 +1,99 @@
+#ifndef HYPRCONFIG_H
+#define HYPRCONFIG_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+
+// One `key = value` line. Key and value are offsets into the file's bytes.
+struct HyprConfigLine {
+    int keyStart = 0;
+    int keyLength = 0;
+    int valueStart = 0;
+    int valueLength = 0;
+    int line = 0;           // 1-based
+    int category = -1;      // index into HyprConfigFile::categories, -1 at top level
+    bool needsExpansion = false;  // value contains $ or ##
+};
+
+// Tokenized contents of one file, reused until its mtime or size changes
+struct HyprConfigFile {
+    QString path;
+    QByteArray data;
+    QDateTime modified;
+    qint64 size = 0;
+    QList<HyprConfigLine> lines;
+    QList<QByteArray> categories;  // full paths, e.g. "decoration:blur"
+
+    static QSharedPointer<const HyprConfigFile> parse(const QString &path, QByteArray data,
+                                                      const QDateTime &modified);
+
+    QByteArrayView key(const HyprConfigLine &line) const { return QByteArrayView(data).sliced(line.keyStart, line.keyLength); }
+    QByteArrayView value(const HyprConfigLine &line) const { return QByteArrayView(data).sliced(line.valueStart, line.valueLength); }
+    bool keyIs(const HyprConfigLine &line, QByteArrayView fullKey) const;
+};
+
+using HyprConfigFilePtr = QSharedPointer<const HyprConfigFile>;
+
+// A keyword as Hyprland sees it: $variables expanded, with where it came from
+struct HyprConfigValue {
+    QString value;
+    QString file;
+    int line = 0;
+};
+
+// Reads hyprland.conf the way Hyprland does: follows source= includes
+// (relative to the including file, ~ and globs allowed) and expands
+// $variables in definition order. Parsed files are cached by path, mtime
+// and size; a reload re-parses only the files whose mtime or size changed.
+class HyprConfig
+{
+public:
+    // Loads path and everything it sources. Returns false if path itself
+    // cannot be read; problems with included files end up in errors().
+    bool load(const QString &path);
+    bool reload() { return load(m_rootPath); }
+    void clear();
+
+    // Every value of key in include order. Keys inside categories are
+    // written as "category:key".
+    QList<HyprConfigValue> values(const QString &key) const;
+    // Final value of $name after the whole config was read
+    QString variable(const QString &name) const;
+
+    QString rootPath() const { return m_rootPath; }
+    QStringList files() const { return m_files; }                  // include order
+    QStringList reparsedFiles() const { return m_reparsedFiles; }  // read by the last load()
+    QStringList errors() const { return m_errors; }
+    // Loaded files whose mtime or size no longer match the cache, or that are gone
+    QStringList staleFiles() const;
+
+private:
+    struct Entry {
+        HyprConfigFilePtr file;
+        int line = 0;           // index into file->lines
+        QByteArray expanded;    // set when the line needed expansion
+    };
+
+    HyprConfigFilePtr parsedFile(const QString &path);
+    void walk(const HyprConfigFilePtr &file, int depth);
+    void include(const QString &pattern, const QString &fromDir, int depth);
+    QByteArray expand(QByteArrayView value) const;
+
+    QString m_rootPath;
+    QHash<QString, HyprConfigFilePtr> m_cache;
+    QList<Entry> m_entries;
+    QHash<QByteArray, QByteArray> m_variables;
+    QStringList m_files;
+    QStringList m_reparsedFiles;
+    QStringList m_errors;
+    QSet<QString> m_active;  // files being walked, to stop include cycles
+};
+
+#endif // HYPRCONFIG_H
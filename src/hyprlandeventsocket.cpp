@@ -0,0 +1,129 @@
+#include "hyprlandeventsocket.h"
+#include "hyprlandipc.h"
+#include <QSocketNotifier>
+#include <QDebug>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+QList<QByteArray> LineFramer::feed(const QByteArray &chunk)
+{
+    QList<QByteArray> lines;
+    m_pending.append(chunk);
+    
+    qsizetype start = 0;
+    qsizetype newline;
+    while ((newline = m_pending.indexOf('\n', start)) >= 0) {
+        if (newline > start) {
+            lines.append(m_pending.mid(start, newline - start));
+        }
+        start = newline + 1;
+    }
+    m_pending.remove(0, start);
+    return lines;
+}
+
+HyprlandEventSocket::HyprlandEventSocket(QObject *parent)
+    : QObject(parent)
+    , m_fd(-1)
+    , m_notifier(nullptr)
+{
+}
+
+HyprlandEventSocket::~HyprlandEventSocket()
+{
+    close();
+}
+
+bool HyprlandEventSocket::open()
+{
+    if (isOpen()) {
+        return true;
+    }
+    
+    const QByteArray path = HyprlandIpc::eventSocketPath().toLocal8Bit();
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.isEmpty() || static_cast<size_t>(path.size()) >= sizeof(addr.sun_path)) {
+        qWarning() << "Hyprland event socket path unavailable";
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.constData(), path.size());
+    
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        qWarning() << "Failed to create event socket:" << std::strerror(errno);
+        return false;
+    }
+    
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+        qWarning() << "Failed to connect to" << path << ":" << std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    
+    m_fd = fd;
+    m_framer.clear();
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &HyprlandEventSocket::onReadyRead);
+    qInfo() << "Subscribed to Hyprland events on" << path;
+    return true;
+}
+
+void HyprlandEventSocket::close()
+{
+    if (m_notifier) {
+        m_notifier->setEnabled(false);
+        m_notifier->deleteLater();
+        m_notifier = nullptr;
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    m_framer.clear();
+}
+
+bool HyprlandEventSocket::isOpen() const
+{
+    return m_fd >= 0;
+}
+
+void HyprlandEventSocket::onReadyRead()
+{
+    char buffer[4096];
+    for (;;) {
+        ssize_t n = ::read(m_fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            const QList<QByteArray> lines = m_framer.feed(QByteArray(buffer, n));
+            for (const QByteArray &line : lines) {
+                qsizetype sep = line.indexOf(">>");
+                if (sep < 0) {
+                    continue;
+                }
+                emit eventReceived(QString::fromUtf8(line.left(sep)),
+                                   QString::fromUtf8(line.mid(sep + 2)));
+                // A receiver may have closed us while handling the event
+                if (m_fd < 0) {
+                    return;
+                }
+            }
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        }
+        
+        // EOF or hard error: the compositor went away
+        qWarning() << "Hyprland event socket closed";
+        close();
+        emit disconnected();
+        return;
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef HYPRLANDEVENTSOCKET_H
+#define HYPRLANDEVENTSOCKET_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+class QSocketNotifier;
+
+// Splits a byte stream into '\n' terminated lines, keeping any trailing
+// partial line until the next chunk completes it.
+class LineFramer
+{
+public:
+    QList<QByteArray> feed(const QByteArray &chunk);
+    void clear() { m_pending.clear(); }
+    qsizetype pendingSize() const { return m_pending.size(); }
+
+private:
+    QByteArray m_pending;
+};
+
+// Subscribes to Hyprland's event socket (.socket2.sock) and emits one
+// signal per "EVENT>>DATA" line.
+class HyprlandEventSocket : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HyprlandEventSocket(QObject *parent = nullptr);
+    ~HyprlandEventSocket();
+
+    bool open();
+    void close();
+    bool isOpen() const;
+
+signals:
+    void eventReceived(const QString &name, const QString &data);
+    void disconnected();
+
+private slots:
+    void onReadyRead();
+
+private:
+    int m_fd;
+    QSocketNotifier *m_notifier;
+    LineFramer m_framer;
+};
+
+#endif // HYPRLANDEVENTSOCKET_H
@@ -1,11 +1,16 @@
 #include "hyprlandinterface.h"
-#include <QProcess>
+#include "hyprlandipc.h"
+#include "hyprlandeventsocket.h"
+#include "ipcexecutor.h"
+#include "applyplanner.h"
+#include "monitorstatestore.h"
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QFile>
+#include <QFileInfo>
 #include <QTextStream>
 #include <QDebug>
 #include <QDir>
@@ -16,41 +21,25 @@ HyprlandInterface::HyprlandInterface(QObject *parent)
     , m_isConnected(false)
     , m_isHyprlandRunning(false)
     , m_isEventMonitoring(false)
-    , m_hyprctlProcess(nullptr)
-    , m_eventProcess(nullptr)
-    , m_commandProcess(nullptr)
-    , m_eventTimer(nullptr)
+    , m_connectionPolling(true)
+    , m_eventSocket(nullptr)
     , m_connectionTimer(nullptr)
     , m_reconnectTimer(nullptr)
+    , m_monitorStore(nullptr)
     , m_reconnectInterval(5000)
-    , m_eventInterval(1000)
     , m_maxRetries(3)
     , m_currentRetries(0)
-    , m_isProcessingCommands(false)
+    , m_statusProbeId(0)
+    , m_commandInFlight(false)
+    , m_nextCommandId(0)
     , m_enableLogging(false)
     , m_logFile(nullptr)
     , m_logStream(nullptr)
 {
     qInfo() << "HyprlandInterface constructor started";
-    try {
-        // Initialize processes
-        qInfo() << "Creating QProcess objects...";
-        m_hyprctlProcess = new QProcess(this);
-        m_eventProcess = new QProcess(this);
-        m_commandProcess = new QProcess(this);
-        qInfo() << "QProcess objects created";
-    } catch (const std::exception& e) {
-        qCritical() << "Failed to create QProcess objects:" << e.what();
-        throw;
-    } catch (...) {
-        qCritical() << "Unknown error creating QProcess objects";
-        throw;
-    }
-    
     try {
         // Initialize timers
         qInfo() << "Creating QTimer objects...";
-        m_eventTimer = new QTimer(this);
         m_connectionTimer = new QTimer(this);
         m_reconnectTimer = new QTimer(this);
         qInfo() << "QTimer objects created";
@@ -62,7 +51,6 @@ HyprlandInterface::HyprlandInterface(QObject *parent)
         throw;
     }
     
-    m_eventTimer->setInterval(m_eventInterval);
     m_connectionTimer->setInterval(10000); // Check connection every 10 seconds
     m_reconnectTimer->setInterval(m_reconnectInterval);
     
@@ -73,43 +61,16 @@ HyprlandInterface::HyprlandInterface(QObject *parent)
     m_monitorsPath = QDir::homePath() + "/.config/hypr/monitors.conf";
     qDebug() << "Paths set up";
     
-    // Setup regular expressions
-    qDebug() << "Setting up regular expressions...";
-    m_monitorEventRegex = QRegularExpression(R"(monitoradded|monitorremoved|monitorchanged)");
-    m_workspaceEventRegex = QRegularExpression(R"(workspace|workspaceadded|workspaceremoved)");
-    m_configEventRegex = QRegularExpression(R"(configreloaded)");
-    qDebug() << "Regular expressions set up";
-    
-    // Connect signals
-    qDebug() << "Connecting process signals...";
-    connect(m_hyprctlProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, &HyprlandInterface::onProcessFinished);
-    connect(m_hyprctlProcess, &QProcess::errorOccurred, this, &HyprlandInterface::onProcessError);
+    // Setup event socket
+    m_eventSocket = new HyprlandEventSocket(this);
+    connect(m_eventSocket, &HyprlandEventSocket::eventReceived, this, &HyprlandInterface::onHyprlandEvent);
+    connect(m_eventSocket, &HyprlandEventSocket::disconnected, this, &HyprlandInterface::onEventSocketDisconnected);
     
-    connect(m_eventProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, &HyprlandInterface::onProcessFinished);
-    connect(m_eventProcess, &QProcess::errorOccurred, this, &HyprlandInterface::onProcessError);
-    connect(m_eventProcess, &QProcess::readyReadStandardOutput, this, &HyprlandInterface::onProcessOutput);
-    qDebug() << "Event process signals connected";
-    
-    connect(m_commandProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, &HyprlandInterface::onProcessFinished);
-    connect(m_commandProcess, &QProcess::errorOccurred, this, &HyprlandInterface::onProcessError);
-    qDebug() << "Command process signals connected";
-    
-    connect(m_eventTimer, &QTimer::timeout, this, &HyprlandInterface::onEventTimerTimeout);
     connect(m_connectionTimer, &QTimer::timeout, this, &HyprlandInterface::onConnectionTimerTimeout);
     connect(m_reconnectTimer, &QTimer::timeout, this, &HyprlandInterface::onReconnectTimerTimeout);
     qDebug() << "Timer signals connected";
     
-    // Start connection monitoring
-    qDebug() << "Starting connection monitoring...";
-    m_connectionTimer->start();
-    qDebug() << "Connection timer started";
-    
-    // Initial connection check with safety delay
-    qDebug() << "Scheduling initial connection check...";
-    QTimer::singleShot(100, this, &HyprlandInterface::updateConnectionStatus);
+    // Connection monitoring starts with event monitoring, once the owner has chosen whether to poll
     qDebug() << "HyprlandInterface constructor completed";
 }
 
@@ -117,16 +78,6 @@ HyprlandInterface::~HyprlandInterface()
 {
     stopEventMonitoring();
     
-    if (m_hyprctlProcess) {
-        m_hyprctlProcess->kill();
-    }
-    if (m_eventProcess) {
-        m_eventProcess->kill();
-    }
-    if (m_commandProcess) {
-        m_commandProcess->kill();
-    }
-    
     if (m_logFile) {
         m_logFile->close();
         delete m_logFile;
@@ -143,10 +94,32 @@ bool HyprlandInterface::isConnected() const
     return m_isConnected;
 }
 
+void HyprlandInterface::setConnectionPolling(bool enabled)
+{
+    m_connectionPolling = enabled;
+    if (enabled) {
+        if (m_isEventMonitoring) m_connectionTimer->start();
+        return;
+    }
+    m_connectionTimer->stop();
+    m_reconnectTimer->stop();
+    if (m_eventSocket->isOpen()) {
+        setConnectionStatus(true);
+    }
+}
+
+void HyprlandInterface::setMonitorStore(const MonitorStateStore *store)
+{
+    m_monitorStore = store;
+}
+
 QStringList HyprlandInterface::getMonitors() const
 {
     QStringList names;
-    for (const DisplayInfo &monitor : m_monitors) {
+    if (!m_monitorStore) {
+        return names;
+    }
+    for (const DisplayInfo &monitor : m_monitorStore->snapshot()->displays) {
         names.append(monitor.name);
     }
     return names;
@@ -154,12 +127,12 @@ QStringList HyprlandInterface::getMonitors() const
 
 DisplayInfo HyprlandInterface::getMonitorInfo(const QString &name) const
 {
-    for (const DisplayInfo &monitor : m_monitors) {
-        if (monitor.name == name) {
-            return monitor;
-        }
+    if (!m_monitorStore) {
+        return DisplayInfo();
     }
-    return DisplayInfo();
+    MonitorSnapshotPtr current = m_monitorStore->snapshot();
+    const DisplayInfo *monitor = current->find(name);
+    return monitor ? *monitor : DisplayInfo();
 }
 
 bool HyprlandInterface::setMonitor(const DisplayInfo &monitor)
@@ -168,74 +141,90 @@ bool HyprlandInterface::setMonitor(const DisplayInfo &monitor)
         return false;
     }
     
-    QString command = buildMonitorCommand(monitor);
-    if (command.isEmpty()) {
-        emit error("Failed to build monitor command");
-        return false;
-    }
-    
-    return executeCommandAsync({"dispatch", "keyword", command});
+    // "keyword monitor <rule>"; the rule itself contains no spaces
+    return executeCommandAsync(ApplyPlanner::buildMonitorCommand(monitor).split(' '));
 }
 
 bool HyprlandInterface::removeMonitor(const QString &name)
 {
-    return executeCommandAsync({"dispatch", "keyword", QString("monitor,%1,disable").arg(name)});
+    return executeCommandAsync({"keyword", "monitor", QString("%1,disable").arg(name)});
 }
 
 bool HyprlandInterface::moveMonitor(const QString &name, int x, int y)
 {
-    QString command = QString("monitor,%1,addreserved,%2,%3,%4,%5")
-                     .arg(name).arg(x).arg(y).arg(0).arg(0);
-    return executeCommandAsync({"dispatch", "keyword", command});
+    return updateMonitor(name, [x, y](DisplayInfo &monitor) {
+        monitor.x = x;
+        monitor.y = y;
+    });
 }
 
 bool HyprlandInterface::resizeMonitor(const QString &name, int width, int height)
 {
-    QString command = QString("monitor,%1,%2x%3")
-                     .arg(name).arg(width).arg(height);
-    return executeCommandAsync({"dispatch", "keyword", command});
+    return updateMonitor(name, [width, height](DisplayInfo &monitor) {
+        monitor.width = width;
+        monitor.height = height;
+    });
 }
 
 bool HyprlandInterface::scaleMonitor(const QString &name, double scale)
 {
-    QString command = QString("monitor,%1,scale,%2")
-                     .arg(name).arg(scale);
-    return executeCommandAsync({"dispatch", "keyword", command});
+    return updateMonitor(name, [scale](DisplayInfo &monitor) {
+        monitor.scale = scale;
+    });
 }
 
 bool HyprlandInterface::transformMonitor(const QString &name, const QString &transform)
 {
-    QString command = QString("monitor,%1,transform,%2")
-                     .arg(name).arg(transform);
-    return executeCommandAsync({"dispatch", "keyword", command});
+    bool ok = false;
+    DisplayTransform value = DisplayInfo::parseTransform(transform, &ok);
+    if (!ok) {
+        emit error(QString("Invalid transform: %1").arg(transform));
+        return false;
+    }
+    return updateMonitor(name, [value](DisplayInfo &monitor) {
+        monitor.transform = value;
+    });
 }
 
 bool HyprlandInterface::mirrorMonitor(const QString &name, const QString &mirrorOf)
 {
-    QString command = QString("monitor,%1,mirror,%2")
-                     .arg(name).arg(mirrorOf);
-    return executeCommandAsync({"dispatch", "keyword", command});
+    return updateMonitor(name, [mirrorOf](DisplayInfo &monitor) {
+        monitor.mirrorOf = mirrorOf;
+    });
 }
 
 bool HyprlandInterface::unmirrorMonitor(const QString &name)
 {
-    QString command = QString("monitor,%1,unmirror")
-                     .arg(name);
-    return executeCommandAsync({"dispatch", "keyword", command});
+    return updateMonitor(name, [](DisplayInfo &monitor) {
+        monitor.mirrorOf.clear();
+    });
 }
 
 bool HyprlandInterface::setPrimaryMonitor(const QString &name)
 {
-    QString command = QString("monitor,%1,primary")
-                     .arg(name);
-    return executeCommandAsync({"dispatch", "keyword", command});
+    // Hyprland has no primary output; focusing the monitor is the closest equivalent
+    return executeCommandAsync({"dispatch", "focusmonitor", name});
 }
 
 bool HyprlandInterface::enableMonitor(const QString &name, bool enabled)
 {
-    QString command = QString("monitor,%1,%2")
-                     .arg(name).arg(enabled ? "enable" : "disable");
-    return executeCommandAsync({"dispatch", "keyword", command});
+    if (!enabled) {
+        return removeMonitor(name);
+    }
+    return updateMonitor(name, [](DisplayInfo &monitor) {
+        monitor.setEnabled(true);
+    });
+}
+
+bool HyprlandInterface::updateMonitor(const QString &name, const std::function<void(DisplayInfo &)> &change)
+{
+    DisplayInfo monitor = getMonitorInfo(name);
+    if (monitor.name.isEmpty()) {
+        emit error(QString("Unknown monitor: %1").arg(name));
+        return false;
+    }
+    change(monitor);
+    return setMonitor(monitor);
 }
 
 QStringList HyprlandInterface::getWorkspaces() const
@@ -245,30 +234,24 @@ QStringList HyprlandInterface::getWorkspaces() const
 
 bool HyprlandInterface::moveWorkspaceToMonitor(const QString &workspace, const QString &monitor)
 {
-    QString command = QString("workspace,%1,monitor,%2")
-                     .arg(workspace).arg(monitor);
-    return executeCommandAsync({"dispatch", "keyword", command});
+    return executeCommandAsync({"dispatch", "moveworkspacetomonitor", workspace, monitor});
 }
 
 bool HyprlandInterface::createWorkspace(const QString &name)
 {
-    QString command = QString("workspace,%1,add")
-                     .arg(name);
-    return executeCommandAsync({"dispatch", "keyword", command});
+    QString rule = QString("name:%1,persistent:true").arg(name);
+    return executeCommandAsync({"keyword", "workspace", rule});
 }
 
 bool HyprlandInterface::removeWorkspace(const QString &name)
 {
-    QString command = QString("workspace,%1,remove")
-                     .arg(name);
-    return executeCommandAsync({"dispatch", "keyword", command});
+    QString rule = QString("name:%1,persistent:false").arg(name);
+    return executeCommandAsync({"keyword", "workspace", rule});
 }
 
 bool HyprlandInterface::renameWorkspace(const QString &oldName, const QString &newName)
 {
-    QString command = QString("workspace,%1,rename,%2")
-                     .arg(oldName).arg(newName);
-    return executeCommandAsync({"dispatch", "keyword", command});
+    return executeCommandAsync({"dispatch", "renameworkspace", oldName, newName});
 }
 
 bool HyprlandInterface::reloadConfiguration()
@@ -302,38 +285,104 @@ QString HyprlandInterface::getWorkspacesPath() const
 
 QString HyprlandInterface::executeCommand(const QStringList &args)
 {
-    if (!m_hyprctlProcess) {
-        logError("hyprctl process not initialized");
+    logCommand(args);
+    HyprlandReply reply = HyprlandIpc::hyprctl(args);
+    if (!reply.ok) {
+        logError(QString("Command failed: %1 (%2)").arg(args.join(' '), reply.error));
         return QString();
     }
     
-    m_hyprctlProcess->start("hyprctl", args);
+    QString output = QString::fromUtf8(reply.data);
+    logOutput(output);
+    return output;
+}
+
+bool HyprlandInterface::executeCommandAsync(const QStringList &args)
+{
+    return enqueueCommand(args) != 0;
+}
+
+quint64 HyprlandInterface::enqueueCommand(const QStringList &args)
+{
+    const QString command = args.join(' ');
+    QString monitor;
+    if (command.startsWith("keyword monitor ")) {
+        monitor = command.mid(16).section(',', 0, 0).trimmed();
+    }
     
-    if (!m_hyprctlProcess->waitForFinished(5000)) {
-        logError(QString("Command timed out: %1").arg(args.join(' ')));
-        m_hyprctlProcess->kill();
-        return QString();
+    quint64 id = ++m_nextCommandId;
+    
+    // A newer rule for the same monitor replaces one that has not been sent yet.
+    // Rules for other monitors may sit in between; any other command keeps its place
+    // in the order, so the search stops there.
+    if (!monitor.isEmpty()) {
+        for (int i = m_commandQueue.size() - 1; i >= 0 && !m_commandQueue.at(i).monitor.isEmpty(); --i) {
+            PendingCommand &pending = m_commandQueue[i];
+            if (pending.monitor == monitor) {
+                qDebug() << "Coalescing monitor rule for" << monitor << "into command" << pending.ids.first();
+                pending.args = args;
+                pending.ids.append(id);
+                return id;
+            }
+        }
     }
     
-    if (m_hyprctlProcess->exitCode() != 0) {
-        logError(QString("Command failed: %1").arg(args.join(' ')));
-        return QString();
+    if (m_commandQueue.size() >= MaxQueuedCommands) {
+        logError(QString("Command queue full, dropping: %1").arg(command));
+        emit error(QString("Too many pending Hyprland commands, dropped: %1").arg(command));
+        return 0;
     }
     
-    QString output = QString::fromUtf8(m_hyprctlProcess->readAllStandardOutput());
-    logOutput(output);
-    return output;
+    logCommand(args);
+    m_commandQueue.append({{id}, args, monitor});
+    dispatchCommands();
+    return id;
 }
 
-bool HyprlandInterface::executeCommandAsync(const QStringList &args)
+int HyprlandInterface::pendingCommandCount() const
 {
-    if (!m_commandProcess) {
-        logError("command process not initialized");
-        return false;
+    return m_commandQueue.size() + (m_commandInFlight ? 1 : 0);
+}
+
+void HyprlandInterface::dispatchCommands()
+{
+    // The IPC thread runs one request at a time, so handing over more would
+    // not send them any sooner; they wait here where they can still coalesce
+    if (!m_commandInFlight && !m_commandQueue.isEmpty()) {
+        PendingCommand command = m_commandQueue.takeFirst();
+        m_commandInFlight = true;
+        IpcExecutor::instance()->hyprctl(command.args, this,
+            [this, command](quint64, const HyprlandReply &reply) {
+                onCommandReply(command.ids, command.args, reply);
+            });
+    }
+}
+
+void HyprlandInterface::onCommandReply(const QList<quint64> &ids, const QStringList &args, const HyprlandReply &reply)
+{
+    m_commandInFlight = false;
+    
+    QString output = QString::fromUtf8(reply.data);
+    bool ok = reply.ok;
+    // keyword/dispatch/reload answer "ok"; anything else is an error message
+    const QString verb = args.value(0);
+    if (ok && (verb == "keyword" || verb == "dispatch" || verb == "reload")) {
+        ok = output.trimmed() == "ok";
+    }
+    
+    if (ok) {
+        logOutput(output);
+    } else {
+        QString message = reply.ok ? output.trimmed() : reply.error;
+        logError(QString("Command failed: %1 (%2)").arg(args.join(' '), message));
+        emit error(QString("Hyprland command failed: %1 (%2)").arg(args.join(' '), message));
     }
     
-    m_commandProcess->start("hyprctl", args);
-    return m_commandProcess->waitForStarted(5000);
+    for (quint64 id : ids) {
+        emit commandFinished(id, ok, output);
+    }
+    
+    dispatchCommands();
 }
 
 QString HyprlandInterface::executeHyprctl(const QStringList &args)
@@ -352,9 +401,19 @@ void HyprlandInterface::startEventMonitoring()
         return;
     }
     
-    setupEventMonitoring();
     m_isEventMonitoring = true;
-    m_eventTimer->start();
+    if (m_connectionPolling) {
+        qDebug() << "Starting connection monitoring...";
+        m_connectionTimer->start();
+        // Initial connection check with safety delay
+        QTimer::singleShot(100, this, &HyprlandInterface::updateConnectionStatus);
+    }
+    if (!setupEventMonitoring()) {
+        // Hyprland may not be up yet; try again once the reconnect interval passes
+        QTimer::singleShot(m_reconnectInterval, this, &HyprlandInterface::onEventSocketDisconnected);
+    } else if (!m_connectionPolling) {
+        setConnectionStatus(true);
+    }
 }
 
 void HyprlandInterface::stopEventMonitoring()
@@ -363,9 +422,8 @@ void HyprlandInterface::stopEventMonitoring()
         return;
     }
     
-    cleanupEventMonitoring();
     m_isEventMonitoring = false;
-    m_eventTimer->stop();
+    cleanupEventMonitoring();
 }
 
 bool HyprlandInterface::isEventMonitoring() const
@@ -398,51 +456,30 @@ void HyprlandInterface::onConfigurationChanged()
     emit configurationChanged();
 }
 
-void HyprlandInterface::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+void HyprlandInterface::onHyprlandEvent(const QString &name, const QString &data)
 {
-    Q_UNUSED(exitCode)
-    Q_UNUSED(exitStatus)
-    // Handle process completion
+    parseEventOutput(name, data);
 }
 
-void HyprlandInterface::onProcessError(QProcess::ProcessError error)
+void HyprlandInterface::onEventSocketDisconnected()
 {
-    QString errorMsg;
-    switch (error) {
-        case QProcess::FailedToStart:
-            errorMsg = "Failed to start hyprctl process";
-            break;
-        case QProcess::Crashed:
-            errorMsg = "hyprctl process crashed";
-            break;
-        case QProcess::Timedout:
-            errorMsg = "hyprctl process timed out";
-            break;
-        case QProcess::WriteError:
-            errorMsg = "Write error to hyprctl process";
-            break;
-        case QProcess::ReadError:
-            errorMsg = "Read error from hyprctl process";
-            break;
-        default:
-            errorMsg = "Unknown process error";
-            break;
+    if (!m_isEventMonitoring || m_eventSocket->isOpen()) {
+        return;
     }
-    emit this->error(QString(errorMsg));
-}
-
-void HyprlandInterface::onProcessOutput()
-{
-    QString output = QString::fromUtf8(m_eventProcess->readAllStandardOutput());
-    parseEventOutput(output);
-}
-
-void HyprlandInterface::onEventTimerTimeout()
-{
-    // Check for new events
-    if (m_isEventMonitoring) {
-        // Poll for events if needed
+    
+    if (!setupEventMonitoring()) {
+        if (!m_connectionPolling) {
+            setConnectionStatus(false);
+        }
+        QTimer::singleShot(m_reconnectInterval, this, &HyprlandInterface::onEventSocketDisconnected);
+        return;
     }
+    
+    if (!m_connectionPolling) {
+        setConnectionStatus(true);
+    }
+    // Events may have been missed while we were disconnected
+    emit configurationChanged();
 }
 
 void HyprlandInterface::onConnectionTimerTimeout()
@@ -458,46 +495,50 @@ void HyprlandInterface::onReconnectTimerTimeout()
 void HyprlandInterface::updateConnectionStatus()
 {
     qDebug() << "updateConnectionStatus called";
-    bool wasConnected = m_isConnected;
     
-    // First check if hyprctl executable exists
-    qDebug() << "Checking for hyprctl executable...";
-    QFileInfo hyprctlFile("/usr/bin/hyprctl");
-    if (!hyprctlFile.exists()) {
-        qDebug() << "hyprctl not found in /usr/bin, checking /usr/local/bin";
-        hyprctlFile = QFileInfo("/usr/local/bin/hyprctl");
+    if (m_statusProbeId != 0) {
+        // Previous probe still waiting on the compositor
+        return;
     }
     
-    if (!hyprctlFile.exists()) {
-        // hyprctl not found, don't try to connect
-        m_isHyprlandRunning = false;
-        m_isConnected = false;
-        if (wasConnected) {
-            emit disconnected();
+    // Without the IPC socket we can only probe through hyprctl, so make sure it exists first
+    if (!HyprlandIpc::isSocketAvailable()) {
+        qDebug() << "Hyprland socket not found, checking for hyprctl executable...";
+        QFileInfo hyprctlFile("/usr/bin/hyprctl");
+        if (!hyprctlFile.exists()) {
+            qDebug() << "hyprctl not found in /usr/bin, checking /usr/local/bin";
+            hyprctlFile = QFileInfo("/usr/local/bin/hyprctl");
+        }
+        
+        if (!hyprctlFile.exists()) {
+            // hyprctl not found, don't try to connect
+            setConnectionStatus(false);
+            return;
         }
-        return;
     }
     
-    // Check if hyprctl is available and working
-    QProcess testProcess;
-    testProcess.start("hyprctl", {"version"});
-    
-    // Use a shorter timeout and handle process errors
-    if (!testProcess.waitForFinished(1000)) {
-        testProcess.kill();
-        m_isHyprlandRunning = false;
-        m_isConnected = false;
-    } else {
-        m_isHyprlandRunning = (testProcess.exitCode() == 0);
-        m_isConnected = m_isHyprlandRunning;
-    }
+    // Probe on the IPC thread so an unresponsive compositor doesn't stall the UI
+    m_statusProbeId = IpcExecutor::instance()->hyprctl({"version"}, this,
+        [this](quint64, const HyprlandReply &reply) {
+            m_statusProbeId = 0;
+            setConnectionStatus(reply.ok);
+        }, 1000);
+}
+
+void HyprlandInterface::setConnectionStatus(bool running)
+{
+    bool wasConnected = m_isConnected;
+    m_isHyprlandRunning = running;
+    m_isConnected = running;
     
     if (m_isConnected && !wasConnected) {
-        emit connected();
+        m_reconnectTimer->stop();
         m_currentRetries = 0;
+        emit connected();
     } else if (!m_isConnected && wasConnected) {
         emit disconnected();
-        if (m_currentRetries < m_maxRetries) {
+        // Without polling the event socket retries on its own
+        if (m_connectionPolling && m_currentRetries < m_maxRetries) {
             m_reconnectTimer->start();
         }
     }
@@ -506,24 +547,20 @@ void HyprlandInterface::updateConnectionStatus()
 void HyprlandInterface::attemptReconnection()
 {
     m_currentRetries++;
-    updateConnectionStatus();
-    
-    if (!m_isConnected && m_currentRetries < m_maxRetries) {
-        m_reconnectTimer->start();
+    if (m_currentRetries >= m_maxRetries) {
+        m_reconnectTimer->stop();
     }
+    updateConnectionStatus();
 }
 
-void HyprlandInterface::setupEventMonitoring()
+bool HyprlandInterface::setupEventMonitoring()
 {
-    // Start hyprctl event monitoring
-    m_eventProcess->start("hyprctl", {"-j", "events"});
+    return m_eventSocket->open();
 }
 
 void HyprlandInterface::cleanupEventMonitoring()
 {
-    if (m_eventProcess->state() != QProcess::NotRunning) {
-        m_eventProcess->kill();
-    }
+    m_eventSocket->close();
 }
 
 bool HyprlandInterface::validateMonitorSettings(const DisplayInfo &monitor)
@@ -561,28 +598,6 @@ bool HyprlandInterface::validateWorkspaceSettings(const QString &workspace)
     return true;
 }
 
-QString HyprlandInterface::buildMonitorCommand(const DisplayInfo &monitor)
-{
-    QString command = QString("monitor,%1,%2x%3@%4,%5x%6,%7")
-                     .arg(monitor.name)
-                     .arg(monitor.width)
-                     .arg(monitor.height)
-                     .arg(monitor.refreshRate)
-                     .arg(monitor.x)
-                     .arg(monitor.y)
-                     .arg(monitor.scale);
-    
-    if (!monitor.transform.isEmpty() && monitor.transform != "normal") {
-        command += QString(",%1").arg(monitor.transform);
-    }
-    
-    if (!monitor.mirrorOf.isEmpty()) {
-        command += QString(",mirror,%1").arg(monitor.mirrorOf);
-    }
-    
-    return command;
-}
-
 QString HyprlandInterface::buildWorkspaceCommand(const QString &workspace, const QString &monitor)
 {
     return QString("workspace,%1,monitor,%2").arg(workspace).arg(monitor);
@@ -633,9 +648,34 @@ bool HyprlandInterface::parseDeviceOutput(const QString &output)
     return true;
 }
 
-bool HyprlandInterface::parseEventOutput(const QString &output)
-{
-    Q_UNUSED(output)
-    // TODO: Implement event output parsing
+bool HyprlandInterface::parseEventOutput(const QString &name, const QString &data)
+{
+    logOutput(QString("EVENT %1>>%2").arg(name, data));
+    
+    // v2 variants carry the same information as the plain events, which Hyprland
+    // always sends alongside them, so only the plain ones are handled here
+    if (name == "monitoradded") {
+        onMonitorAdded(data);
+    } else if (name == "monitorremoved") {
+        onMonitorRemoved(data);
+    } else if (name == "focusedmon") {
+        // focusedmon>>MONITOR,WORKSPACE
+        emit monitorFocused(data.section(',', 0, 0), data.section(',', 1));
+        onMonitorChanged(data.section(',', 0, 0));
+    } else if (name == "moveworkspace") {
+        // moveworkspace>>WORKSPACE,MONITOR
+        onWorkspaceChanged(data.section(',', 0, 0));
+        onMonitorChanged(data.section(',', 1));
+    } else if (name == "workspace") {
+        // workspace>>NAME, the active workspace of the focused monitor
+        emit activeWorkspaceChanged(data);
+        onWorkspaceChanged(data);
+    } else if (name == "createworkspace" || name == "destroyworkspace" || name == "renameworkspace") {
+        onWorkspaceChanged(data.section(',', 0, 0));
+    } else if (name == "configreloaded") {
+        onConfigurationChanged();
+    } else {
+        return false;
+    }
     return true;
 } 
\ No newline at end of file
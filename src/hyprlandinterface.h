@@ -2,7 +2,6 @@
 #define HYPRLANDINTERFACE_H
 
 #include <QObject>
-#include <QProcess>
 #include <QTimer>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -15,11 +14,13 @@
 #include <QFile>
 #include <QTextStream>
 #include <QStandardPaths>
-#include <QApplication>
-#include <QScreen>
-#include <QWindow>
+#include <functional>
 
 #include "displaymanager.h"
+#include "hyprlandipc.h"
+
+class HyprlandEventSocket;
+class MonitorStateStore;
 
 class HyprlandInterface : public QObject
 {
@@ -31,8 +32,15 @@ public:
 
     bool isHyprlandRunning() const;
     bool isConnected() const;
+    // On by default: hyprctl version every 10 s from startEventMonitoring() on.
+    // Off, the connection state follows the event socket instead and nothing
+    // runs while Hyprland is idle. Set it before startEventMonitoring().
+    void setConnectionPolling(bool enabled);
+    bool isConnectionPolling() const { return m_connectionPolling; }
     
     // Monitor management
+    // Monitor queries read the store owned by DisplayManager instead of a private copy
+    void setMonitorStore(const MonitorStateStore *store);
     QStringList getMonitors() const;
     DisplayInfo getMonitorInfo(const QString &name) const;
     bool setMonitor(const DisplayInfo &monitor);
@@ -61,6 +69,10 @@ public:
     QString getWorkspacesPath() const;
     
     // Commands
+    // Queues a hyprctl command behind the ones already pending and returns its
+    // id, or 0 when the queue is full. Completion is reported via commandFinished().
+    quint64 enqueueCommand(const QStringList &args);
+    int pendingCommandCount() const;
     QString executeCommand(const QStringList &args);
     bool executeCommandAsync(const QStringList &args);
     QString executeHyprctl(const QStringList &args);
@@ -77,9 +89,6 @@ public slots:
     void onMonitorChanged(const QString &name);
     void onWorkspaceChanged(const QString &name);
     void onConfigurationChanged();
-    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
-    void onProcessError(QProcess::ProcessError error);
-    void onProcessOutput();
 
 signals:
     void connected();
@@ -88,12 +97,17 @@ signals:
     void monitorRemoved(const QString &name);
     void monitorChanged(const QString &name);
     void workspaceChanged(const QString &name);
+    // Carry the event data, so nobody needs to ask Hyprland for the monitor list
+    void monitorFocused(const QString &name, const QString &workspace);
+    void activeWorkspaceChanged(const QString &workspace);
     void configurationChanged();
     void error(const QString &message);
     void success(const QString &message);
+    void commandFinished(quint64 id, bool ok, const QString &output);
 
 private slots:
-    void onEventTimerTimeout();
+    void onHyprlandEvent(const QString &name, const QString &data);
+    void onEventSocketDisconnected();
     void onConnectionTimerTimeout();
     void onReconnectTimerTimeout();
 
@@ -101,17 +115,20 @@ private:
     bool parseMonitorOutput(const QString &output);
     bool parseWorkspaceOutput(const QString &output);
     bool parseDeviceOutput(const QString &output);
-    bool parseEventOutput(const QString &output);
+    bool parseEventOutput(const QString &name, const QString &data);
     
     void updateConnectionStatus();
+    void setConnectionStatus(bool running);
     void attemptReconnection();
-    void setupEventMonitoring();
+    bool setupEventMonitoring();
     void cleanupEventMonitoring();
+    void dispatchCommands();
+    void onCommandReply(const QList<quint64> &ids, const QStringList &args, const HyprlandReply &reply);
+    bool updateMonitor(const QString &name, const std::function<void(DisplayInfo &)> &change);
     
     bool validateMonitorSettings(const DisplayInfo &monitor);
     bool validateWorkspaceSettings(const QString &workspace);
     
-    QString buildMonitorCommand(const DisplayInfo &monitor);
     QString buildWorkspaceCommand(const QString &workspace, const QString &monitor);
     
     void logCommand(const QStringList &args);
@@ -122,19 +139,17 @@ private:
     bool m_isConnected;
     bool m_isHyprlandRunning;
     bool m_isEventMonitoring;
+    bool m_connectionPolling;
     
-    // Processes
-    QProcess *m_hyprctlProcess;
-    QProcess *m_eventProcess;
-    QProcess *m_commandProcess;
+    // Event socket (.socket2.sock)
+    HyprlandEventSocket *m_eventSocket;
     
     // Timers
-    QTimer *m_eventTimer;
     QTimer *m_connectionTimer;
     QTimer *m_reconnectTimer;
     
     // Data
-    QList<DisplayInfo> m_monitors;
+    const MonitorStateStore *m_monitorStore;
     QStringList m_workspaces;
     QJsonObject m_configuration;
     
@@ -145,19 +160,20 @@ private:
     
     // Settings
     int m_reconnectInterval;
-    int m_eventInterval;
     int m_maxRetries;
     int m_currentRetries;
-    
-    // Event monitoring
-    QString m_lastEventOutput;
-    QRegularExpression m_monitorEventRegex;
-    QRegularExpression m_workspaceEventRegex;
-    QRegularExpression m_configEventRegex;
+    quint64 m_statusProbeId;  // in-flight "version" probe, 0 when idle
     
     // Command queue
-    QStringList m_commandQueue;
-    bool m_isProcessingCommands;
+    struct PendingCommand {
+        QList<quint64> ids;     // more than one when later edits were coalesced into it
+        QStringList args;
+        QString monitor;        // target of a "keyword monitor" rule, empty otherwise
+    };
+    static const int MaxQueuedCommands = 64;
+    QList<PendingCommand> m_commandQueue;
+    bool m_commandInFlight;  // the IPC thread runs one request at a time anyway
+    quint64 m_nextCommandId;
     
     // Logging
     bool m_enableLogging;
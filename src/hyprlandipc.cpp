@@ -0,0 +1,244 @@
+#include "hyprlandipc.h"
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QProcess>
+#include <QDebug>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+
+// Closes the descriptor on every return path
+struct SocketGuard {
+    int fd;
+    ~SocketGuard() { if (fd >= 0) ::close(fd); }
+};
+
+bool waitForSocket(int fd, short events, const QDeadlineTimer &deadline)
+{
+    pollfd pfd{fd, events, 0};
+    for (;;) {
+        int timeout = static_cast<int>(qMax<qint64>(0, deadline.remainingTime()));
+        int ret = ::poll(&pfd, 1, timeout);
+        if (ret > 0) return true;
+        if (ret == 0) return false;
+        if (errno != EINTR) return false;
+    }
+}
+
+// Hyprland joins the replies of a batch with this delimiter
+const QByteArray BatchReplyDelimiter("\n\n\n");
+
+} // namespace
+
+bool HyprlandBatchResult::commandSucceeded(int index) const
+{
+    return ok && index >= 0 && index < replies.size() && replies.at(index).trimmed() == "ok";
+}
+
+bool HyprlandBatchResult::allSucceeded() const
+{
+    if (!ok || replies.size() != commands.size()) {
+        return false;
+    }
+    for (int i = 0; i < commands.size(); ++i) {
+        if (!commandSucceeded(i)) return false;
+    }
+    return true;
+}
+
+QString HyprlandIpc::instanceDirectory()
+{
+    const QString signature = qEnvironmentVariable("HYPRLAND_INSTANCE_SIGNATURE");
+    if (signature.isEmpty()) {
+        return QString();
+    }
+
+    // Hyprland >= 0.40 uses $XDG_RUNTIME_DIR/hypr, older releases /tmp/hypr
+    const QString runtimeDir = qEnvironmentVariable("XDG_RUNTIME_DIR");
+    if (!runtimeDir.isEmpty()) {
+        QString dir = runtimeDir + "/hypr/" + signature;
+        if (QFileInfo::exists(dir)) {
+            return dir;
+        }
+    }
+    return "/tmp/hypr/" + signature;
+}
+
+QString HyprlandIpc::requestSocketPath()
+{
+    QString dir = instanceDirectory();
+    return dir.isEmpty() ? QString() : dir + "/.socket.sock";
+}
+
+QString HyprlandIpc::eventSocketPath()
+{
+    QString dir = instanceDirectory();
+    return dir.isEmpty() ? QString() : dir + "/.socket2.sock";
+}
+
+bool HyprlandIpc::isSocketAvailable()
+{
+    QString path = requestSocketPath();
+    return !path.isEmpty() && QFileInfo::exists(path);
+}
+
+HyprlandReply HyprlandIpc::request(const QByteArray &command, int timeoutMs)
+{
+    HyprlandReply reply;
+    reply.viaSocket = true;
+    QElapsedTimer timer;
+    timer.start();
+    QDeadlineTimer deadline(timeoutMs);
+
+    const QByteArray path = requestSocketPath().toLocal8Bit();
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.isEmpty() || static_cast<size_t>(path.size()) >= sizeof(addr.sun_path)) {
+        reply.error = "Invalid Hyprland socket path";
+        return reply;
+    }
+    std::memcpy(addr.sun_path, path.constData(), path.size());
+
+    SocketGuard sock{::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+    if (sock.fd < 0) {
+        reply.error = QString("socket() failed: %1").arg(std::strerror(errno));
+        return reply;
+    }
+
+    if (::connect(sock.fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+        reply.error = QString("Failed to connect to %1: %2")
+                     .arg(QString::fromLocal8Bit(path), std::strerror(errno));
+        return reply;
+    }
+
+    qsizetype written = 0;
+    while (written < command.size()) {
+        ssize_t n = ::write(sock.fd, command.constData() + written, command.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            reply.error = QString("Write to Hyprland socket failed: %1").arg(std::strerror(errno));
+            return reply;
+        }
+        written += n;
+    }
+
+    // Hyprland closes the connection once the reply has been sent
+    char buffer[8192];
+    for (;;) {
+        if (!waitForSocket(sock.fd, POLLIN, deadline)) {
+            reply.error = QString("Hyprland request timed out: %1").arg(QString::fromUtf8(command));
+            return reply;
+        }
+        ssize_t n = ::read(sock.fd, buffer, sizeof(buffer));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            reply.error = QString("Read from Hyprland socket failed: %1").arg(std::strerror(errno));
+            return reply;
+        }
+        if (n == 0) break;
+        reply.data.append(buffer, n);
+    }
+
+    reply.ok = true;
+    reply.elapsedUs = timer.nsecsElapsed() / 1000;
+    return reply;
+}
+
+HyprlandReply HyprlandIpc::hyprctl(const QStringList &args, int timeoutMs)
+{
+    if (isSocketAvailable()) {
+        return request(commandFromArgs(args), timeoutMs);
+    }
+    return runHyprctlProcess(args, timeoutMs);
+}
+
+HyprlandReply HyprlandIpc::runHyprctlProcess(const QStringList &args, int timeoutMs)
+{
+    HyprlandReply reply;
+    QElapsedTimer timer;
+    timer.start();
+
+    QProcess process;
+    process.start("hyprctl", args);
+    if (!process.waitForFinished(timeoutMs)) {
+        process.kill();
+        process.waitForFinished(100);
+        reply.error = QString("hyprctl timed out or failed to start: %1").arg(args.join(' '));
+        return reply;
+    }
+
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        reply.error = QString("hyprctl exited with code %1: %2").arg(process.exitCode()).arg(args.join(' '));
+        return reply;
+    }
+
+    reply.ok = true;
+    reply.data = process.readAllStandardOutput();
+    reply.elapsedUs = timer.nsecsElapsed() / 1000;
+    return reply;
+}
+
+HyprlandBatchResult HyprlandIpc::batch(const QStringList &commands, int timeoutMs)
+{
+    HyprlandBatchResult result;
+    result.commands = commands;
+    if (commands.isEmpty()) {
+        result.ok = true;
+        return result;
+    }
+    
+    HyprlandReply reply;
+    if (isSocketAvailable()) {
+        // Each entry gets an empty flag prefix so arguments containing '/' are left alone
+        QByteArray payload("[[BATCH]]");
+        for (int i = 0; i < commands.size(); ++i) {
+            if (i > 0) payload += ';';
+            payload += '/' + commands.at(i).toUtf8();
+        }
+        reply = request(payload, timeoutMs);
+    } else {
+        reply = runHyprctlProcess({"--batch", commands.join(" ; ")}, timeoutMs);
+    }
+    
+    result.ok = reply.ok;
+    result.error = reply.error;
+    result.elapsedUs = reply.elapsedUs;
+    result.viaSocket = reply.viaSocket;
+    if (!reply.ok) {
+        return result;
+    }
+    
+    qsizetype start = 0;
+    while (result.replies.size() < commands.size() - 1) {
+        qsizetype end = reply.data.indexOf(BatchReplyDelimiter, start);
+        if (end < 0) break;
+        result.replies.append(QString::fromUtf8(reply.data.mid(start, end - start)));
+        start = end + BatchReplyDelimiter.size();
+    }
+    result.replies.append(QString::fromUtf8(reply.data.mid(start)));
+    return result;
+}
+
+QByteArray HyprlandIpc::commandFromArgs(const QStringList &args)
+{
+    // Mirror hyprctl: single-letter flags are sent before the '/' separator
+    QByteArray flags;
+    QStringList words;
+    bool inCommand = false;
+    for (const QString &arg : args) {
+        if (!inCommand && arg.size() == 2 && arg.startsWith('-')) {
+            flags.append(arg.at(1).toLatin1());
+            continue;
+        }
+        inCommand = true;
+        words.append(arg);
+    }
+    return flags + '/' + words.join(' ').toUtf8();
+}
@@ -0,0 +1,53 @@
+#ifndef HYPRLANDIPC_H
+#define HYPRLANDIPC_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+struct HyprlandReply {
+    bool ok = false;
+    QByteArray data;
+    QString error;
+    qint64 elapsedUs = 0;
+    bool viaSocket = false;
+};
+
+struct HyprlandBatchResult {
+    bool ok = false;            // the batch itself was delivered and answered
+    QStringList commands;
+    QStringList replies;        // one reply per command, in order
+    QString error;
+    qint64 elapsedUs = 0;
+    bool viaSocket = false;
+
+    bool commandSucceeded(int index) const;
+    bool allSucceeded() const;
+};
+
+// Talks to Hyprland's request socket (.socket.sock) directly instead of
+// spawning a hyprctl process per call. hyprctl is only used when the socket
+// is missing (e.g. not running inside a Hyprland session).
+class HyprlandIpc
+{
+public:
+    static QString instanceDirectory();
+    static QString requestSocketPath();
+    static QString eventSocketPath();
+    static bool isSocketAvailable();
+
+    // Raw request in Hyprland's wire format, e.g. "j/monitors"
+    static HyprlandReply request(const QByteArray &command, int timeoutMs = 5000);
+
+    // hyprctl-style arguments, e.g. {"-j", "monitors"}
+    static HyprlandReply hyprctl(const QStringList &args, int timeoutMs = 5000);
+    static HyprlandReply runHyprctlProcess(const QStringList &args, int timeoutMs = 5000);
+
+    // Sends several hyprctl commands (e.g. "keyword monitor DP-1,...") in a
+    // single [[BATCH]] round trip and splits the reply per command
+    static HyprlandBatchResult batch(const QStringList &commands, int timeoutMs = 5000);
+
+    static QByteArray commandFromArgs(const QStringList &args);
+};
+
+#endif // HYPRLANDIPC_H
@@ -0,0 +1,87 @@
+#include "ipcexecutor.h"
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <QPointer>
+#include <QDebug>
+
+IpcExecutor *IpcExecutor::instance()
+{
+    static IpcExecutor *executor = nullptr;
+    if (!executor) {
+        executor = new IpcExecutor();
+        // Join the worker before QCoreApplication goes away
+        qAddPostRoutine([]() { executor->shutdown(); });
+    }
+    return executor;
+}
+
+IpcExecutor::IpcExecutor(QObject *parent)
+    : QObject(parent)
+    , m_worker(new QObject)
+    , m_nextId(0)
+    , m_pending(0)
+{
+    m_thread.setObjectName("hyprland-ipc");
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    m_thread.start();
+}
+
+IpcExecutor::~IpcExecutor()
+{
+    shutdown();
+}
+
+void IpcExecutor::shutdown()
+{
+    if (!m_thread.isRunning()) {
+        return;
+    }
+    m_thread.quit();
+    m_thread.wait();
+}
+
+int IpcExecutor::pendingCount() const
+{
+    return m_pending.load();
+}
+
+quint64 IpcExecutor::submit(std::function<void(quint64)> job)
+{
+    quint64 id = ++m_nextId;
+    if (!m_thread.isRunning()) {
+        qWarning() << "IPC executor stopped, dropping request" << id;
+        return 0;
+    }
+    m_pending.fetch_add(1);
+    QMetaObject::invokeMethod(m_worker, [this, job, id]() {
+        job(id);
+        m_pending.fetch_sub(1);
+    }, Qt::QueuedConnection);
+    return id;
+}
+
+quint64 IpcExecutor::hyprctl(const QStringList &args, QObject *context, ReplyCallback callback,
+                             int timeoutMs)
+{
+    QPointer<QObject> target(context);
+    return submit([this, args, target, callback, timeoutMs](quint64 id) {
+        HyprlandReply reply = HyprlandIpc::hyprctl(args, timeoutMs);
+        // Hop back to the executor's thread before touching the context
+        QMetaObject::invokeMethod(this, [target, callback, id, reply]() {
+            if (target) callback(id, reply);
+        }, Qt::QueuedConnection);
+    });
+}
+
+quint64 IpcExecutor::batch(const QStringList &commands, QObject *context, BatchCallback callback,
+                           int timeoutMs)
+{
+    QPointer<QObject> target(context);
+    return submit([this, commands, target, callback, timeoutMs](quint64 id) {
+        HyprlandBatchResult result = HyprlandIpc::batch(commands, timeoutMs);
+        QMetaObject::invokeMethod(this, [target, callback, id, result]() {
+            if (target) callback(id, result);
+        }, Qt::QueuedConnection);
+    });
+}
@@ -0,0 +1,46 @@
+#ifndef IPCEXECUTOR_H
+#define IPCEXECUTOR_H
+
+#include <QObject>
+#include <QThread>
+#include <QStringList>
+#include <atomic>
+#include <functional>
+
+#include "hyprlandipc.h"
+
+// Runs Hyprland requests on a dedicated worker thread so a busy compositor
+// never blocks the GUI. Requests are executed in submission order; each call
+// returns a request id and the callback is invoked with that id on the thread
+// that created the executor (the GUI thread). If the context object is
+// destroyed before the reply arrives, the callback is skipped.
+class IpcExecutor : public QObject
+{
+    Q_OBJECT
+
+public:
+    using ReplyCallback = std::function<void(quint64 id, const HyprlandReply &reply)>;
+    using BatchCallback = std::function<void(quint64 id, const HyprlandBatchResult &result)>;
+
+    static IpcExecutor *instance();
+    ~IpcExecutor();
+
+    quint64 hyprctl(const QStringList &args, QObject *context, ReplyCallback callback,
+                    int timeoutMs = 5000);
+    quint64 batch(const QStringList &commands, QObject *context, BatchCallback callback,
+                  int timeoutMs = 5000);
+
+    int pendingCount() const;
+    void shutdown();
+
+private:
+    explicit IpcExecutor(QObject *parent = nullptr);
+    quint64 submit(std::function<void(quint64)> job);
+
+    QThread m_thread;
+    QObject *m_worker;
+    std::atomic<quint64> m_nextId;
+    std::atomic<int> m_pending;
+};
+
+#endif // IPCEXECUTOR_H
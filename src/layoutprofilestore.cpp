@@ -0,0 +1,268 @@
+#include "layoutprofilestore.h"
+#include <QCborStreamReader>
+#include <QCborStreamWriter>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+
+namespace {
+
+// The parts of DisplayInfo::flags that belong to a layout; capabilities come from the live monitor
+const DisplayFlags LayoutFlags = DisplayFlag::Enabled | DisplayFlag::Primary | DisplayFlag::Hdr
+                               | DisplayFlag::TenBit | DisplayFlag::WideGamut;
+
+void copyLayout(const DisplayInfo &saved, DisplayInfo &live)
+{
+    live.width = saved.width;
+    live.height = saved.height;
+    live.refreshRate = saved.refreshRate;
+    live.x = saved.x;
+    live.y = saved.y;
+    live.scale = saved.scale;
+    live.transform = saved.transform;
+    live.mirrorOf = saved.mirrorOf;
+    live.vrrMode = saved.vrrMode;
+    live.sdrBrightness = saved.sdrBrightness;
+    live.sdrSaturation = saved.sdrSaturation;
+    live.flags = (live.flags & ~LayoutFlags) | (saved.flags & LayoutFlags);
+}
+
+}
+
+bool LayoutProfile::applyTo(QList<DisplayInfo> &live) const
+{
+    // Two identical monitors without serials share an identity, so prefer
+    // the entry that was also on the same connector
+    QList<bool> used(displays.size(), false);
+    bool complete = true;
+    for (DisplayInfo &display : live) {
+        const QString identity = LayoutProfileStore::identity(display);
+        int match = -1;
+        for (int i = 0; i < displays.size(); ++i) {
+            if (used.at(i) || LayoutProfileStore::identity(displays.at(i)) != identity) continue;
+            if (match < 0 || displays.at(i).name == display.name) match = i;
+            if (displays.at(i).name == display.name) break;
+        }
+        if (match < 0) {
+            complete = false;
+            continue;
+        }
+        used[match] = true;
+        copyLayout(displays.at(match), display);
+    }
+    return complete;
+}
+
+QString LayoutProfileStore::identity(const DisplayInfo &display)
+{
+    return display.manufacturer + '|' + display.model + '|' + display.serial;
+}
+
+QString LayoutProfileStore::fingerprint(const QList<DisplayInfo> &displays)
+{
+    QStringList identities;
+    identities.reserve(displays.size());
+    for (const DisplayInfo &display : displays) {
+        identities.append(identity(display));
+    }
+    identities.sort();
+    return QString::fromLatin1(QCryptographicHash::hash(identities.join('\n').toUtf8(),
+                                                        QCryptographicHash::Sha1).toHex());
+}
+
+QString LayoutProfileStore::defaultPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::ConfigLocation) + "/HyprDisplays/profiles.json";
+}
+
+const LayoutProfile *LayoutProfileStore::find(const QString &fingerprint) const
+{
+    auto it = m_profiles.constFind(fingerprint);
+    return it != m_profiles.constEnd() ? &it.value() : nullptr;
+}
+
+const LayoutProfile *LayoutProfileStore::resolve(const QString &wanted, const QList<DisplayInfo> &displays,
+                                                 QString *error) const
+{
+    // "auto" is what the hotplug handler does: the layout saved for these monitors
+    if (wanted == QLatin1String("auto")) {
+        const LayoutProfile *profile = find(fingerprint(displays));
+        if (!profile && error) *error = "No saved layout for the connected monitors";
+        return profile;
+    }
+    QStringList matches;
+    for (auto it = m_profiles.constBegin(); it != m_profiles.constEnd() && !wanted.isEmpty(); ++it) {
+        if (it.key().startsWith(wanted)) matches.append(it.key());
+    }
+    if (matches.size() > 1) {
+        if (error) *error = QString("Profile %1 is ambiguous, %2 profiles start with it").arg(wanted).arg(matches.size());
+        return nullptr;
+    }
+    if (matches.isEmpty()) {
+        if (error) *error = QString("No saved layout %1").arg(wanted);
+        return nullptr;
+    }
+    return find(matches.first());
+}
+
+QString LayoutProfileStore::remember(const QList<DisplayInfo> &displays)
+{
+    LayoutProfile profile;
+    profile.fingerprint = fingerprint(displays);
+    profile.updated = QDateTime::currentDateTimeUtc();
+    profile.displays = displays;
+    for (DisplayInfo &display : profile.displays) {
+        // Capabilities are read from the live monitor on every apply
+        display.availableModes.clear();
+        display.modeTable.reset();
+    }
+    m_profiles.insert(profile.fingerprint, profile);
+    return profile.fingerprint;
+}
+
+bool LayoutProfileStore::load(const QString &path, QString *error)
+{
+    m_profiles.clear();
+    QFile file(path);
+    if (!file.exists()) {
+        return true;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    return decode(file.readAll(), error);
+}
+
+bool LayoutProfileStore::save(const QString &path, QString *error, SnapshotFormat::Format format) const
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    const QByteArray data = encode(format);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+QByteArray LayoutProfileStore::encode(SnapshotFormat::Format format) const
+{
+    if (format == SnapshotFormat::Cbor) {
+        QByteArray data;
+        QCborStreamWriter writer(&data);
+        SnapshotFormat::beginDocument(writer, "profiles");
+        writer.append("profiles");
+        writer.startArray(m_profiles.size());
+        for (const LayoutProfile &profile : m_profiles) {
+            writer.startMap(3);
+            writer.append("fingerprint");
+            writer.append(profile.fingerprint);
+            writer.append("updated");
+            writer.append(profile.updated.toMSecsSinceEpoch());
+            writer.append("displays");
+            SnapshotFormat::writeDisplays(writer, profile.displays);
+            writer.endMap();
+        }
+        writer.endArray();
+        writer.endMap();
+        return data;
+    }
+
+    QJsonArray profiles;
+    for (const LayoutProfile &profile : m_profiles) {
+        QJsonArray displays;
+        for (const DisplayInfo &display : profile.displays) {
+            QJsonObject json = display.toJson();
+            json.remove("availableModes");
+            displays.append(json);
+        }
+        QJsonObject json;
+        json["fingerprint"] = profile.fingerprint;
+        json["updated"] = profile.updated.toString(Qt::ISODate);
+        json["displays"] = displays;
+        profiles.append(json);
+    }
+    QJsonObject root;
+    root["version"] = 1;
+    root["profiles"] = profiles;
+    return QJsonDocument(root).toJson();
+}
+
+bool LayoutProfileStore::decode(const QByteArray &data, QString *error)
+{
+    m_profiles.clear();
+    if (SnapshotFormat::isCbor(data)) {
+        return decodeCbor(data, error);
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
+    if (doc.isNull()) {
+        if (error) *error = parseError.errorString();
+        return false;
+    }
+
+    for (const QJsonValue &value : doc.object()["profiles"].toArray()) {
+        QJsonObject json = value.toObject();
+        LayoutProfile profile;
+        profile.updated = QDateTime::fromString(json["updated"].toString(), Qt::ISODate);
+        for (const QJsonValue &display : json["displays"].toArray()) {
+            profile.displays.append(DisplayInfo::fromJson(display.toObject()));
+        }
+        // Recomputed so a change to the fingerprint scheme cannot strand old profiles
+        profile.fingerprint = fingerprint(profile.displays);
+        m_profiles.insert(profile.fingerprint, profile);
+    }
+    return true;
+}
+
+bool LayoutProfileStore::decodeCbor(const QByteArray &data, QString *error)
+{
+    QCborStreamReader reader(data);
+    if (!SnapshotFormat::enterDocument(reader, error)) {
+        return false;
+    }
+    bool ok = true;
+    while (ok && reader.lastError() == QCborError::NoError && reader.hasNext()) {
+        if (SnapshotFormat::readString(reader) != QLatin1String("profiles")) {
+            reader.next();
+            continue;
+        }
+        ok = reader.isArray() && reader.enterContainer();
+        while (ok && reader.lastError() == QCborError::NoError && reader.hasNext()) {
+            ok = reader.isMap() && reader.enterContainer();
+            LayoutProfile profile;
+            while (ok && reader.lastError() == QCborError::NoError && reader.hasNext()) {
+                const QString key = SnapshotFormat::readString(reader);
+                if (key == QLatin1String("updated")) {
+                    profile.updated = QDateTime::fromMSecsSinceEpoch(SnapshotFormat::readInteger(reader)).toUTC();
+                } else if (key == QLatin1String("displays")) {
+                    ok = SnapshotFormat::readDisplays(reader, profile.displays);
+                } else {
+                    reader.next();
+                }
+            }
+            ok = ok && reader.leaveContainer();
+            if (ok) {
+                profile.fingerprint = fingerprint(profile.displays);
+                m_profiles.insert(profile.fingerprint, profile);
+            }
+        }
+        ok = ok && reader.leaveContainer();
+    }
+    if (!ok || reader.lastError() != QCborError::NoError) {
+        if (error) *error = reader.lastError() != QCborError::NoError ? reader.lastError().toString()
+                                                                     : QString("Malformed profiles snapshot");
+        m_profiles.clear();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef LAYOUTPROFILESTORE_H
+#define LAYOUTPROFILESTORE_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "displaymanager.h"
+#include "snapshotformat.h"
+
+// A layout saved for one set of connected monitors
+struct LayoutProfile {
+    QString fingerprint;
+    QDateTime updated;
+    QList<DisplayInfo> displays;  // as applied, identity fields included
+
+    // Copies the saved mode, position, scale, transform and color settings
+    // onto the matching live monitors. Returns false if a live monitor has
+    // no counterpart in the profile.
+    bool applyTo(QList<DisplayInfo> &live) const;
+};
+
+// Saved layouts keyed by a fingerprint of the connected outputs, so the
+// layout for a dock or a desk is found by the monitors that are connected
+class LayoutProfileStore
+{
+public:
+    // "make|model|serial" of one output
+    static QString identity(const DisplayInfo &display);
+    // Order-independent hash of the identities of all outputs, disabled ones
+    // included; live lists come from "monitors all" for that reason
+    static QString fingerprint(const QList<DisplayInfo> &displays);
+    static QString defaultPath();
+
+    const LayoutProfile *find(const QString &fingerprint) const;
+    // A fingerprint, a prefix of one, or "auto" for the profile of displays;
+    // nullptr with the reason in error when none or several match
+    const LayoutProfile *resolve(const QString &wanted, const QList<DisplayInfo> &displays,
+                                 QString *error = nullptr) const;
+    // Stores displays as the layout for their fingerprint; returns that fingerprint
+    QString remember(const QList<DisplayInfo> &displays);
+    bool remove(const QString &fingerprint) { return m_profiles.remove(fingerprint) > 0; }
+    int size() const { return m_profiles.size(); }
+    QStringList fingerprints() const { return m_profiles.keys(); }
+
+    // load() and decode() take either format
+    bool load(const QString &path, QString *error = nullptr);
+    bool save(const QString &path, QString *error = nullptr,
+              SnapshotFormat::Format format = SnapshotFormat::Json) const;
+    QByteArray encode(SnapshotFormat::Format format) const;
+    bool decode(const QByteArray &data, QString *error = nullptr);
+
+private:
+    bool decodeCbor(const QByteArray &data, QString *error);
+
+    QHash<QString, LayoutProfile> m_profiles;
+};
+
+#endif // LAYOUTPROFILESTORE_H
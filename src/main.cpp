@@ -9,8 +9,17 @@
 #include <QStandardPaths>
 #include <QDebug>
 #include <QMessageBox>
+#include <QEventLoop>
 #include <iostream>
 #include "mainwindow.h"
+#include "displaymanager.h"
+#include "configmanager.h"
+#include "applyplanner.h"
+#include "startuptrace.h"
+#include "cli.h"
+#include "hotplugdaemon.h"
+#include "singleinstance.h"
+#include <QTimer>
 
 // Custom message handler to log to file
 void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
@@ -66,6 +75,28 @@ void messageHandler(QtMsgType type, const QMessageLogContext &context, const QSt
 
 int main(int argc, char *argv[])
 {
+    StartupTrace::start(argc, argv);
+    
+    // list/dump/apply never build a window; they log to stderr only
+    if (Cli::isSubcommand(argc, argv)) {
+        return Cli::run(argc, argv);
+    }
+    
+    // Neither does the daemon, which stays resident on a QCoreApplication
+    if (HotplugDaemon::isRequested(argc, argv)) {
+        return HotplugDaemon::run(argc, argv);
+    }
+    
+    // A second window launch hands its request to the running window and
+    // exits; the lock stays with this process for its lifetime otherwise
+    SingleInstance instance;
+    if (SingleInstance::isWindowLaunch(argc, argv)) {
+        const int exitCode = instance.claim(argc, argv);
+        if (exitCode >= 0) {
+            return exitCode;
+        }
+    }
+    
     // Install custom message handler
     qInstallMessageHandler(messageHandler);
     
@@ -84,6 +115,7 @@ int main(int argc, char *argv[])
         app.setApplicationVersion("1.0.0");
         app.setOrganizationName("HyprDisplays");
         app.setOrganizationDomain("hyprdisplays.org");
+        StartupTrace::mark("QApplication created");
 
         // Set up command line parser
         QCommandLineParser parser;
@@ -107,17 +139,101 @@ int main(int argc, char *argv[])
         );
         parser.addOption(numWorkspacesOption);
 
+        QCommandLineOption dryRunOption(
+            "dry-run",
+            "Print the commands needed to apply monitors.conf to the running monitors and exit"
+        );
+        parser.addOption(dryRunOption);
+
+        // Read by StartupTrace::start() before the parser exists
+        QCommandLineOption startupTraceOption(
+            "startup-trace",
+            "Print how long startup takes until the monitors are first painted"
+        );
+        parser.addOption(startupTraceOption);
+
+        // Handled by HotplugDaemon::run() before the parser exists
+        QCommandLineOption daemonOption(
+            "daemon",
+            "Run without a window and apply saved layouts when monitors are plugged in or removed"
+        );
+        parser.addOption(daemonOption);
+
+        QCommandLineOption applyProfileOption(
+            "apply-profile",
+            "Apply a saved layout profile (a fingerprint, a prefix of one, or auto); a running window does it instead",
+            "profile"
+        );
+        parser.addOption(applyProfileOption);
+
+        // Used by the startup benchmark in tests/ to time a full window start
+        QCommandLineOption exitAfterShowOption("exit-after-show", "Quit as soon as the window is shown");
+        exitAfterShowOption.setFlags(QCommandLineOption::HiddenFromHelp);
+        parser.addOption(exitAfterShowOption);
+
         parser.process(app);
 
+        if (parser.isSet(dryRunOption)) {
+            QTextStream out(stdout);
+            DisplayManager displayManager;
+            QEventLoop loop;
+            bool refreshed = false;
+            QObject::connect(&displayManager, &DisplayManager::refreshFinished, &loop, [&](bool ok) {
+                refreshed = ok;
+                loop.quit();
+            });
+            if (displayManager.refreshDisplays()) {
+                loop.exec();
+            }
+            if (!refreshed) {
+                out << "Failed to read monitors from Hyprland" << Qt::endl;
+                return 1;
+            }
+            
+            ConfigManager configManager;
+            QString monitorsPath = parser.value(monitorsPathOption);
+            if (QFile::exists(monitorsPath) && configManager.loadHyprlandMonitors(monitorsPath)) {
+                QHash<QString, QJsonObject> saved;
+                for (const QJsonValue &val : configManager.getDisplayConfig()["displays"].toArray()) {
+                    saved.insert(val.toObject()["name"].toString(), val.toObject());
+                }
+                for (const DisplayInfo &display : displayManager.getDisplays()) {
+                    if (saved.contains(display.name)) {
+                        displayManager.updateDisplayInMemory(
+                            DisplayManager::mergeWithConfig(display, saved.value(display.name)));
+                    }
+                }
+            }
+            
+            out << displayManager.dryRunConfiguration();
+            return 0;
+        }
+
         // Create main window
         qInfo() << "Creating MainWindow...";
         MainWindow window;
+        StartupTrace::mark("window constructed");
         qInfo() << "Setting monitors path:" << parser.value(monitorsPathOption);
         window.setMonitorsPath(parser.value(monitorsPathOption));
         qInfo() << "Setting num workspaces:" << parser.value(numWorkspacesOption).toInt();
         window.setNumWorkspaces(parser.value(numWorkspacesOption).toInt());
         qInfo() << "Showing window...";
         window.show();
+        StartupTrace::mark("window shown");
+        if (parser.isSet(applyProfileOption)) {
+            window.applyProfile(parser.value(applyProfileOption));
+        }
+        if (instance.isLocked()) {
+            QObject::connect(&instance, &SingleInstance::showRequested, &window, &MainWindow::activate);
+            QObject::connect(&instance, &SingleInstance::applyProfileRequested, &window, &MainWindow::applyProfile);
+            QString instanceError;
+            if (!instance.listen(&instanceError)) {
+                qWarning() << "Later launches will start their own window:" << instanceError;
+            }
+        }
+        if (parser.isSet(exitAfterShowOption)) {
+            QTimer::singleShot(0, &app, &QCoreApplication::quit);
+        }
         qInfo() << "Window shown successfully";
         qInfo() << "=== HyprDisplays Started Successfully ===";
 
@@ -4,6 +4,7 @@
 #include <QFileDialog>
 #include <QStandardPaths>
 #include <QDir>
+#include <QFileInfo>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -15,8 +16,17 @@
 #include <QPainter>
 #include "visualmonitorwidget.h"
 #include <limits>
+#include <memory>
+#include <utility>
 #include <cmath>
 #include "monitorgraphicsview.h"
+#include "monitorstatestore.h"
+#include "monitorscenesync.h"
+#include "hotplugprofileapplier.h"
+#include "controlserver.h"
+#include "startuptrace.h"
+#include "warmstartcache.h"
+#include <QElapsedTimer>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -24,6 +34,7 @@ MainWindow::MainWindow(QWidget *parent)
     , m_mainLayout(nullptr)
     , m_monitorLayoutScene(new QGraphicsScene(this))
     , m_monitorLayoutView(nullptr)
+    , m_sceneSync(nullptr)
     , m_monitorSettingsPanel(nullptr)
     , m_monitorSettingsLayout(nullptr)
     , m_selectedMonitorLabel(nullptr)
@@ -39,6 +50,7 @@ MainWindow::MainWindow(QWidget *parent)
     , m_statusLabel(nullptr)
     , m_trayIcon(nullptr)
     , m_trayMenu(nullptr)
+    , m_eventRefreshTimer(nullptr)
     , m_displayManager(new DisplayManager(this))
     , m_hyprlandInterface(nullptr)
     , m_configManager(new ConfigManager(this))
@@ -53,7 +65,6 @@ MainWindow::MainWindow(QWidget *parent)
     , m_isUpdatingDisplays(false)
     , m_tenBitCheckBox(nullptr)
     , m_wideGamutCheckBox(nullptr)
-    , m_currentDisplays(QList<DisplayInfo>())
     , m_posXSpinBox(nullptr)
     , m_posYSpinBox(nullptr)
     , m_layoutMinX(INT_MAX)
@@ -64,6 +75,9 @@ MainWindow::MainWindow(QWidget *parent)
     , m_updatingFromSpinbox(false)
 {
     qInfo() << "MainWindow constructor started";
+    m_sceneSync = new MonitorSceneSync(m_monitorLayoutScene, this);
+    connect(m_sceneSync, &MonitorSceneSync::itemCreated, this, &MainWindow::onMonitorItemCreated);
+    
     try {
         setupUI();
         qInfo() << "UI setup completed";
@@ -129,14 +143,89 @@ MainWindow::MainWindow(QWidget *parent)
         connect(m_hyprlandInterface, &HyprlandInterface::success, this, [this](const QString &message) {
             showNotification(message, false);
         });
+        
+        // Hotplug and config reload events arrive in bursts; refresh once per burst
+        m_eventRefreshTimer = new QTimer(this);
+        m_eventRefreshTimer->setSingleShot(true);
+        m_eventRefreshTimer->setInterval(50);
+        connect(m_eventRefreshTimer, &QTimer::timeout, this, &MainWindow::refreshDisplays);
+        connect(m_hyprlandInterface, &HyprlandInterface::monitorAdded, this, [this](const QString &name) {
+            qInfo() << "Monitor added:" << name;
+            m_eventRefreshTimer->start();
+        });
+        connect(m_hyprlandInterface, &HyprlandInterface::monitorRemoved, this, [this](const QString &name) {
+            qInfo() << "Monitor removed:" << name;
+            m_eventRefreshTimer->start();
+        });
+        connect(m_hyprlandInterface, &HyprlandInterface::configurationChanged, m_eventRefreshTimer, qOverload<>(&QTimer::start));
+        // Focus moves are frequent and carry all they change; no refresh for them
+        connect(m_hyprlandInterface, &HyprlandInterface::monitorFocused, m_displayManager, &DisplayManager::setFocusedMonitor);
+        connect(m_hyprlandInterface, &HyprlandInterface::activeWorkspaceChanged, m_displayManager, &DisplayManager::setActiveWorkspace);
+        
+        // Docking and undocking apply the layout saved for the new set of monitors
+        m_hotplugApplier = new HotplugProfileApplier(m_displayManager, LayoutProfileStore::defaultPath(), this);
+        m_hotplugApplier->setSnapshotFormat(m_configManager->snapshotFormat());
+        connect(m_hyprlandInterface, &HyprlandInterface::monitorAdded, this, &MainWindow::onMonitorHotplug);
+        connect(m_hyprlandInterface, &HyprlandInterface::monitorRemoved, this, &MainWindow::onMonitorHotplug);
+        connect(m_hotplugApplier, &HotplugProfileApplier::profileApplied, this,
+                [this](const QString &, qint64 latencyMs, bool) {
+            showNotification(QString("Applied the saved layout for these monitors in %1 ms").arg(latencyMs));
+        });
+        
+        // Scripts query the layout the window holds; a running daemon keeps the socket
+        m_controlServer = new ControlServer(m_displayManager, m_hotplugApplier, this);
+        m_controlServer->setStatusProvider([this]() {
+            QJsonObject status;
+            status["role"] = "window";
+            status["connected"] = m_hyprlandInterface->isConnected();
+            return status;
+        });
+        QString controlError;
+        if (!m_controlServer->listen(ControlServer::defaultSocketPath(), &controlError)) {
+            qInfo() << "Control socket not available, leaving hotplug to the daemon:" << controlError;
+            // Take over once the daemon has exited, independently of monitor events
+            m_controlRetryTimer = new QTimer(this);
+            m_controlRetryTimer->setInterval(30000);
+            connect(m_controlRetryTimer, &QTimer::timeout, this, [this]() {
+                if (!m_controlServer->listen(ControlServer::defaultSocketPath())) return;
+                m_controlRetryTimer->stop();
+                qInfo() << "The daemon is gone, the window applies saved layouts on hotplug again";
+                showNotification("The hotplug daemon has stopped, this window applies saved layouts now");
+            });
+            m_controlRetryTimer->start();
+        }
+        m_hyprlandInterface->setMonitorStore(m_displayManager->stateStore());
+        m_hyprlandInterface->startEventMonitoring();
     } else {
         qWarning() << "HyprlandInterface is null, skipping signal connections";
     }
     qInfo() << "HyprlandInterface signals connected";
     
-    // Initial refresh with safety check
+    // The config manager reloads files edited in other programs by itself
+    connect(m_configManager, &ConfigManager::hyprlandFileChanged, this, [this](const QString &path) {
+        if (m_statusLabel) m_statusLabel->setText(QString("Reloaded %1 after an external edit").arg(QFileInfo(path).fileName()));
+    });
+    
+    // Paint the monitors of the last session right away; the live refresh
+    // below runs in the background and reconciles them
+    loadWarmStartCache();
+    if (StartupTrace::isEnabled() && m_monitorLayoutView) {
+        m_monitorLayoutView->viewport()->installEventFilter(this);
+    }
+    connect(m_displayManager, &DisplayManager::refreshFinished, this, [this](bool ok) {
+        if (!ok || !m_showingCachedLayout) return;
+        m_showingCachedLayout = false;
+        StartupTrace::mark(QString("live monitors from Hyprland, %1 shown").arg(m_displayManager->snapshot()->size()));
+        if (m_statusLabel) m_statusLabel->setText("Connected to Hyprland");
+        // The cached layout was fitted to last session's view size
+        if (m_monitorLayoutView && QSizeF(m_monitorLayoutView->viewport()->size()) != m_warmViewSize) {
+            onDisplayChanged();
+        }
+    });
+    
+    // Initial refresh once the event loop runs; the window is shown by then
     qInfo() << "Setting up initial refresh timer...";
-    QTimer::singleShot(100, this, [this]() {
+    QTimer::singleShot(0, this, [this]() {
         qInfo() << "Initial refresh timer triggered";
         if (m_displayManager) {
             refreshDisplays();
@@ -147,55 +236,15 @@ MainWindow::MainWindow(QWidget *parent)
     qInfo() << "Checking for existing monitors.conf...";
     QString monitorConfPath = QDir::homePath() + "/.config/hypr/monitors.conf";
     qInfo() << "Monitor config path:" << monitorConfPath;
-    if (QFile::exists(monitorConfPath)) {
+    if (QFile::exists(monitorConfPath) && m_displayManager) {
         qInfo() << "Found existing monitors.conf, will load it";
-        QTimer::singleShot(200, this, [this, monitorConfPath]() {
+        // The merge needs the live monitors, so wait for the first refresh to land
+        auto connection = std::make_shared<QMetaObject::Connection>();
+        *connection = connect(m_displayManager, &DisplayManager::refreshFinished, this,
+                              [this, monitorConfPath, connection](bool) {
+            disconnect(*connection);
             if (m_configManager && m_configManager->loadHyprlandMonitors(monitorConfPath)) {
-                // Get the loaded configuration
-                QJsonObject loadedConfig = m_configManager->getDisplayConfig();
-                QJsonArray loadedDisplays = loadedConfig["displays"].toArray();
-                
-                // Merge loaded settings with current display state
-                if (m_displayManager) {
-                    QList<DisplayInfo> currentDisplays = m_displayManager->getDisplays();
-                    
-                    // Create a map of loaded settings by monitor name
-                    QMap<QString, QJsonObject> loadedSettings;
-                    for (const QJsonValue &val : loadedDisplays) {
-                        QJsonObject loadedDisplay = val.toObject();
-                        QString name = loadedDisplay["name"].toString();
-                        loadedSettings[name] = loadedDisplay;
-                    }
-                    
-                    // Apply loaded settings to current displays
-                    for (DisplayInfo &di : currentDisplays) {
-                        if (loadedSettings.contains(di.name)) {
-                            QJsonObject loaded = loadedSettings[di.name];
-                            di.vrrMode = loaded["vrrMode"].toInt(0);
-                            di.hdr = loaded["hdr"].toBool(false);
-                            di.sdrBrightness = loaded["sdrBrightness"].toDouble(1.0);
-                            di.sdrSaturation = loaded["sdrSaturation"].toDouble(1.0);
-                            di.scale = loaded["scale"].toDouble(1.0);
-                            di.tenBit = loaded["tenBit"].toBool(false);
-                            di.wideGamut = loaded["wideGamut"].toBool(false);
-                            // Update resolution and refresh rate if they differ
-                            if (loaded.contains("width") && loaded.contains("height")) {
-                                di.width = loaded["width"].toInt();
-                                di.height = loaded["height"].toInt();
-                                di.resolution = QString("%1x%2").arg(di.width).arg(di.height);
-                            }
-                            if (loaded.contains("refreshRate")) {
-                                di.refreshRate = loaded["refreshRate"].toDouble();
-                            }
-                        }
-                    }
-                    
-                    // Update the display manager with merged settings
-                    m_displayManager->clearDisplays();
-                    for (const DisplayInfo &di : currentDisplays) {
-                        m_displayManager->setDisplay(di);
-                    }
-                }
+                mergeMonitorsConf();
                 showNotification("Loaded existing monitors.conf configuration");
             }
         });
@@ -203,6 +252,30 @@ MainWindow::MainWindow(QWidget *parent)
         qInfo() << "No existing monitors.conf found";
     }
     
+    // Workspace rules only fill in the assignment boxes, so they need no monitors
+    if (m_configManager && QFile::exists(QDir::homePath() + "/.config/hypr/workspaces.conf")
+        && m_configManager->loadHyprlandWorkspaces(QString())) {
+        applyWorkspacesConf();
+    }
+    
+    // Edits made in an editor while the window is open
+    if (m_configManager) {
+        connect(m_configManager, &ConfigManager::hyprlandMonitorsReloaded, this, [this]() {
+            mergeMonitorsConf();
+            showNotification("Reloaded monitors.conf after an external edit");
+        });
+        connect(m_configManager, &ConfigManager::hyprlandWorkspacesReloaded, this, &MainWindow::applyWorkspacesConf);
+    }
+    
+    // After the monitors.conf merge, so a profile asked for at launch wins over it
+    connect(m_displayManager, &DisplayManager::refreshFinished, this, [this](bool ok) {
+        if (!ok) return;
+        m_haveLiveMonitors = true;
+        if (!m_pendingProfile.isEmpty()) {
+            applyProfile(std::exchange(m_pendingProfile, QString()));
+        }
+    });
+    
     // Load settings after all components are initialized
     try {
         qInfo() << "About to load settings...";
@@ -221,9 +294,66 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    saveWarmStartCache();
     saveSettings();
 }
 
+void MainWindow::loadWarmStartCache()
+{
+    QElapsedTimer timer;
+    timer.start();
+    WarmStartState state;
+    QString error;
+    if (!WarmStartCache::load(WarmStartCache::defaultPath(), state, &error)) {
+        qWarning() << "Ignoring the warm-start cache:" << error;
+        return;
+    }
+    if (state.displays.isEmpty()) {
+        return;
+    }
+    const qint64 loadUs = timer.nsecsElapsed() / 1000;
+    
+    m_warmViewSize = state.viewSize;
+    m_layoutMinX = state.layout.minX;
+    m_layoutMinY = state.layout.minY;
+    m_layoutScale = state.layout.scale;
+    m_layoutOffsetX = state.layout.offsetX;
+    m_layoutOffsetY = state.layout.offsetY;
+    m_showingCachedLayout = true;
+    m_displayManager->setDisplays(state.displays);
+    StartupTrace::mark(QString("warm-start cache: %1 monitors from %2, loaded in %3 us")
+                       .arg(state.displays.size()).arg(state.saved.toString(Qt::ISODate)).arg(loadUs));
+    if (m_statusLabel) m_statusLabel->setText("Showing the last known layout, waiting for Hyprland");
+}
+
+void MainWindow::saveWarmStartCache()
+{
+    if (!m_displayManager || !m_monitorLayoutView || m_sceneSync->items().isEmpty()) {
+        return;
+    }
+    WarmStartState state;
+    state.displays = m_displayManager->snapshot()->displays;
+    state.layout = m_sceneSync->layout();
+    state.viewSize = m_monitorLayoutView->viewport()->size();
+    state.saved = QDateTime::currentDateTime();
+    QString error;
+    if (!WarmStartCache::save(WarmStartCache::defaultPath(), state, &error)) {
+        qWarning() << "Failed to save the warm-start cache:" << error;
+    }
+}
+
+bool MainWindow::eventFilter(QObject *watched, QEvent *event)
+{
+    // Only installed with --startup-trace
+    if (event->type() == QEvent::Paint && m_monitorLayoutView && watched == m_monitorLayoutView->viewport()
+        && !m_sceneSync->items().isEmpty()) {
+        StartupTrace::mark(QString("first paint with %1 monitors (%2)")
+                           .arg(m_sceneSync->items().size()).arg(m_showingCachedLayout ? "cached" : "live"));
+        m_monitorLayoutView->viewport()->removeEventFilter(this);
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
 void MainWindow::setMonitorsPath(const QString &path)
 {
     m_monitorsPath = path;
@@ -252,7 +382,7 @@ void MainWindow::applySettings()
     if (m_displayManager) {
         // Update DisplayInfo positions from the scene
         QList<DisplayInfo> displays = m_displayManager->getDisplays();
-        for (VisualMonitorWidget *vmw : std::as_const(m_monitorProxyWidgets)) {
+        for (VisualMonitorWidget *vmw : m_sceneSync->items()) {
             QString name = vmw->getName();
             QPointF pos = vmw->pos();
             for (DisplayInfo &di : displays) {
@@ -262,11 +392,9 @@ void MainWindow::applySettings()
                 }
             }
         }
-        m_displayManager->clearDisplays();
-        for (const DisplayInfo &di : displays) m_displayManager->setDisplay(di);
-        if (m_displayManager->applyConfiguration()) {
-            showNotification("Configuration applied successfully");
-        } else {
+        m_displayManager->setDisplays(displays);
+        // The outcome is reported through DisplayManager's success/error signals
+        if (!m_displayManager->applyConfiguration()) {
             showNotification("Failed to apply configuration", true);
         }
     }
@@ -662,12 +790,9 @@ void MainWindow::setupConnections()
     // Connect resolution combo box to update refresh rates
     connect(m_resolutionComboBox, &QComboBox::currentTextChanged, this, [this](const QString &res) {
         if (!m_selectedMonitorName.isEmpty() && m_displayManager) {
-            QList<DisplayInfo> displays = m_displayManager->getDisplays();
-            for (const DisplayInfo &di : displays) {
-                if (di.name == m_selectedMonitorName) {
-                    updateRefreshRatesForResolution(res, di);
-                    break;
-                }
+            MonitorSnapshotPtr current = m_displayManager->snapshot();
+            if (const DisplayInfo *di = current->find(m_selectedMonitorName)) {
+                updateRefreshRatesForResolution(res, *di);
             }
         }
     });
@@ -734,35 +859,27 @@ void MainWindow::setupConnections()
                     qDebug() << "  10-bit:" << m_tenBitCheckBox->isChecked();
                     qDebug() << "  Wide gamut:" << m_wideGamutCheckBox->isChecked();
                     
-                    di.resolution = m_resolutionComboBox->currentText();
-                    QString refreshText = m_refreshRateComboBox->currentText();
-                    bool ok = false;
-                    double refresh = refreshText.left(refreshText.indexOf(" Hz")).toDouble(&ok);
-                    if (ok) di.refreshRate = refresh;
+                    applySelectedMode(di);
                     di.vrrMode = m_vrrComboBox->currentData().toInt();
                     di.scale = m_scaleSpinBox->value();
-                    di.hdr = m_hdrCheckBox->isChecked();
+                    di.setHdr(m_hdrCheckBox->isChecked());
                     di.sdrBrightness = m_sdrBrightnessSpinBox->value();
                     di.sdrSaturation = m_sdrSaturationSpinBox->value();
-                    di.tenBit = m_tenBitCheckBox->isChecked();
-                    di.wideGamut = m_wideGamutCheckBox->isChecked();
+                    di.setTenBit(m_tenBitCheckBox->isChecked());
+                    di.setWideGamut(m_wideGamutCheckBox->isChecked());
                     break;
                 }
             }
         }
         
-        // Update the display manager with all modified displays
-        m_displayManager->clearDisplays();
-        for (const DisplayInfo &di : displays) {
-            m_displayManager->setDisplay(di);
-        }
+        // Publish all modified displays as one new version
+        m_displayManager->setDisplays(displays);
         
-        // Now get the updated displays and save to config
-        displays = m_displayManager->getDisplays();
+        // Save the published displays to config
         QJsonObject displayConfig;
         QJsonArray displaysArray;
         for (const DisplayInfo &di : displays) {
-            qDebug() << "Saving display:" << di.name << "x:" << di.x << "y:" << di.y << "HDR:" << di.hdr << "10-bit:" << di.tenBit << "Wide gamut:" << di.wideGamut;
+            qDebug() << "Saving display:" << di.name << "x:" << di.x << "y:" << di.y << "HDR:" << di.isHdr() << "10-bit:" << di.isTenBit() << "Wide gamut:" << di.isWideGamut();
             displaysArray.append(di.toJson());
         }
         displayConfig["displays"] = displaysArray;
@@ -781,22 +898,20 @@ void MainWindow::setupConnections()
     connect(m_posXSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, [this](double x) {
         if (m_selectedMonitorName.isEmpty() || m_updatingFromSpinbox) return;
         m_updatingFromSpinbox = true;
-        for (DisplayInfo &di : m_currentDisplays) {
-            if (di.name == m_selectedMonitorName) {
-                di.x = static_cast<int>(std::round(x));
-                qDebug() << "[SpinBox X] Set logical X for" << di.name << ":" << di.x;
-                // Move the visual widget
-                for (VisualMonitorWidget *vmw : m_monitorProxyWidgets) {
-                    if (vmw->getName() == di.name) {
-                        QPointF newPos(m_layoutOffsetX + (di.x - m_layoutMinX) * m_layoutScale,
-                                       m_layoutOffsetY + (di.y - m_layoutMinY) * m_layoutScale);
-                        qDebug() << "[SpinBox X] Moving visual widget for" << di.name << "to scene pos" << newPos;
-                        vmw->setPos(newPos);
-                        m_monitorPositions[di.name] = newPos.toPoint();
-                        break;
-                    }
-                }
-                break;
+        MonitorSnapshotPtr current = m_displayManager ? m_displayManager->snapshot() : MonitorSnapshotPtr();
+        const DisplayInfo *selected = current ? current->find(m_selectedMonitorName) : nullptr;
+        if (selected) {
+            DisplayInfo di = *selected;
+            di.x = static_cast<int>(std::round(x));
+            qDebug() << "[SpinBox X] Set logical X for" << di.name << ":" << di.x;
+            m_displayManager->updateDisplayInMemory(di);
+            // Move the visual widget
+            if (VisualMonitorWidget *vmw = m_sceneSync->item(di.name)) {
+                QPointF newPos(m_layoutOffsetX + (di.x - m_layoutMinX) * m_layoutScale,
+                               m_layoutOffsetY + (di.y - m_layoutMinY) * m_layoutScale);
+                qDebug() << "[SpinBox X] Moving visual widget for" << di.name << "to scene pos" << newPos;
+                vmw->setPos(newPos);
+                m_monitorPositions[di.name] = newPos.toPoint();
             }
         }
         m_updatingFromSpinbox = false;
@@ -804,22 +919,20 @@ void MainWindow::setupConnections()
     connect(m_posYSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, [this](double y) {
         if (m_selectedMonitorName.isEmpty() || m_updatingFromSpinbox) return;
         m_updatingFromSpinbox = true;
-        for (DisplayInfo &di : m_currentDisplays) {
-            if (di.name == m_selectedMonitorName) {
-                di.y = static_cast<int>(std::round(y));
-                qDebug() << "[SpinBox Y] Set logical Y for" << di.name << ":" << di.y;
-                // Move the visual widget
-                for (VisualMonitorWidget *vmw : m_monitorProxyWidgets) {
-                    if (vmw->getName() == di.name) {
-                        QPointF newPos(m_layoutOffsetX + (di.x - m_layoutMinX) * m_layoutScale,
-                                       m_layoutOffsetY + (di.y - m_layoutMinY) * m_layoutScale);
-                        qDebug() << "[SpinBox Y] Moving visual widget for" << di.name << "to scene pos" << newPos;
-                        vmw->setPos(newPos);
-                        m_monitorPositions[di.name] = newPos.toPoint();
-                        break;
-                    }
-                }
-                break;
+        MonitorSnapshotPtr current = m_displayManager ? m_displayManager->snapshot() : MonitorSnapshotPtr();
+        const DisplayInfo *selected = current ? current->find(m_selectedMonitorName) : nullptr;
+        if (selected) {
+            DisplayInfo di = *selected;
+            di.y = static_cast<int>(std::round(y));
+            qDebug() << "[SpinBox Y] Set logical Y for" << di.name << ":" << di.y;
+            m_displayManager->updateDisplayInMemory(di);
+            // Move the visual widget
+            if (VisualMonitorWidget *vmw = m_sceneSync->item(di.name)) {
+                QPointF newPos(m_layoutOffsetX + (di.x - m_layoutMinX) * m_layoutScale,
+                               m_layoutOffsetY + (di.y - m_layoutMinY) * m_layoutScale);
+                qDebug() << "[SpinBox Y] Moving visual widget for" << di.name << "to scene pos" << newPos;
+                vmw->setPos(newPos);
+                m_monitorPositions[di.name] = newPos.toPoint();
             }
         }
         m_updatingFromSpinbox = false;
@@ -948,6 +1061,50 @@ void MainWindow::updateWorkspaceAssignments()
         connect(comboBox, QOverload<const QString &>::of(&QComboBox::currentTextChanged), 
                 this, &MainWindow::onWorkspaceAssignmentChanged);
     }
+    
+    applyWorkspacesConf();
+}
+
+void MainWindow::mergeMonitorsConf()
+{
+    if (!m_configManager || !m_displayManager) return;
+    
+    // Create a map of loaded settings by monitor name
+    QMap<QString, QJsonObject> loadedSettings;
+    for (const QJsonValue &val : m_configManager->getDisplayConfig()["displays"].toArray()) {
+        QJsonObject loadedDisplay = val.toObject();
+        loadedSettings[loadedDisplay["name"].toString()] = loadedDisplay;
+    }
+    
+    // Apply loaded settings to current displays
+    QList<DisplayInfo> currentDisplays = m_displayManager->getDisplays();
+    for (DisplayInfo &di : currentDisplays) {
+        if (loadedSettings.contains(di.name)) {
+            di = DisplayManager::mergeWithConfig(di, loadedSettings[di.name]);
+        }
+    }
+    
+    // Update the display manager with merged settings
+    m_displayManager->setDisplays(currentDisplays);
+}
+
+void MainWindow::applyWorkspacesConf()
+{
+    if (!m_configManager) return;
+    
+    QHash<QString, QString> monitors;
+    for (const QJsonValue &val : m_configManager->getWorkspaceConfig()["workspaces"].toArray()) {
+        QJsonObject workspace = val.toObject();
+        monitors.insert(workspace["name"].toString(), workspace["monitor"].toString());
+    }
+    
+    for (int i = 0; i < m_workspaceAssignments.size(); ++i) {
+        QComboBox *comboBox = m_workspaceAssignments.at(i);
+        int index = comboBox->findText(monitors.value(QString::number(i + 1)));
+        // Loading is not an edit, so auto-apply stays out of it
+        QSignalBlocker blocker(comboBox);
+        comboBox->setCurrentIndex(index > 0 ? index : 0);
+    }
 }
 
 void MainWindow::showNotification(const QString &message, bool isError)
@@ -1001,100 +1158,49 @@ void MainWindow::onDisplayChanged()
         return;
     }
     
-    if (m_monitorSettingsPanel) m_monitorSettingsPanel->setVisible(false);
-    m_monitorLayoutScene->clear();
-    m_monitorProxyWidgets.clear();
-    m_monitorPositions.clear();
-    
     if (!m_displayManager) { 
         qWarning() << "[onDisplayChanged] m_displayManager is null!"; 
         m_isUpdatingDisplays = false; 
         return; 
     }
     
-    QList<DisplayInfo> displays = m_displayManager->getDisplays();
-    if (displays.isEmpty()) { 
-        qWarning() << "[onDisplayChanged] No displays found!"; 
-        m_isUpdatingDisplays = false; 
-        return; 
+    // Hold one snapshot for the whole update; edits made meanwhile publish new versions
+    MonitorSnapshotPtr current = m_displayManager->snapshot();
+    const QList<DisplayInfo> &displays = current->displays;
+    QSizeF viewSize = m_monitorLayoutView->viewport()->size();
+    if (!m_monitorLayoutView->isVisible() && m_warmViewSize.isValid()) {
+        // Not laid out yet; fit the way the view was last time
+        viewSize = m_warmViewSize;
     }
     
-    // 1. Calculate logical bounding box
-    int minX = INT_MAX, minY = INT_MAX, maxX = INT_MIN, maxY = INT_MIN;
-    for (const DisplayInfo &d : displays) {
-        minX = std::min(minX, d.x);
-        minY = std::min(minY, d.y);
-        maxX = std::max(maxX, d.x + d.width);
-        maxY = std::max(maxY, d.y + d.height);
-    }
-    QRect logicalBoundingRect(minX, minY, maxX - minX, maxY - minY);
-
-    // 2. Calculate scale factor to fill the view (allow scaling up)
-    QSizeF viewSize = m_monitorLayoutView->viewport()->size();
-    const qreal margin = 10.0;
-    qreal scaleX = (viewSize.width() - 2 * margin) / logicalBoundingRect.width();
-    qreal scaleY = (viewSize.height() - 2 * margin) / logicalBoundingRect.height();
-    qreal scale = std::min(scaleX, scaleY);
-
-    // 3. Center the arrangement in the view
-    qreal offsetX = (viewSize.width() - logicalBoundingRect.width() * scale) / 2.0;
-    qreal offsetY = (viewSize.height() - logicalBoundingRect.height() * scale) / 2.0;
-
+    // Move, restyle, add or remove items in place instead of rebuilding the scene
+    MonitorSceneSync::Stats stats = m_sceneSync->sync(displays, viewSize);
+    qDebug() << "[onDisplayChanged] Synced" << displays.size() << "monitors in" << stats.elapsedUs << "us:"
+             << stats.added << "added," << stats.removed << "removed," << stats.updated << "updated";
+    
     // Store layout parameters for stable drag mapping
-    m_layoutMinX = minX;
-    m_layoutMinY = minY;
-    m_layoutScale = scale;
-    m_layoutOffsetX = offsetX;
-    m_layoutOffsetY = offsetY;
-
-    // 4. Clear scene and add widgets
-    m_monitorLayoutScene->clear();
-    m_monitorProxyWidgets.clear();
+    const MonitorLayoutTransform &layout = m_sceneSync->layout();
+    m_layoutMinX = layout.minX;
+    m_layoutMinY = layout.minY;
+    m_layoutScale = layout.scale;
+    m_layoutOffsetX = layout.offsetX;
+    m_layoutOffsetY = layout.offsetY;
+    
     m_monitorPositions.clear();
-
-    m_currentDisplays = m_displayManager->getDisplays();
-
-    for (const DisplayInfo &d : m_currentDisplays) {
-        VisualMonitorWidget *vmw = new VisualMonitorWidget(
-            d.name, d.resolution, d.width, d.height, nullptr, scale
-        );
-        vmw->setPrimary(d.primary);
-        vmw->setEnabled(d.enabled);
-        vmw->setScale(d.scale);
-        vmw->setTransform(d.transform);
-        vmw->setHDR(d.hdr);
-        vmw->setSDRBrightness(d.sdrBrightness);
-        vmw->setSDRSaturation(d.sdrSaturation);
-        vmw->setTenBit(d.tenBit);
-        vmw->setWideGamut(d.wideGamut);
-        // Position with offset so arrangement is centered
-        QPointF pos(offsetX + (d.x - minX) * scale, offsetY + (d.y - minY) * scale);
-        vmw->setPos(pos);
-        m_monitorLayoutScene->addItem(vmw);
-        m_monitorProxyWidgets.append(vmw);
-        m_monitorPositions[d.name] = pos.toPoint();
-        connect(vmw, &VisualMonitorWidget::monitorMoved, this, [this, name=d.name](const QString &, const QPointF &pos) {
-            // Update the stored position
-            m_monitorPositions[name] = pos.toPoint();
-            // Update the logical position in the persistent model in real time using stored layout params
-            for (DisplayInfo &di : m_currentDisplays) {
-                if (di.name == name) {
-                    di.x = static_cast<int>((pos.x() - m_layoutOffsetX) / m_layoutScale + m_layoutMinX);
-                    di.y = static_cast<int>((pos.y() - m_layoutOffsetY) / m_layoutScale + m_layoutMinY);
-                    qDebug() << "[monitorMoved] Scene pos:" << pos << "-> Logical:" << di.x << di.y << "(layout min:" << m_layoutMinX << m_layoutMinY << ", scale:" << m_layoutScale << ", offset:" << m_layoutOffsetX << m_layoutOffsetY << ")";
-                    m_updatingFromSpinbox = true;
-                    if (m_posXSpinBox) { m_posXSpinBox->blockSignals(true); m_posXSpinBox->setValue(static_cast<double>(di.x)); m_posXSpinBox->blockSignals(false); }
-                    if (m_posYSpinBox) { m_posYSpinBox->blockSignals(true); m_posYSpinBox->setValue(static_cast<double>(di.y)); m_posYSpinBox->blockSignals(false); }
-                    m_updatingFromSpinbox = false;
-                    qDebug() << "[monitorMoved] Updated logical position for" << name << "to" << di.x << "x" << di.y;
-                    break;
-                }
-            }
-        });
-        connect(vmw, &VisualMonitorWidget::monitorClicked, this, [this, name=d.name](const QString &) {
-            qDebug() << "Monitor clicked:" << name;
-            showMonitorSettings(name);
-        });
+    for (const DisplayInfo &d : displays) {
+        m_monitorPositions[d.name] = layout.toScene(d.x, d.y).toPoint();
+    }
+    
+    if (!m_selectedMonitorName.isEmpty() && !current->contains(m_selectedMonitorName)) {
+        // The selected monitor went away; let auto-selection pick another one
+        if (m_monitorSettingsPanel) m_monitorSettingsPanel->setVisible(false);
+        m_selectedMonitorName.clear();
+    }
+    
+    if (displays.isEmpty()) { 
+        qWarning() << "[onDisplayChanged] No displays found!"; 
+        m_isUpdatingDisplays = false; 
+        return; 
     }
 
     // 5. Set scene rect to the full view size (so it always fills the view)
@@ -1106,7 +1212,7 @@ void MainWindow::onDisplayChanged()
         
         // First try to find the primary monitor
         for (const DisplayInfo &d : displays) {
-            if (d.primary) {
+            if (d.isPrimary()) {
                 monitorToSelect = d.name;
                 break;
             }
@@ -1151,6 +1257,33 @@ void MainWindow::onDisplayChanged()
     qDebug() << "onDisplayChanged finished";
 }
 
+void MainWindow::onMonitorItemCreated(VisualMonitorWidget *vmw)
+{
+    connect(vmw, &VisualMonitorWidget::monitorMoved, this, [this](const QString &name, const QPointF &pos) {
+        // Update the stored position
+        m_monitorPositions[name] = pos.toPoint();
+        // Update the logical position in the persistent model in real time using stored layout params
+        MonitorSnapshotPtr latest = m_displayManager->snapshot();
+        const DisplayInfo *moved = latest->find(name);
+        if (moved) {
+            DisplayInfo di = *moved;
+            di.x = static_cast<int>((pos.x() - m_layoutOffsetX) / m_layoutScale + m_layoutMinX);
+            di.y = static_cast<int>((pos.y() - m_layoutOffsetY) / m_layoutScale + m_layoutMinY);
+            qDebug() << "[monitorMoved] Scene pos:" << pos << "-> Logical:" << di.x << di.y << "(layout min:" << m_layoutMinX << m_layoutMinY << ", scale:" << m_layoutScale << ", offset:" << m_layoutOffsetX << m_layoutOffsetY << ")";
+            m_displayManager->updateDisplayInMemory(di);
+            m_updatingFromSpinbox = true;
+            if (m_posXSpinBox) { m_posXSpinBox->blockSignals(true); m_posXSpinBox->setValue(static_cast<double>(di.x)); m_posXSpinBox->blockSignals(false); }
+            if (m_posYSpinBox) { m_posYSpinBox->blockSignals(true); m_posYSpinBox->setValue(static_cast<double>(di.y)); m_posYSpinBox->blockSignals(false); }
+            m_updatingFromSpinbox = false;
+            qDebug() << "[monitorMoved] Updated logical position for" << name << "to" << di.x << "x" << di.y;
+        }
+    });
+    connect(vmw, &VisualMonitorWidget::monitorClicked, this, [this](const QString &name) {
+        qDebug() << "Monitor clicked:" << name;
+        showMonitorSettings(name);
+    });
+}
+
 void MainWindow::onWorkspaceAssignmentChanged()
 {
     if (m_autoApply) {
@@ -1217,6 +1350,54 @@ void MainWindow::onTrayIconActivated(QSystemTrayIcon::ActivationReason reason)
     }
 }
 
+void MainWindow::onMonitorHotplug()
+{
+    // The daemon owns the control socket while it runs and applies the
+    // layout itself; a second apply would mean a second batch and modeset
+    if (!m_controlServer->isListening()) {
+        return;
+    }
+    m_hotplugApplier->onHotplug();
+}
+
+void MainWindow::activate()
+{
+    if (isMinimized()) {
+        showNormal();
+    } else {
+        show();
+    }
+    raise();
+    activateWindow();
+}
+
+void MainWindow::applyProfile(const QString &profile)
+{
+    // The warm-start cache may still show last session's monitors
+    if (!m_haveLiveMonitors) {
+        m_pendingProfile = profile;
+        return;
+    }
+    if (!m_hotplugApplier) {
+        showNotification("Not connected to Hyprland, no saved layouts", true);
+        return;
+    }
+    m_hotplugApplier->reloadIfChanged();
+    QList<DisplayInfo> displays = m_displayManager->snapshot()->displays;
+    QString error;
+    const LayoutProfile *saved = m_hotplugApplier->profiles().resolve(profile, displays, &error);
+    if (!saved) {
+        showNotification(error, true);
+        return;
+    }
+    saved->applyTo(displays);
+    m_displayManager->setDisplays(displays);
+    // The outcome is reported through DisplayManager's success/error signals
+    if (!m_displayManager->applyConfiguration()) {
+        showNotification(QString("Failed to apply profile %1").arg(saved->fingerprint.left(12)), true);
+    }
+}
+
 void MainWindow::showMonitorSettings(const QString& name)
 {
     if (m_isUpdatingDisplays) {
@@ -1226,28 +1407,24 @@ void MainWindow::showMonitorSettings(const QString& name)
     qDebug() << "showMonitorSettings called for" << name;
     // Save settings for the previously selected monitor
     if (!m_selectedMonitorName.isEmpty() && m_displayManager) {
-        QList<DisplayInfo> displays = m_displayManager->getDisplays();
-        for (DisplayInfo &di : displays) {
-            if (di.name == m_selectedMonitorName) {
-                di.resolution = m_resolutionComboBox->currentText();
-                QString refreshText = m_refreshRateComboBox->currentText();
-                bool ok = false;
-                double refresh = refreshText.left(refreshText.indexOf(" Hz")).toDouble(&ok);
-                if (ok) di.refreshRate = refresh;
-                di.vrrMode = m_vrrComboBox->currentData().toInt();
-                di.scale = m_scaleSpinBox->value();
-                di.hdr = m_hdrCheckBox->isChecked();
-                di.sdrBrightness = m_sdrBrightnessSpinBox->value();
-                di.sdrSaturation = m_sdrSaturationSpinBox->value();
-                di.tenBit = m_tenBitCheckBox->isChecked();
-                di.wideGamut = m_wideGamutCheckBox->isChecked();
-            }
+        MonitorSnapshotPtr previous = m_displayManager->snapshot();
+        if (const DisplayInfo *selected = previous->find(m_selectedMonitorName)) {
+            DisplayInfo di = *selected;
+            applySelectedMode(di);
+            di.vrrMode = m_vrrComboBox->currentData().toInt();
+            di.scale = m_scaleSpinBox->value();
+            di.setHdr(m_hdrCheckBox->isChecked());
+            di.sdrBrightness = m_sdrBrightnessSpinBox->value();
+            di.sdrSaturation = m_sdrSaturationSpinBox->value();
+            di.setTenBit(m_tenBitCheckBox->isChecked());
+            di.setWideGamut(m_wideGamutCheckBox->isChecked());
+            m_displayManager->updateDisplayInMemory(di);
         }
     }
     m_selectedMonitorName = name;
     if (!m_displayManager) { qWarning() << "[showMonitorSettings] m_displayManager is null!"; return; }
-    QList<DisplayInfo> displays = m_displayManager->getDisplays();
-    for (const DisplayInfo &di : displays) {
+    MonitorSnapshotPtr current = m_displayManager->snapshot();
+    for (const DisplayInfo &di : current->displays) {
         if (di.name == name) {
             if (!m_selectedMonitorLabel || !m_resolutionComboBox || !m_refreshRateComboBox || !m_scaleSpinBox || !m_hdrCheckBox || !m_sdrBrightnessSpinBox || !m_sdrSaturationSpinBox || !m_vrrComboBox || !m_tenBitCheckBox || !m_wideGamutCheckBox || !m_posXSpinBox || !m_posYSpinBox) {
                 qWarning() << "[showMonitorSettings] One or more UI widgets are null when showing settings!";
@@ -1256,44 +1433,26 @@ void MainWindow::showMonitorSettings(const QString& name)
             m_selectedMonitorLabel->setText(QString("Settings for %1").arg(name));
             m_resolutionComboBox->blockSignals(true);
             m_resolutionComboBox->clear();
-            QSet<QString> resolutions;
-            for (const QString &mode : di.availableModes) {
-                int atIndex = mode.indexOf('@');
-                if (atIndex > 0) {
-                    resolutions.insert(mode.left(atIndex));
-                }
-            }
-            QStringList resList = resolutions.values();
-            std::sort(resList.begin(), resList.end(), [](const QString &a, const QString &b) {
-                QStringList aParts = a.split('x');
-                QStringList bParts = b.split('x');
-                if (aParts.size() == 2 && bParts.size() == 2) {
-                    int aWidth = aParts[0].toInt();
-                    int bWidth = bParts[0].toInt();
-                    if (aWidth != bWidth) return aWidth > bWidth;
-                    return aParts[1].toInt() > bParts[1].toInt();
-                }
-                return a > b;
-            });
-            m_resolutionComboBox->addItems(resList);
+            ModeTablePtr modes = di.modeTable ? di.modeTable : ModeTable::fromModes(di.availableModes);
+            m_resolutionComboBox->addItems(modes->resolutions());
             m_resolutionComboBox->blockSignals(false);
-            int currentResIndex = m_resolutionComboBox->findText(di.resolution);
+            int currentResIndex = m_resolutionComboBox->findText(di.resolution());
             if (currentResIndex >= 0) {
                 m_resolutionComboBox->setCurrentIndex(currentResIndex);
             }
-            updateRefreshRatesForResolution(di.resolution, di);
+            updateRefreshRatesForResolution(di.resolution(), di);
             m_scaleSpinBox->setValue(di.scale);
-            m_hdrCheckBox->setChecked(di.hdr);
+            m_hdrCheckBox->setChecked(di.isHdr());
             m_sdrBrightnessSpinBox->setValue(di.sdrBrightness);
             m_sdrSaturationSpinBox->setValue(di.sdrSaturation);
-            m_tenBitCheckBox->setChecked(di.tenBit);
-            m_wideGamutCheckBox->setChecked(di.wideGamut);
+            m_tenBitCheckBox->setChecked(di.isTenBit());
+            m_wideGamutCheckBox->setChecked(di.isWideGamut());
             int vrrIndex = 0;
             if (di.vrrMode == 1) vrrIndex = 1;
             else if (di.vrrMode == 2) vrrIndex = 2;
             m_vrrComboBox->setCurrentIndex(vrrIndex);
-            m_vrrComboBox->setVisible(di.vrrCapable);
-            m_hdrCheckBox->setVisible(di.hdrCapable);
+            m_vrrComboBox->setVisible(di.isVrrCapable());
+            m_hdrCheckBox->setVisible(di.isHdrCapable());
             m_posXSpinBox->blockSignals(true);
             m_posXSpinBox->setValue(static_cast<double>(di.x));
             m_posXSpinBox->blockSignals(false);
@@ -1308,37 +1467,33 @@ void MainWindow::showMonitorSettings(const QString& name)
     qWarning() << "[showMonitorSettings] No display found for" << name;
 }
 
+void MainWindow::applySelectedMode(DisplayInfo &di) const
+{
+    const QString resolution = m_resolutionComboBox->currentText();
+    const int picked = m_refreshRateComboBox->currentData().toInt();
+    ModeTablePtr modes = di.modeTable ? di.modeTable : ModeTable::fromModes(di.availableModes);
+    // The combo lists rates to 0.01 Hz; the entry selected for the live rate is not a change
+    const bool samePick = resolution == di.resolution() && picked == modes->closestRefresh(resolution, di.refreshRate);
+    di.setResolution(resolution);
+    if (picked > 0 && !samePick) di.refreshRate = ModeTable::toHertz(picked);
+}
+
 void MainWindow::updateRefreshRatesForResolution(const QString& resolution, const DisplayInfo& di)
 {
     m_refreshRateComboBox->blockSignals(true);
     m_refreshRateComboBox->clear();
-    QSet<QString> refreshRates;
-    for (const QString &mode : di.availableModes) {
-        int atIndex = mode.indexOf('@');
-        if (atIndex > 0) {
-            QString res = mode.left(atIndex);
-            QString rate = mode.mid(atIndex + 1);
-            if (rate.endsWith("Hz")) rate.chop(2);
-            if (res == resolution) refreshRates.insert(rate.trimmed());
-        }
+    ModeTablePtr modes = di.modeTable ? di.modeTable : ModeTable::fromModes(di.availableModes);
+    for (int rate : modes->refreshRates(resolution)) {
+        m_refreshRateComboBox->addItem(ModeTable::formatRefresh(rate), rate);
     }
-    QStringList rateList = refreshRates.values();
-    std::sort(rateList.begin(), rateList.end(), [](const QString &a, const QString &b) {
-        return a.toDouble() > b.toDouble();
-    });
-    for (const QString &rate : rateList) m_refreshRateComboBox->addItem(rate + " Hz");
     
     // Set to current refresh rate if available, else first
-    QString currentRate = QString::number(di.refreshRate);
-    bool found = false;
-    for (const QString &rate : refreshRates) {
-        if (rate == currentRate) {
-            m_refreshRateComboBox->setCurrentText(rate + " Hz");
-            found = true;
-            break;
-        }
-    }
-    if (!found && !refreshRates.isEmpty())
+    int current = modes->closestRefresh(resolution, di.refreshRate);
+    int currentIndex = current ? m_refreshRateComboBox->findData(current) : -1;
+    if (currentIndex >= 0)
+        m_refreshRateComboBox->setCurrentIndex(currentIndex);
+    else if (m_refreshRateComboBox->count() > 0)
         m_refreshRateComboBox->setCurrentIndex(0);
     m_refreshRateComboBox->blockSignals(false);
-} 
\ No newline at end of file
+}
+ 
\ No newline at end of file
@@ -46,6 +46,10 @@
 #include "configmanager.h"
 #include "visualmonitorwidget.h"
 
+class MonitorSceneSync;
+class HotplugProfileApplier;
+class ControlServer;
+
 QT_BEGIN_NAMESPACE
 class QVBoxLayout;
 class QHBoxLayout;
@@ -102,9 +106,15 @@ public slots:
     void showOverlay();
     void showMonitorSettings(const QString& name);
     void updateRefreshRatesForResolution(const QString& resolution, const DisplayInfo& di);
+    // Shows and raises the window, also when it sits in the tray
+    void activate();
+    // A fingerprint, a prefix of one, or "auto"; waits for the live monitors
+    // when they have not been read yet
+    void applyProfile(const QString &profile);
 
 private slots:
     void onDisplayChanged();
+    void onMonitorItemCreated(VisualMonitorWidget *vmw);
     void onWorkspaceAssignmentChanged();
     void onSettingsChanged();
     void onApplyClicked();
@@ -115,6 +125,8 @@ private slots:
     void onAboutClicked();
     void onQuitClicked();
     void onTrayIconActivated(QSystemTrayIcon::ActivationReason reason);
+    // Applies the saved layout unless the daemon does
+    void onMonitorHotplug();
 
 private:
     void setupUI();
@@ -129,14 +141,28 @@ private:
     void updateWorkspaceAssignments();
     void showNotification(const QString &message, bool isError = false);
     void closeEvent(QCloseEvent *event) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
+    void loadWarmStartCache();
+    // Overlay the parsed monitors.conf on the working copy
+    void mergeMonitorsConf();
+    // Select the parsed workspace rules in the assignment boxes
+    void applyWorkspacesConf();
+    // Copy the resolution and refresh rate from the panel, keeping the exact
+    // live rate while the picked rate is still the one it rounds to
+    void applySelectedMode(DisplayInfo &di) const;
+    void saveWarmStartCache();
 
     // UI Elements
     QWidget *m_centralWidget;
     QVBoxLayout *m_mainLayout;
     QGraphicsScene *m_monitorLayoutScene;
     QGraphicsView *m_monitorLayoutView;
-    QList<VisualMonitorWidget*> m_monitorProxyWidgets;
+    MonitorSceneSync *m_sceneSync;
     QMap<QString, QPointF> m_monitorPositions;
+    QSizeF m_warmViewSize;  // view size of the last session, used until the window is laid out
+    bool m_showingCachedLayout = false;
+    bool m_haveLiveMonitors = false;
+    QString m_pendingProfile;
     
     // Monitor settings panel
     QWidget *m_monitorSettingsPanel;
@@ -160,11 +186,15 @@ private:
     QLabel *m_statusLabel;
     QSystemTrayIcon *m_trayIcon;
     QMenu *m_trayMenu;
+    QTimer *m_eventRefreshTimer;
     
     // Core components
     DisplayManager *m_displayManager;
     HyprlandInterface *m_hyprlandInterface;
     ConfigManager *m_configManager;
+    HotplugProfileApplier *m_hotplugApplier = nullptr;
+    ControlServer *m_controlServer = nullptr;
+    QTimer *m_controlRetryTimer = nullptr;  // runs while a daemon holds the control socket
     
     // Settings
     QSettings *m_settings;
@@ -196,7 +226,6 @@ private:
     QPushButton *m_applyButton;
     QPushButton *m_resetButton;
 
-    QList<DisplayInfo> m_currentDisplays;
 
     int m_layoutMinX = 0;
     int m_layoutMinY = 0;
@@ -0,0 +1,73 @@
+#include "modetable.h"
+#include <algorithm>
+
+bool DisplayMode::parse(const QString &mode, DisplayMode &out)
+{
+    const int x = mode.indexOf('x');
+    const int at = mode.indexOf('@', x + 1);
+    if (x <= 0 || at <= x + 1) {
+        return false;
+    }
+    
+    bool okWidth = false;
+    bool okHeight = false;
+    bool okRefresh = false;
+    out.width = QStringView(mode).left(x).toInt(&okWidth);
+    out.height = QStringView(mode).mid(x + 1, at - x - 1).toInt(&okHeight);
+    
+    QStringView rate = QStringView(mode).mid(at + 1).trimmed();
+    if (rate.endsWith(QLatin1String("Hz"))) rate.chop(2);
+    out.refreshMilliHz = ModeTable::toMilliHertz(rate.trimmed().toDouble(&okRefresh));
+    return okWidth && okHeight && okRefresh && out.width > 0 && out.height > 0;
+}
+
+QSharedPointer<const ModeTable> ModeTable::fromModes(const QList<QString> &modes)
+{
+    QSharedPointer<ModeTable> table(new ModeTable);
+    QList<DisplayMode> parsed;
+    parsed.reserve(modes.size());
+    for (const QString &text : modes) {
+        DisplayMode mode;
+        if (DisplayMode::parse(text, mode)) {
+            parsed.append(mode);
+        }
+    }
+    
+    std::sort(parsed.begin(), parsed.end(), [](const DisplayMode &a, const DisplayMode &b) {
+        if (a.width != b.width) return a.width > b.width;
+        if (a.height != b.height) return a.height > b.height;
+        return a.refreshMilliHz > b.refreshMilliHz;
+    });
+    
+    for (const DisplayMode &mode : std::as_const(parsed)) {
+        const QString resolution = mode.resolution();
+        QList<int> &rates = table->m_refreshRates[resolution];
+        if (rates.isEmpty()) {
+            table->m_resolutions.append(resolution);
+        }
+        if (rates.isEmpty() || rates.last() != mode.refreshMilliHz) {
+            rates.append(mode.refreshMilliHz);
+        }
+    }
+    return table;
+}
+
+int ModeTable::closestRefresh(const QString &resolution, double refreshHz) const
+{
+    const int target = toMilliHertz(refreshHz);
+    int best = 0;
+    int bestDistance = 1000;
+    for (int rate : m_refreshRates.value(resolution)) {
+        int distance = qAbs(rate - target);
+        if (distance < bestDistance) {
+            best = rate;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+QString ModeTable::formatRefresh(int milliHz)
+{
+    return QString("%1 Hz").arg(toHertz(milliHz), 0, 'f', 2);
+}
@@ -0,0 +1,48 @@
+#ifndef MODETABLE_H
+#define MODETABLE_H
+
+#include <QHash>
+#include <QList>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+
+// One entry of a monitor's availableModes, e.g. "2560x1440@143.97Hz"
+struct DisplayMode {
+    int width = 0;
+    int height = 0;
+    int refreshMilliHz = 0;  // exact, 143.973 Hz -> 143973
+    
+    QString resolution() const { return QString("%1x%2").arg(width).arg(height); }
+    static bool parse(const QString &mode, DisplayMode &out);
+};
+
+// The modes of one monitor, parsed once when the monitor list is read.
+// Resolutions are sorted largest first and each has its refresh rates sorted
+// highest first, so the settings panel only does lookups.
+class ModeTable
+{
+public:
+    static QSharedPointer<const ModeTable> fromModes(const QList<QString> &modes);
+    
+    const QStringList &resolutions() const { return m_resolutions; }
+    QList<int> refreshRates(const QString &resolution) const { return m_refreshRates.value(resolution); }
+    bool contains(const QString &resolution) const { return m_refreshRates.contains(resolution); }
+    bool isEmpty() const { return m_resolutions.isEmpty(); }
+    
+    // Refresh rate of resolution closest to refreshHz, or 0 if none is within 1 Hz
+    int closestRefresh(const QString &resolution, double refreshHz) const;
+    
+    static int toMilliHertz(double hz) { return qRound(hz * 1000.0); }
+    static double toHertz(int milliHz) { return milliHz / 1000.0; }
+    // "59.94 Hz", the precision hyprctl prints
+    static QString formatRefresh(int milliHz);
+
+private:
+    QStringList m_resolutions;
+    QHash<QString, QList<int>> m_refreshRates;
+};
+
+using ModeTablePtr = QSharedPointer<const ModeTable>;
+
+#endif // MODETABLE_H
@@ -0,0 +1,366 @@
+#include "monitorjsondecoder.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+namespace {
+
+// Pull reader over the reply bytes. Every read either consumes a complete
+// value or records an error, after which all further reads fail.
+class Reader
+{
+public:
+    Reader(const char *begin, const char *end)
+        : m_begin(begin), m_pos(begin), m_end(end) {}
+
+    bool failed() const { return !m_error.isEmpty(); }
+    QString error() const { return m_error; }
+
+    void fail(const char *what)
+    {
+        if (m_error.isEmpty()) {
+            m_error = QString("%1 at offset %2").arg(QLatin1String(what)).arg(m_pos - m_begin);
+        }
+    }
+
+    char peek()
+    {
+        while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t')) {
+            ++m_pos;
+        }
+        return m_pos < m_end ? *m_pos : '\0';
+    }
+
+    bool atEnd() { return peek() == '\0' && m_pos >= m_end; }
+
+    bool consume(char c)
+    {
+        if (failed() || peek() != c) return false;
+        ++m_pos;
+        return true;
+    }
+
+    bool expect(char c, const char *what)
+    {
+        if (consume(c)) return true;
+        fail(what);
+        return false;
+    }
+
+    // Advances to the next member of an object whose '{' was consumed.
+    // Returns false at '}' or on error. Keys containing escapes come back
+    // empty, so they never match a field.
+    bool nextMember(std::string_view &key, bool &first)
+    {
+        if (failed() || consume('}')) return false;
+        if (!first && !expect(',', "Expected ',' or '}'")) return false;
+        first = false;
+
+        const char *start = nullptr;
+        const char *stop = nullptr;
+        bool escaped = false;
+        if (peek() != '"' || !readRawString(start, stop, escaped)) {
+            fail("Expected an object key");
+            return false;
+        }
+        key = escaped ? std::string_view() : std::string_view(start, stop - start);
+        return expect(':', "Expected ':'");
+    }
+
+    // Same for the elements of an array whose '[' was consumed
+    bool nextElement(bool &first)
+    {
+        if (failed() || consume(']')) return false;
+        if (!first && !expect(',', "Expected ',' or ']'")) return false;
+        first = false;
+        return true;
+    }
+
+    // Values of another JSON type are skipped and give the fallback, as QJsonValue does
+    QString readString()
+    {
+        if (peek() != '"') {
+            skipValue();
+            return QString();
+        }
+        const char *start = nullptr;
+        const char *stop = nullptr;
+        bool escaped = false;
+        if (!readRawString(start, stop, escaped)) return QString();
+        return escaped ? unescape(start, stop) : QString::fromUtf8(start, stop - start);
+    }
+
+    double readDouble(double fallback = 0.0)
+    {
+        const char c = peek();
+        if (c != '-' && (c < '0' || c > '9')) {
+            skipValue();
+            return fallback;
+        }
+        const char *start = m_pos;
+        skipNumber();
+        double value = 0.0;
+        auto result = std::from_chars(start, m_pos, value);
+        if (result.ec != std::errc() || result.ptr != m_pos) {
+            fail("Invalid number");
+            return fallback;
+        }
+        return value;
+    }
+
+    int readInt(int fallback = 0)
+    {
+        double value = readDouble(std::numeric_limits<double>::quiet_NaN());
+        if (std::isnan(value) || std::floor(value) != value
+            || std::fabs(value) > std::numeric_limits<int>::max()) {
+            return fallback;
+        }
+        return static_cast<int>(value);
+    }
+
+    bool readBool(bool fallback = false)
+    {
+        const char c = peek();
+        if (c == 't' && matchLiteral("true")) return true;
+        if (c == 'f' && matchLiteral("false")) return false;
+        skipValue();
+        return fallback;
+    }
+
+    void skipValue()
+    {
+        if (++m_depth > MaxDepth) {
+            fail("Nesting too deep");
+        }
+
+        const char c = peek();
+        if (failed()) {
+            // Nothing to do
+        } else if (c == '"') {
+            const char *start = nullptr;
+            const char *stop = nullptr;
+            bool escaped = false;
+            readRawString(start, stop, escaped);
+        } else if (c == '{') {
+            ++m_pos;
+            bool first = true;
+            std::string_view key;
+            while (nextMember(key, first)) skipValue();
+        } else if (c == '[') {
+            ++m_pos;
+            bool first = true;
+            while (nextElement(first)) skipValue();
+        } else if (c == '-' || (c >= '0' && c <= '9')) {
+            skipNumber();
+        } else if (!matchLiteral("true") && !matchLiteral("false") && !matchLiteral("null")) {
+            fail("Unexpected character");
+        }
+        --m_depth;
+    }
+
+private:
+    static constexpr int MaxDepth = 64;
+
+    bool readRawString(const char *&start, const char *&stop, bool &escaped)
+    {
+        ++m_pos;  // opening quote
+        start = m_pos;
+        while (m_pos < m_end) {
+            if (*m_pos == '"') {
+                stop = m_pos++;
+                return true;
+            }
+            if (*m_pos == '\\') {
+                escaped = true;
+                if (m_end - m_pos < 2) break;
+                m_pos += 2;
+                continue;
+            }
+            ++m_pos;
+        }
+        fail("Unterminated string");
+        return false;
+    }
+
+    QString unescape(const char *start, const char *stop)
+    {
+        QString out;
+        out.reserve(stop - start);
+        const char *chunk = start;
+        for (const char *p = start; p < stop; ++p) {
+            if (*p != '\\') continue;
+            out += QString::fromUtf8(chunk, p - chunk);
+            const char e = *++p;
+            switch (e) {
+            case 'b': out += QChar('\b'); break;
+            case 'f': out += QChar('\f'); break;
+            case 'n': out += QChar('\n'); break;
+            case 'r': out += QChar('\r'); break;
+            case 't': out += QChar('\t'); break;
+            case 'u': {
+                // UTF-16 code unit; surrogate pairs combine in the QString
+                ushort unit = 0;
+                if (stop - p < 5 || std::from_chars(p + 1, p + 5, unit, 16).ptr != p + 5) {
+                    fail("Invalid \\u escape");
+                    return out;
+                }
+                out += QChar(unit);
+                p += 4;
+                break;
+            }
+            default: out += QChar::fromLatin1(e); break;
+            }
+            chunk = p + 1;
+        }
+        out += QString::fromUtf8(chunk, stop - chunk);
+        return out;
+    }
+
+    void skipNumber()
+    {
+        while (m_pos < m_end) {
+            const char c = *m_pos;
+            if ((c < '0' || c > '9') && c != '-' && c != '+' && c != '.' && c != 'e' && c != 'E') break;
+            ++m_pos;
+        }
+    }
+
+    bool matchLiteral(std::string_view literal)
+    {
+        if (static_cast<size_t>(m_end - m_pos) < literal.size()
+            || std::memcmp(m_pos, literal.data(), literal.size()) != 0) {
+            return false;
+        }
+        m_pos += literal.size();
+        return true;
+    }
+
+    const char *m_begin;
+    const char *m_pos;
+    const char *m_end;
+    int m_depth = 0;
+    QString m_error;
+};
+
+QString readWorkspaceName(Reader &reader)
+{
+    if (reader.peek() != '{') {
+        reader.skipValue();
+        return QString();
+    }
+    reader.consume('{');
+    QString name;
+    bool first = true;
+    std::string_view key;
+    while (reader.nextMember(key, first)) {
+        if (key == "name") name = reader.readString();
+        else reader.skipValue();
+    }
+    return name;
+}
+
+QList<QString> readStringArray(Reader &reader)
+{
+    QList<QString> values;
+    if (reader.peek() != '[') {
+        reader.skipValue();
+        return values;
+    }
+    reader.consume('[');
+    bool first = true;
+    while (reader.nextElement(first)) {
+        values.append(reader.readString());
+    }
+    return values;
+}
+
+using FieldReader = void (*)(Reader &, DisplayInfo &);
+
+struct Field {
+    std::string_view key;
+    FieldReader read;
+};
+
+// Sorted by key for the binary search in findField()
+const Field Fields[] = {
+    {"activeWorkspace", [](Reader &r, DisplayInfo &d) { d.workspace = readWorkspaceName(r); }},
+    {"availableModes",  [](Reader &r, DisplayInfo &d) { d.availableModes = readStringArray(r); }},
+    {"description",     [](Reader &r, DisplayInfo &d) { d.description = r.readString(); }},
+    {"disabled",        [](Reader &r, DisplayInfo &d) { d.setEnabled(!r.readBool()); }},
+    {"focused",         [](Reader &r, DisplayInfo &d) { d.setPrimary(r.readBool()); }},
+    {"hdr",             [](Reader &r, DisplayInfo &d) { d.setHdr(r.readBool()); }},
+    {"height",          [](Reader &r, DisplayInfo &d) { d.height = r.readInt(); }},
+    {"make",            [](Reader &r, DisplayInfo &d) { d.manufacturer = r.readString(); }},
+    {"mirrorOf",        [](Reader &r, DisplayInfo &d) { d.mirrorOf = r.readString(); }},
+    {"model",           [](Reader &r, DisplayInfo &d) { d.model = r.readString(); }},
+    {"name",            [](Reader &r, DisplayInfo &d) { d.name = r.readString(); }},
+    {"refreshRate",     [](Reader &r, DisplayInfo &d) { d.refreshRate = r.readDouble(); }},
+    {"scale",           [](Reader &r, DisplayInfo &d) { d.scale = r.readDouble(); }},
+    {"sdrBrightness",   [](Reader &r, DisplayInfo &d) { d.sdrBrightness = r.readDouble(1.0); }},
+    {"sdrSaturation",   [](Reader &r, DisplayInfo &d) { d.sdrSaturation = r.readDouble(1.0); }},
+    {"serial",          [](Reader &r, DisplayInfo &d) { d.serial = r.readString(); }},
+    {"tenBit",          [](Reader &r, DisplayInfo &d) { d.setTenBit(r.readBool()); }},
+    {"transform",       [](Reader &r, DisplayInfo &d) {
+        int value = r.readInt();
+        d.transform = (value >= 0 && value <= 7) ? static_cast<DisplayTransform>(value) : DisplayTransform::Normal;
+    }},
+    // Hyprland only reports "vrr" for outputs that support it
+    {"vrr",             [](Reader &r, DisplayInfo &d) { d.setVrrCapable(true); r.skipValue(); }},
+    {"vrrMode",         [](Reader &r, DisplayInfo &d) { d.vrrMode = r.readInt(); }},
+    {"wideGamut",       [](Reader &r, DisplayInfo &d) { d.setWideGamut(r.readBool()); }},
+    {"width",           [](Reader &r, DisplayInfo &d) { d.width = r.readInt(); }},
+    {"x",               [](Reader &r, DisplayInfo &d) { d.x = r.readInt(); }},
+    {"y",               [](Reader &r, DisplayInfo &d) { d.y = r.readInt(); }},
+};
+
+const Field *findField(std::string_view key)
+{
+    auto it = std::lower_bound(std::begin(Fields), std::end(Fields), key,
+                               [](const Field &field, std::string_view k) { return field.key < k; });
+    return (it != std::end(Fields) && it->key == key) ? it : nullptr;
+}
+
+} // namespace
+
+bool MonitorJsonDecoder::decode(QByteArrayView json, QList<DisplayInfo> &displays, QString *error)
+{
+    displays.clear();
+    Reader reader(json.data(), json.data() + json.size());
+
+    if (reader.expect('[', "Expected an array of monitors")) {
+        bool first = true;
+        while (reader.nextElement(first)) {
+            if (!reader.expect('{', "Expected a monitor object")) break;
+
+            DisplayInfo display;
+            display.setEnabled(true);
+            display.setHdrCapable(true);
+            bool firstMember = true;
+            std::string_view key;
+            while (reader.nextMember(key, firstMember)) {
+                if (const Field *field = findField(key)) {
+                    field->read(reader, display);
+                } else {
+                    reader.skipValue();
+                }
+            }
+            if (reader.failed()) break;
+
+            display.modeTable = ModeTable::fromModes(display.availableModes);
+            displays.append(std::move(display));
+        }
+        if (!reader.failed() && !reader.atEnd()) {
+            reader.fail("Unexpected data after the monitor array");
+        }
+    }
+
+    if (reader.failed()) {
+        if (error) *error = reader.error();
+        displays.clear();
+        return false;
+    }
+    return true;
+}
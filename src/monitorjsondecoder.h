@@ -0,0 +1,21 @@
+#ifndef MONITORJSONDECODER_H
+#define MONITORJSONDECODER_H
+
+#include <QByteArrayView>
+#include <QList>
+#include <QString>
+
+#include "displaymanager.h"
+
+// Decodes the reply of `hyprctl monitors -j` straight from the raw bytes in a
+// single pass. Known keys are dispatched through a sorted field table into
+// DisplayInfo; unknown keys and their values are skipped without allocating.
+class MonitorJsonDecoder
+{
+public:
+    // Replaces displays with the monitors in json, in reply order.
+    // Returns false and sets error if json is not an array of objects.
+    static bool decode(QByteArrayView json, QList<DisplayInfo> &displays, QString *error = nullptr);
+};
+
+#endif // MONITORJSONDECODER_H
@@ -0,0 +1,120 @@
+#include "monitorscenesync.h"
+#include "visualmonitorwidget.h"
+#include <QGraphicsScene>
+#include <QElapsedTimer>
+#include <QSet>
+#include <algorithm>
+#include <climits>
+
+MonitorLayoutTransform MonitorLayoutTransform::fit(const QList<DisplayInfo> &displays, const QSizeF &viewSize)
+{
+    MonitorLayoutTransform layout;
+    if (displays.isEmpty()) {
+        return layout;
+    }
+    
+    // 1. Calculate logical bounding box
+    int minX = INT_MAX, minY = INT_MAX, maxX = INT_MIN, maxY = INT_MIN;
+    for (const DisplayInfo &d : displays) {
+        minX = std::min(minX, d.x);
+        minY = std::min(minY, d.y);
+        maxX = std::max(maxX, d.x + d.width);
+        maxY = std::max(maxY, d.y + d.height);
+    }
+    const qreal boundsWidth = std::max(1, maxX - minX);
+    const qreal boundsHeight = std::max(1, maxY - minY);
+    
+    // 2. Calculate scale factor to fill the view (allow scaling up)
+    const qreal margin = 10.0;
+    qreal scaleX = (viewSize.width() - 2 * margin) / boundsWidth;
+    qreal scaleY = (viewSize.height() - 2 * margin) / boundsHeight;
+    
+    layout.minX = minX;
+    layout.minY = minY;
+    layout.scale = std::max<qreal>(0.001, std::min(scaleX, scaleY));
+    
+    // 3. Center the arrangement in the view
+    layout.offsetX = (viewSize.width() - boundsWidth * layout.scale) / 2.0;
+    layout.offsetY = (viewSize.height() - boundsHeight * layout.scale) / 2.0;
+    return layout;
+}
+
+QPointF MonitorLayoutTransform::toScene(int x, int y) const
+{
+    return QPointF(offsetX + (x - minX) * scale, offsetY + (y - minY) * scale);
+}
+
+MonitorSceneSync::MonitorSceneSync(QGraphicsScene *scene, QObject *parent)
+    : QObject(parent)
+    , m_scene(scene)
+{
+}
+
+MonitorSceneSync::Stats MonitorSceneSync::sync(const QList<DisplayInfo> &displays, const QSizeF &viewSize)
+{
+    QElapsedTimer timer;
+    timer.start();
+    Stats stats;
+    
+    m_layout = MonitorLayoutTransform::fit(displays, viewSize);
+    
+    QSet<QString> present;
+    present.reserve(displays.size());
+    for (const DisplayInfo &display : displays) {
+        present.insert(display.name);
+    }
+    for (auto it = m_items.begin(); it != m_items.end();) {
+        if (present.contains(it.key())) {
+            ++it;
+            continue;
+        }
+        m_scene->removeItem(it.value());
+        delete it.value();
+        it = m_items.erase(it);
+        ++stats.removed;
+    }
+    
+    for (const DisplayInfo &display : displays) {
+        VisualMonitorWidget *item = m_items.value(display.name, nullptr);
+        if (!item) {
+            item = new VisualMonitorWidget(display.name, display.resolution(), display.width, display.height,
+                                           nullptr, m_layout.scale);
+            m_scene->addItem(item);
+            m_items.insert(display.name, item);
+            ++stats.added;
+            emit itemCreated(item);
+        } else {
+            ++stats.updated;
+        }
+        applyDisplay(item, display);
+    }
+    
+    stats.elapsedUs = timer.nsecsElapsed() / 1000;
+    return stats;
+}
+
+void MonitorSceneSync::clear()
+{
+    for (VisualMonitorWidget *item : std::as_const(m_items)) {
+        m_scene->removeItem(item);
+        delete item;
+    }
+    m_items.clear();
+}
+
+void MonitorSceneSync::applyDisplay(VisualMonitorWidget *item, const DisplayInfo &display)
+{
+    // Every setter is a no-op when the value is unchanged
+    item->setResolution(display.resolution(), display.width, display.height);
+    item->setScaleFactor(m_layout.scale);
+    item->setPrimary(display.isPrimary());
+    item->setEnabled(display.isEnabled());
+    item->setScale(display.scale);
+    item->setTransform(display.transformName());
+    item->setHDR(display.isHdr());
+    item->setSDRBrightness(display.sdrBrightness);
+    item->setSDRSaturation(display.sdrSaturation);
+    item->setTenBit(display.isTenBit());
+    item->setWideGamut(display.isWideGamut());
+    item->setPos(m_layout.toScene(display.x, display.y));
+}
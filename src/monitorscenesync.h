@@ -0,0 +1,64 @@
+#ifndef MONITORSCENESYNC_H
+#define MONITORSCENESYNC_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QPointF>
+#include <QSizeF>
+
+#include "displaymanager.h"
+
+class QGraphicsScene;
+class VisualMonitorWidget;
+
+// Maps logical monitor coordinates onto the layout view so the whole
+// arrangement fits and is centered
+struct MonitorLayoutTransform {
+    int minX = 0;
+    int minY = 0;
+    qreal scale = 0.1;
+    qreal offsetX = 0.0;
+    qreal offsetY = 0.0;
+    
+    static MonitorLayoutTransform fit(const QList<DisplayInfo> &displays, const QSizeF &viewSize);
+    QPointF toScene(int x, int y) const;
+};
+
+// Keeps one VisualMonitorWidget per monitor in the scene. sync() moves and
+// restyles existing items in place and only creates or deletes items when
+// monitors appear or disappear.
+class MonitorSceneSync : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Stats {
+        int added = 0;
+        int removed = 0;
+        int updated = 0;
+        qint64 elapsedUs = 0;
+    };
+    
+    explicit MonitorSceneSync(QGraphicsScene *scene, QObject *parent = nullptr);
+    
+    Stats sync(const QList<DisplayInfo> &displays, const QSizeF &viewSize);
+    void clear();
+    
+    VisualMonitorWidget *item(const QString &name) const { return m_items.value(name, nullptr); }
+    const QHash<QString, VisualMonitorWidget *> &items() const { return m_items; }
+    const MonitorLayoutTransform &layout() const { return m_layout; }
+
+signals:
+    // Emitted once per new item so the owner can connect to it
+    void itemCreated(VisualMonitorWidget *item);
+
+private:
+    void applyDisplay(VisualMonitorWidget *item, const DisplayInfo &display);
+    
+    QGraphicsScene *m_scene;
+    QHash<QString, VisualMonitorWidget *> m_items;
+    MonitorLayoutTransform m_layout;
+};
+
+#endif // MONITORSCENESYNC_H
@@ -0,0 +1,146 @@
+#include "monitorsconfwriter.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+
+namespace {
+
+// Monitor name of a rule value, "DP-1, 2560x1440@144, 0x0, 1" -> "DP-1"
+QString ruleName(QByteArrayView value)
+{
+    qsizetype comma = 0;
+    while (comma < value.size() && value.at(comma) != ',') ++comma;
+    return QString::fromUtf8(value.first(comma)).trimmed();
+}
+
+}
+
+MonitorsConfWriter::MonitorsConfWriter(const QString &path)
+    : m_path(path)
+{
+    QFile file(path);
+    m_exists = file.exists();
+    if (m_exists && file.open(QIODevice::ReadOnly)) {
+        m_original = file.readAll();
+    }
+    m_file = HyprConfigFile::parse(path, m_original, QFileInfo(path).lastModified());
+
+    for (int i = 0; i < m_file->lines.size(); ++i) {
+        const HyprConfigLine &line = m_file->lines.at(i);
+        if (!m_file->keyIs(line, "monitor")) continue;
+
+        const QString name = ruleName(m_file->value(line));
+        if (!m_lastRule.contains(name)) {
+            m_order.append(name);
+        }
+        m_lastRule.insert(name, i);
+    }
+}
+
+QString MonitorsConfWriter::rule(const QString &name) const
+{
+    auto added = m_addedIndex.constFind(name);
+    if (added != m_addedIndex.constEnd()) {
+        return QString::fromUtf8(m_added.at(added.value()));
+    }
+    auto existing = m_lastRule.constFind(name);
+    if (existing == m_lastRule.constEnd()) {
+        return QString();
+    }
+    auto replaced = m_replaced.constFind(existing.value());
+    if (replaced != m_replaced.constEnd()) {
+        return QString::fromUtf8(replaced.value());
+    }
+    return QString::fromUtf8(m_file->value(m_file->lines.at(existing.value())));
+}
+
+void MonitorsConfWriter::setRule(const QString &name, const QString &rule)
+{
+    const QByteArray value = rule.toUtf8();
+    auto existing = m_lastRule.constFind(name);
+    if (existing != m_lastRule.constEnd()) {
+        const int index = existing.value();
+        if (m_file->value(m_file->lines.at(index)).toByteArray() == value) {
+            m_replaced.remove(index);
+        } else {
+            m_replaced.insert(index, value);
+        }
+        return;
+    }
+
+    auto added = m_addedIndex.constFind(name);
+    if (added != m_addedIndex.constEnd()) {
+        m_added[added.value()] = value;
+        return;
+    }
+    m_addedIndex.insert(name, m_added.size());
+    m_added.append(value);
+    m_order.append(name);
+}
+
+QByteArray MonitorsConfWriter::contents() const
+{
+    if (m_replaced.isEmpty() && m_added.isEmpty()) {
+        return m_original;
+    }
+
+    const QByteArray &data = m_file->data;
+    QByteArray out;
+    out.reserve(data.size() + 64 * m_added.size());
+
+    QList<int> replacedLines = m_replaced.keys();
+    std::sort(replacedLines.begin(), replacedLines.end());
+    qsizetype copied = 0;
+    for (int index : replacedLines) {
+        const HyprConfigLine &line = m_file->lines.at(index);
+        out.append(data.constData() + copied, line.valueStart - copied);
+        out.append(m_replaced.value(index));
+        copied = line.valueStart + line.valueLength;
+    }
+
+    if (m_added.isEmpty()) {
+        out.append(data.constData() + copied, data.size() - copied);
+        return out;
+    }
+
+    // New rules go right after the last monitor= line, or at the end
+    qsizetype insertAt = data.size();
+    if (!m_lastRule.isEmpty()) {
+        int lastLine = -1;
+        for (int index : m_lastRule) {
+            lastLine = std::max(lastLine, index);
+        }
+        const HyprConfigLine &line = m_file->lines.at(lastLine);
+        const qsizetype newline = data.indexOf('\n', line.valueStart + line.valueLength);
+        insertAt = newline < 0 ? data.size() : newline + 1;
+    }
+    out.append(data.constData() + copied, insertAt - copied);
+    if (!out.isEmpty() && !out.endsWith('\n')) {
+        out.append('\n');
+    }
+    for (const QByteArray &value : m_added) {
+        out.append("monitor=");
+        out.append(value);
+        out.append('\n');
+    }
+    out.append(data.constData() + insertAt, data.size() - insertAt);
+    return out;
+}
+
+MonitorsConfWriter::SaveResult MonitorsConfWriter::save(QString *error) const
+{
+    const QByteArray out = contents();
+    if (m_exists && out == m_original) {
+        return Unchanged;
+    }
+
+    // QSaveFile writes next to the target and renames on commit, following
+    // a symlinked monitors.conf and keeping its permissions
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(out) != out.size() || !file.commit()) {
+        if (error) *error = file.errorString();
+        return Failed;
+    }
+    return Saved;
+}
@@ -0,0 +1,55 @@
+#ifndef MONITORSCONFWRITER_H
+#define MONITORSCONFWRITER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "hyprconfig.h"
+
+// Edits the monitor= rules of a monitors.conf in place. The file is kept as
+// the line model HyprConfig tokenizes it into; only the values of rules that
+// were replaced are rewritten, so comments, other keywords, ordering and
+// spacing survive byte for byte.
+class MonitorsConfWriter
+{
+public:
+    enum SaveResult {
+        Unchanged,  // contents are byte-identical, the file was not touched
+        Saved,
+        Failed
+    };
+
+    // Reads path; a missing file starts out empty
+    explicit MonitorsConfWriter(const QString &path);
+
+    QString path() const { return m_path; }
+    QStringList monitors() const { return m_order; }
+    // Value of the last monitor= rule for name, as written. Null if there is none.
+    QString rule(const QString &name) const;
+    // Replaces the value of the last rule for name, or adds a rule after the
+    // last existing one
+    void setRule(const QString &name, const QString &rule);
+
+    QByteArray contents() const;
+    bool isModified() const { return contents() != m_original; }
+
+    // Writes through a temporary file that is renamed over path, unless the
+    // result matches what is on disk
+    SaveResult save(QString *error = nullptr) const;
+
+private:
+    QString m_path;
+    bool m_exists = false;
+    QByteArray m_original;
+    HyprConfigFilePtr m_file;
+    QHash<QString, int> m_lastRule;     // monitor name -> index into m_file->lines
+    QStringList m_order;                // names in file order, then added ones
+    QHash<int, QByteArray> m_replaced;  // line index -> new value
+    QList<QByteArray> m_added;
+    QHash<QString, int> m_addedIndex;   // monitor name -> index into m_added
+};
+
+#endif // MONITORSCONFWRITER_H
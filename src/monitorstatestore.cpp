@@ -0,0 +1,106 @@
+#include "monitorstatestore.h"
+
+QSharedPointer<const MonitorSnapshot> MonitorSnapshot::create(const QList<DisplayInfo> &displays, quint64 version)
+{
+    auto snapshot = QSharedPointer<MonitorSnapshot>::create();
+    snapshot->version = version;
+    snapshot->displays = displays;
+    snapshot->indexByName.reserve(displays.size());
+    for (int i = 0; i < displays.size(); ++i) {
+        snapshot->indexByName.insert(displays.at(i).name, i);
+    }
+    return snapshot;
+}
+
+const DisplayInfo *MonitorSnapshot::find(const QString &name) const
+{
+    int index = indexOf(name);
+    return index >= 0 ? &displays.at(index) : nullptr;
+}
+
+MonitorChangeSet MonitorChangeSet::between(const MonitorSnapshot &from, const MonitorSnapshot &to)
+{
+    MonitorChangeSet changes;
+    changes.fromVersion = from.version;
+    changes.toVersion = to.version;
+    
+    for (const DisplayInfo &display : to.displays) {
+        const DisplayInfo *previous = from.find(display.name);
+        if (!previous) {
+            changes.added.append(display.name);
+            continue;
+        }
+        DisplayFields fields = display.diff(*previous);
+        if (fields) {
+            changes.changed.insert(display.name, fields);
+        }
+    }
+    for (const DisplayInfo &display : from.displays) {
+        if (!to.contains(display.name)) {
+            changes.removed.append(display.name);
+        }
+    }
+    
+    // Only the same monitors, duplicate names included, can be reordered
+    QStringList fromNames;
+    QStringList toNames;
+    for (const DisplayInfo &display : from.displays) fromNames.append(display.name);
+    for (const DisplayInfo &display : to.displays) toNames.append(display.name);
+    QStringList sortedFrom = fromNames;
+    QStringList sortedTo = toNames;
+    sortedFrom.sort();
+    sortedTo.sort();
+    if (changes.added.isEmpty() && changes.removed.isEmpty() && sortedFrom == sortedTo) {
+        const int count = qMin(fromNames.size(), toNames.size());
+        for (int i = 0; i < count; ++i) {
+            if (fromNames.at(i) != toNames.at(i)) {
+                changes.reordered = true;
+                break;
+            }
+        }
+    }
+    return changes;
+}
+
+MonitorStateStore::MonitorStateStore(QObject *parent)
+    : QObject(parent)
+    , m_current(QSharedPointer<const MonitorSnapshot>::create())
+{
+}
+
+MonitorChangeSet MonitorStateStore::publish(const QList<DisplayInfo> &displays)
+{
+    MonitorSnapshotPtr next = MonitorSnapshot::create(displays, m_current->version + 1);
+    MonitorChangeSet changes = MonitorChangeSet::between(*m_current, *next);
+    m_current = next;
+    emit published(changes);
+    return changes;
+}
+
+MonitorChangeSet MonitorStateStore::update(const DisplayInfo &display)
+{
+    QList<DisplayInfo> displays = m_current->displays;
+    int index = m_current->indexOf(display.name);
+    if (index >= 0) {
+        displays[index] = display;
+    } else {
+        displays.append(display);
+    }
+    return publish(displays);
+}
+
+MonitorChangeSet MonitorStateStore::remove(const QString &name)
+{
+    int index = m_current->indexOf(name);
+    if (index < 0) {
+        return MonitorChangeSet();
+    }
+    QList<DisplayInfo> displays = m_current->displays;
+    displays.removeAt(index);
+    return publish(displays);
+}
+
+MonitorChangeSet MonitorStateStore::clear()
+{
+    return publish(QList<DisplayInfo>());
+}
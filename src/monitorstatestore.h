@@ -0,0 +1,68 @@
+#ifndef MONITORSTATESTORE_H
+#define MONITORSTATESTORE_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QSharedPointer>
+#include <QStringList>
+
+#include "displaymanager.h"
+
+// One published version of the monitor list. Snapshots are never modified
+// after publication, so readers can hold on to them without copying.
+struct MonitorSnapshot {
+    quint64 version = 0;
+    QList<DisplayInfo> displays;
+    QHash<QString, int> indexByName;
+    
+    static QSharedPointer<const MonitorSnapshot> create(const QList<DisplayInfo> &displays, quint64 version);
+    
+    int indexOf(const QString &name) const { return indexByName.value(name, -1); }
+    const DisplayInfo *find(const QString &name) const;
+    bool contains(const QString &name) const { return indexByName.contains(name); }
+    bool isEmpty() const { return displays.isEmpty(); }
+    int size() const { return displays.size(); }
+};
+
+using MonitorSnapshotPtr = QSharedPointer<const MonitorSnapshot>;
+
+// What changed between two consecutive snapshots
+struct MonitorChangeSet {
+    quint64 fromVersion = 0;
+    quint64 toVersion = 0;
+    QStringList added;
+    QStringList removed;
+    QHash<QString, DisplayFields> changed;  // monitors present in both versions
+    bool reordered = false;
+    
+    bool isEmpty() const { return added.isEmpty() && removed.isEmpty() && changed.isEmpty() && !reordered; }
+    static MonitorChangeSet between(const MonitorSnapshot &from, const MonitorSnapshot &to);
+};
+
+// Holds the current monitor list as an immutable, implicitly shared snapshot.
+// snapshot() is O(1); writers build the next version and publish it together
+// with the change set against the previous one. GUI thread only.
+class MonitorStateStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MonitorStateStore(QObject *parent = nullptr);
+    
+    MonitorSnapshotPtr snapshot() const { return m_current; }
+    quint64 version() const { return m_current->version; }
+    
+    MonitorChangeSet publish(const QList<DisplayInfo> &displays);
+    MonitorChangeSet update(const DisplayInfo &display);
+    MonitorChangeSet remove(const QString &name);
+    MonitorChangeSet clear();
+
+signals:
+    void published(const MonitorChangeSet &changes);
+
+private:
+    MonitorSnapshotPtr m_current;
+};
+
+#endif // MONITORSTATESTORE_H
@@ -0,0 +1,229 @@
+#include "singleinstance.h"
+#include "controlserver.h"
+#include <QCoreApplication>
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QLockFile>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QThread>
+
+namespace {
+
+// From lock to listen the window takes a few hundred ms; past this it is hung
+const int HandOffTimeoutMs = 2000;
+// A request is one short line
+const qint64 MaxRequestBytes = 64 * 1024;
+
+// Only what a running window can act on; the other options are for a new one
+QJsonObject requestFromArguments(const QStringList &arguments)
+{
+    QJsonObject params;
+    for (int i = 1; i < arguments.size(); ++i) {
+        const QString &argument = arguments.at(i);
+        if (argument == QLatin1String("--apply-profile") && i + 1 < arguments.size()) {
+            params["profile"] = arguments.at(++i);
+        } else if (argument.startsWith(QLatin1String("--apply-profile="))) {
+            params["profile"] = argument.mid(int(qstrlen("--apply-profile=")));
+        }
+    }
+    if (params.isEmpty()) {
+        params["show"] = true;
+    }
+    return params;
+}
+
+}
+
+SingleInstance::SingleInstance(const QString &directory, QObject *parent)
+    : QObject(parent)
+    , m_directory(directory)
+    , m_server(nullptr)
+{
+}
+
+SingleInstance::~SingleInstance()
+{
+}
+
+QString SingleInstance::defaultDirectory()
+{
+    QString runtimeDir = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+    if (runtimeDir.isEmpty()) {
+        runtimeDir = QDir::tempPath();
+    }
+    return runtimeDir + "/hyprdisplays";
+}
+
+QString SingleInstance::directory() const
+{
+    // Resolved on first use, once the environment has been looked at
+    return m_directory.isEmpty() ? defaultDirectory() : m_directory;
+}
+
+QString SingleInstance::lockPath() const
+{
+    return directory() + "/window.lock";
+}
+
+QString SingleInstance::socketPath() const
+{
+    return directory() + "/window.sock";
+}
+
+bool SingleInstance::isWindowLaunch(int argc, char *argv[])
+{
+    // Everything else runs next to a window: --help, --version, --dry-run,
+    // --exit-after-show, and options the parser is about to reject
+    static const char *const valueOptions[] = {"-m", "--monitors-path", "-n", "--num-ws", "--apply-profile",
+                                               // Taken by QApplication before our parser sees argv
+                                               "-platform", "-platformtheme", "-style", "-stylesheet",
+                                               "-qwindowgeometry", "-qwindowtitle", "-qwindowicon"};
+    static const char *const flagOptions[] = {"--startup-trace", "-reverse"};
+    for (int i = 1; i < argc; ++i) {
+        const QByteArray argument(argv[i]);
+        const int equals = argument.indexOf('=');
+        const QByteArray name = argument.startsWith("--") && equals > 0 ? argument.left(equals) : argument;
+        bool known = false;
+        for (const char *option : valueOptions) {
+            if (name == option) {
+                // A missing value is the parser's to report
+                known = name != argument || ++i < argc;
+            }
+        }
+        for (const char *option : flagOptions) {
+            known = known || argument == option;
+        }
+        if (!known) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int SingleInstance::claim(int argc, char *argv[])
+{
+    // Enough for the lock and one request; the window's QApplication is
+    // created once this one is gone
+    QCoreApplication app(argc, argv);
+    if (lock()) {
+        return -1;
+    }
+    QTextStream err(stderr);
+    return handOff(app.arguments(), err);
+}
+
+bool SingleInstance::lock()
+{
+    if (!m_lock) {
+        QDir().mkpath(directory());
+        m_lock = std::make_unique<QLockFile>(lockPath());
+        // The window holds the lock for the whole session, so age never makes
+        // it stale; a dead owner, or its pid reused by another program, does
+        m_lock->setStaleLockTime(0);
+    }
+    return m_lock->isLocked() || m_lock->tryLock(0);
+}
+
+bool SingleInstance::isLocked() const
+{
+    return m_lock && m_lock->isLocked();
+}
+
+bool SingleInstance::listen(QString *error)
+{
+    if (!isLocked()) {
+        if (error) *error = QString("%1 is not held by this process").arg(lockPath());
+        return false;
+    }
+    // Only the lock holder gets here, so a socket file left behind is ours to replace
+    QLocalServer::removeServer(socketPath());
+    m_server = new QLocalServer(this);
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(m_server, &QLocalServer::newConnection, this, &SingleInstance::onNewConnection);
+    if (!m_server->listen(socketPath())) {
+        if (error) *error = m_server->errorString();
+        // Nobody would answer a launch that finds the lock held, so let it
+        // take the lock and start its own window instead of waiting
+        delete m_server;
+        m_server = nullptr;
+        m_lock->unlock();
+        return false;
+    }
+    // The socket goes while the application object still exists; the lock with this object
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, m_server, &QLocalServer::close);
+    qInfo() << "Single-instance socket listening on" << socketPath();
+    return true;
+}
+
+int SingleInstance::handOff(const QStringList &arguments, QTextStream &err)
+{
+    const QJsonObject params = requestFromArguments(arguments);
+    QDeadlineTimer deadline(HandOffTimeoutMs);
+    QString error;
+    do {
+        QJsonValue result;
+        if (ControlServer::call(socketPath(), "activate", params, result, &error,
+                                int(qMax<qint64>(1, deadline.remainingTime())))) {
+            return 0;
+        }
+        if (lock()) {
+            return -1;
+        }
+        QThread::msleep(20);
+    } while (!deadline.hasExpired());
+
+    qint64 pid = 0;
+    m_lock->getLockInfo(&pid, nullptr, nullptr);
+    err << "HyprDisplays (pid " << pid << ") holds " << lockPath() << " but does not answer on "
+        << socketPath() << ": " << error << Qt::endl;
+    return 1;
+}
+
+void SingleInstance::onNewConnection()
+{
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+    }
+}
+
+void SingleInstance::onReadyRead(QLocalSocket *socket)
+{
+    if (!socket->canReadLine()) {
+        if (socket->bytesAvailable() > MaxRequestBytes) {
+            socket->abort();
+        }
+        return;
+    }
+    const QJsonObject request = QJsonDocument::fromJson(socket->readLine()).object();
+    const QJsonObject params = request.value("params").toObject();
+    const bool activate = request.value("method").toString() == QLatin1String("activate");
+
+    QJsonObject response;
+    response["jsonrpc"] = "2.0";
+    response["id"] = request.value("id");
+    if (activate) {
+        response["result"] = QJsonObject{{"pid", QCoreApplication::applicationPid()}};
+    } else {
+        response["error"] = QJsonObject{{"code", ControlServer::MethodNotFound},
+                                        {"message", "Only activate is understood here"}};
+    }
+    // The launcher exits on the answer; the window does the work after that
+    socket->write(QJsonDocument(response).toJson(QJsonDocument::Compact) + '\n');
+    socket->flush();
+    socket->disconnectFromServer();
+    if (!activate) {
+        return;
+    }
+    if (params.contains("profile")) {
+        emit applyProfileRequested(params.value("profile").toString());
+    } else {
+        emit showRequested();
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef SINGLEINSTANCE_H
+#define SINGLEINSTANCE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <memory>
+
+class QLocalServer;
+class QLocalSocket;
+class QLockFile;
+class QTextStream;
+
+// One window per session. The first window launch takes window.lock and
+// listens on window.sock next to it; a later launch, from a keybind say,
+// hands its request to that window and exits before a QApplication or a
+// hyprctl probe is made. One JSON-RPC line per connection:
+//
+//   activate {"show": true}                      raise the window, also from the tray
+//   activate {"profile": "<fingerprint|auto>"}   apply a saved layout
+//
+// QLockFile records the owner's pid and program name, so a lock left by a
+// window that was killed is taken over, and only the lock holder ever
+// replaces the socket file.
+class SingleInstance : public QObject
+{
+    Q_OBJECT
+
+public:
+    // directory holds window.lock and window.sock; empty is defaultDirectory()
+    explicit SingleInstance(const QString &directory = QString(), QObject *parent = nullptr);
+    ~SingleInstance();
+
+    // $XDG_RUNTIME_DIR/hyprdisplays
+    static QString defaultDirectory();
+    QString lockPath() const;
+    QString socketPath() const;
+
+    // Launches that open the window: only the window's own options, with
+    // nothing the parser would turn down. Any other launch runs next to a
+    // window instead
+    static bool isWindowLaunch(int argc, char *argv[]);
+
+    // Takes the lock, or hands the request in argv to the window holding it.
+    // Returns -1 when this process is now the instance, otherwise its exit
+    // code. Runs before QApplication is created.
+    int claim(int argc, char *argv[]);
+
+    // Takes the lock if nobody holds it, removing a stale one
+    bool lock();
+    bool isLocked() const;
+    // Called once the window can take requests; on failure the lock is
+    // released, so the next launch opens its own window
+    bool listen(QString *error = nullptr);
+
+signals:
+    void showRequested();
+    void applyProfileRequested(const QString &profile);
+
+private slots:
+    void onNewConnection();
+
+private:
+    QString directory() const;
+    // Retries while the lock holder is starting up and not listening yet;
+    // takes the lock after all if the holder exits meanwhile
+    int handOff(const QStringList &arguments, QTextStream &err);
+    void onReadyRead(QLocalSocket *socket);
+
+    QString m_directory;
+    std::unique_ptr<QLockFile> m_lock;
+    QLocalServer *m_server;
+};
+
+#endif // SINGLEINSTANCE_H
@@ -0,0 +1,326 @@
+#include "snapshotformat.h"
+#include "displaymanager.h"
+#include <QCborStreamReader>
+#include <QCborStreamWriter>
+#include <QCborValue>
+#include <QJsonDocument>
+#include <QJsonParseError>
+
+namespace {
+
+// Keys of a DisplayInfo map. Numbers are never reused: a removed field keeps
+// its number and a new one takes the next.
+enum DisplayKey : qint64 {
+    KeyName = 0,
+    KeyDescription,
+    KeyManufacturer,
+    KeyModel,
+    KeySerial,
+    KeyMirrorOf,
+    KeyWorkspace,
+    KeyAvailableModes,
+    KeyRefreshRate,
+    KeyScale,
+    KeySdrBrightness,
+    KeySdrSaturation,
+    KeyWidth,
+    KeyHeight,
+    KeyX,
+    KeyY,
+    KeyVrrMode,
+    KeyTransform,
+    KeyFlags,
+};
+
+void writeText(QCborStreamWriter &writer, DisplayKey key, const QString &value)
+{
+    if (value.isEmpty()) return;
+    writer.append(qint64(key));
+    writer.append(value);
+}
+
+void writeNumber(QCborStreamWriter &writer, DisplayKey key, qint64 value)
+{
+    if (value == 0) return;
+    writer.append(qint64(key));
+    writer.append(value);
+}
+
+void writeReal(QCborStreamWriter &writer, DisplayKey key, double value)
+{
+    writer.append(qint64(key));
+    writer.append(value);
+}
+
+}
+
+namespace SnapshotFormat {
+
+QString name(Format format)
+{
+    return format == Cbor ? QStringLiteral("cbor") : QStringLiteral("json");
+}
+
+Format fromName(const QString &name, Format fallback)
+{
+    if (name.compare(QLatin1String("cbor"), Qt::CaseInsensitive) == 0) return Cbor;
+    if (name.compare(QLatin1String("json"), Qt::CaseInsensitive) == 0) return Json;
+    return fallback;
+}
+
+bool isCbor(const QByteArray &data)
+{
+    // Self-describe tag 55799; no JSON text starts with 0xd9
+    return data.size() >= 3 && quint8(data.at(0)) == 0xd9 && quint8(data.at(1)) == 0xd9
+        && quint8(data.at(2)) == 0xf7;
+}
+
+QByteArray encode(const QJsonObject &object, Format format, const char *kind)
+{
+    if (format == Json) {
+        return QJsonDocument(object).toJson();
+    }
+    QByteArray data;
+    QCborStreamWriter writer(&data);
+    beginDocument(writer, kind);
+    writer.append("data");
+    QCborValue::fromJsonValue(object).toCbor(writer);
+    writer.endMap();
+    return data;
+}
+
+bool decode(const QByteArray &data, QJsonObject &object, QString *error)
+{
+    if (!isCbor(data)) {
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
+        if (!doc.isObject()) {
+            if (error) *error = doc.isNull() ? parseError.errorString() : QString("Not a JSON object");
+            return false;
+        }
+        object = doc.object();
+        return true;
+    }
+
+    QCborStreamReader reader(data);
+    if (!enterDocument(reader, error)) {
+        return false;
+    }
+    bool found = false;
+    while (reader.lastError() == QCborError::NoError && reader.hasNext()) {
+        if (readString(reader) == QLatin1String("data")) {
+            object = QCborValue::fromCbor(reader).toJsonValue().toObject();
+            found = true;
+        } else {
+            reader.next();
+        }
+    }
+    if (reader.lastError() != QCborError::NoError) {
+        if (error) *error = reader.lastError().toString();
+        return false;
+    }
+    if (!found) {
+        if (error) *error = QString("Snapshot has no data");
+        return false;
+    }
+    return true;
+}
+
+void beginDocument(QCborStreamWriter &writer, const char *kind)
+{
+    writer.append(QCborKnownTags::Signature);
+    writer.startMap();
+    writer.append("schema");
+    writer.append(qint64(SchemaVersion));
+    writer.append("kind");
+    writer.append(kind);
+}
+
+bool enterDocument(QCborStreamReader &reader, QString *error)
+{
+    if (reader.isTag() && reader.toTag() == QCborTag(QCborKnownTags::Signature)) {
+        reader.next();
+    }
+    if (!reader.isMap() || !reader.enterContainer()) {
+        if (error) *error = QString("Not a HyprDisplays snapshot");
+        return false;
+    }
+    // beginDocument() always writes the schema first
+    if (!reader.hasNext() || readString(reader) != QLatin1String("schema")) {
+        if (error) *error = QString("Snapshot has no schema version");
+        return false;
+    }
+    const qint64 schema = readInteger(reader, -1);
+    if (schema < 1 || schema > SchemaVersion) {
+        if (error) *error = QString("Unsupported snapshot schema %1").arg(schema);
+        return false;
+    }
+    return true;
+}
+
+void writeDisplay(QCborStreamWriter &writer, const DisplayInfo &display)
+{
+    // Empty strings and zero integers are left out; readers start from defaults
+    writer.startMap();
+    writeText(writer, KeyName, display.name);
+    writeText(writer, KeyDescription, display.description);
+    writeText(writer, KeyManufacturer, display.manufacturer);
+    writeText(writer, KeyModel, display.model);
+    writeText(writer, KeySerial, display.serial);
+    writeText(writer, KeyMirrorOf, display.mirrorOf);
+    writeText(writer, KeyWorkspace, display.workspace);
+    if (!display.availableModes.isEmpty()) {
+        writer.append(qint64(KeyAvailableModes));
+        writer.startArray(display.availableModes.size());
+        for (const QString &mode : display.availableModes) {
+            writer.append(mode);
+        }
+        writer.endArray();
+    }
+    writeReal(writer, KeyRefreshRate, display.refreshRate);
+    writeReal(writer, KeyScale, display.scale);
+    writeReal(writer, KeySdrBrightness, display.sdrBrightness);
+    writeReal(writer, KeySdrSaturation, display.sdrSaturation);
+    writeNumber(writer, KeyWidth, display.width);
+    writeNumber(writer, KeyHeight, display.height);
+    writeNumber(writer, KeyX, display.x);
+    writeNumber(writer, KeyY, display.y);
+    writeNumber(writer, KeyVrrMode, display.vrrMode);
+    writeNumber(writer, KeyTransform, static_cast<int>(display.transform));
+    writeNumber(writer, KeyFlags, static_cast<int>(display.flags));
+    writer.endMap();
+}
+
+bool readDisplay(QCborStreamReader &reader, DisplayInfo &display)
+{
+    if (!reader.isMap() || !reader.enterContainer()) {
+        return false;
+    }
+
+    DisplayInfo info;
+    while (reader.lastError() == QCborError::NoError && reader.hasNext()) {
+        if (!reader.isInteger()) {
+            reader.next();
+            reader.next();
+            continue;
+        }
+        const qint64 key = reader.toInteger();
+        reader.next();
+        switch (key) {
+        case KeyName: info.name = readString(reader); break;
+        case KeyDescription: info.description = readString(reader); break;
+        case KeyManufacturer: info.manufacturer = readString(reader); break;
+        case KeyModel: info.model = readString(reader); break;
+        case KeySerial: info.serial = readString(reader); break;
+        case KeyMirrorOf: info.mirrorOf = readString(reader); break;
+        case KeyWorkspace: info.workspace = readString(reader); break;
+        case KeyAvailableModes:
+            if (reader.isArray() && reader.enterContainer()) {
+                while (reader.lastError() == QCborError::NoError && reader.hasNext()) {
+                    info.availableModes.append(readString(reader));
+                }
+                reader.leaveContainer();
+            } else {
+                reader.next();
+            }
+            break;
+        case KeyRefreshRate: info.refreshRate = readDouble(reader); break;
+        case KeyScale: info.scale = readDouble(reader, 1.0); break;
+        case KeySdrBrightness: info.sdrBrightness = readDouble(reader, 1.0); break;
+        case KeySdrSaturation: info.sdrSaturation = readDouble(reader, 1.0); break;
+        case KeyWidth: info.width = int(readInteger(reader)); break;
+        case KeyHeight: info.height = int(readInteger(reader)); break;
+        case KeyX: info.x = int(readInteger(reader)); break;
+        case KeyY: info.y = int(readInteger(reader)); break;
+        case KeyVrrMode: info.vrrMode = int(readInteger(reader)); break;
+        case KeyTransform: {
+            const qint64 transform = readInteger(reader);
+            info.transform = transform >= 0 && transform < 8 ? static_cast<DisplayTransform>(transform)
+                                                             : DisplayTransform::Normal;
+            break;
+        }
+        case KeyFlags: info.flags = DisplayFlags(QFlag(int(readInteger(reader)))); break;
+        default: reader.next(); break;
+        }
+    }
+    if (reader.lastError() != QCborError::NoError || !reader.leaveContainer()) {
+        return false;
+    }
+
+    info.modeTable = ModeTable::fromModes(info.availableModes);
+    display = info;
+    return true;
+}
+
+void writeDisplays(QCborStreamWriter &writer, const QList<DisplayInfo> &displays)
+{
+    writer.startArray(displays.size());
+    for (const DisplayInfo &display : displays) {
+        writeDisplay(writer, display);
+    }
+    writer.endArray();
+}
+
+bool readDisplays(QCborStreamReader &reader, QList<DisplayInfo> &displays)
+{
+    if (!reader.isArray() || !reader.enterContainer()) {
+        return false;
+    }
+    if (reader.isLengthKnown()) {
+        displays.reserve(displays.size() + int(reader.length()));
+    }
+    while (reader.lastError() == QCborError::NoError && reader.hasNext()) {
+        DisplayInfo display;
+        if (!readDisplay(reader, display)) {
+            return false;
+        }
+        displays.append(display);
+    }
+    return reader.lastError() == QCborError::NoError && reader.leaveContainer();
+}
+
+QString readString(QCborStreamReader &reader)
+{
+    if (!reader.isString()) {
+        reader.next();
+        return QString();
+    }
+    // Long strings may arrive in chunks; the last read moves past the string
+    QString text;
+    auto chunk = reader.readString();
+    while (chunk.status == QCborStreamReader::Ok) {
+        text += chunk.data;
+        chunk = reader.readString();
+    }
+    return text;
+}
+
+qint64 readInteger(QCborStreamReader &reader, qint64 fallback)
+{
+    qint64 value = fallback;
+    if (reader.isInteger()) {
+        value = reader.toInteger();
+    } else if (reader.isDouble()) {
+        value = qint64(reader.toDouble());
+    }
+    reader.next();
+    return value;
+}
+
+double readDouble(QCborStreamReader &reader, double fallback)
+{
+    double value = fallback;
+    if (reader.isDouble()) {
+        value = reader.toDouble();
+    } else if (reader.isFloat()) {
+        value = reader.toFloat();
+    } else if (reader.isFloat16()) {
+        value = float(reader.toFloat16());
+    } else if (reader.isInteger()) {
+        value = double(reader.toInteger());
+    }
+    reader.next();
+    return value;
+}
+
+}
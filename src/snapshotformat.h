@@ -0,0 +1,53 @@
+#ifndef SNAPSHOTFORMAT_H
+#define SNAPSHOTFORMAT_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+class QCborStreamReader;
+class QCborStreamWriter;
+struct DisplayInfo;
+
+// Encodings for saved state. JSON stays the default so files remain easy to
+// read and edit; CBOR is a compact binary alternative. A CBOR file starts
+// with the self-describe tag and holds a map with "schema" and "kind" before
+// the payload, and DisplayInfo is written as a map with integer keys.
+// Readers look at the first bytes, so either format loads wherever the
+// other one was written.
+namespace SnapshotFormat {
+
+enum Format { Json, Cbor };
+
+// Bumped when a key changes meaning; readers skip keys they do not know
+constexpr int SchemaVersion = 1;
+
+QString name(Format format);
+Format fromName(const QString &name, Format fallback = Json);
+bool isCbor(const QByteArray &data);
+
+// Any JSON-shaped state: settings, backups, exported configs
+QByteArray encode(const QJsonObject &object, Format format, const char *kind = "object");
+bool decode(const QByteArray &data, QJsonObject &object, QString *error = nullptr);
+
+// Envelope of a CBOR file: writes the tag, opens the map and fills in
+// "schema" and "kind". The caller appends its fields and calls endMap().
+void beginDocument(QCborStreamWriter &writer, const char *kind);
+// Steps past the tag into the map; fails unless the file was written with
+// a schema this build can read
+bool enterDocument(QCborStreamReader &reader, QString *error);
+
+void writeDisplay(QCborStreamWriter &writer, const DisplayInfo &display);
+bool readDisplay(QCborStreamReader &reader, DisplayInfo &display);
+void writeDisplays(QCborStreamWriter &writer, const QList<DisplayInfo> &displays);
+bool readDisplays(QCborStreamReader &reader, QList<DisplayInfo> &displays);
+
+// Small readers that leave the stream on the next item
+QString readString(QCborStreamReader &reader);
+qint64 readInteger(QCborStreamReader &reader, qint64 fallback = 0);
+double readDouble(QCborStreamReader &reader, double fallback = 0.0);
+
+}
+
+#endif // SNAPSHOTFORMAT_H
@@ -0,0 +1,45 @@
+#include "startuptrace.h"
+#include <QElapsedTimer>
+#include <QTextStream>
+
+namespace {
+
+QElapsedTimer startClock;
+bool traceEnabled = false;
+
+}
+
+namespace StartupTrace {
+
+void start(int argc, char *argv[])
+{
+    startClock.start();
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--startup-trace") == 0) {
+            traceEnabled = true;
+        }
+    }
+    mark("main() entered");
+}
+
+bool isEnabled()
+{
+    return traceEnabled;
+}
+
+qint64 elapsedUs()
+{
+    return startClock.isValid() ? startClock.nsecsElapsed() / 1000 : 0;
+}
+
+void mark(const QString &milestone)
+{
+    if (!traceEnabled) {
+        return;
+    }
+    // stderr, so the trace stays apart from the log lines on stdout
+    QTextStream err(stderr);
+    err << QString("[startup] %1 ms  %2").arg(elapsedUs() / 1000.0, 8, 'f', 2).arg(milestone) << Qt::endl;
+}
+
+}
@@ -0,0 +1,18 @@
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <QString>
+
+// Milestones between main() and the first paint that shows monitors,
+// printed to stderr when the program is started with --startup-trace
+namespace StartupTrace {
+
+// Called first thing in main(); starts the clock and looks for the flag
+void start(int argc, char *argv[]);
+bool isEnabled();
+qint64 elapsedUs();
+void mark(const QString &milestone);
+
+}
+
+#endif // STARTUPTRACE_H
@@ -3,9 +3,23 @@
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsSceneHoverEvent>
 #include <QStyleOptionGraphicsItem>
-#include <QGraphicsDropShadowEffect>
+#include <QPixmapCache>
 #include <QDebug>
 
+namespace {
+
+// Shadow drawn into the cached tile pixmap, matching the old 10px blur offset by 2px
+const int ShadowMargin = 6;
+const QPointF ShadowOffset(2, 2);
+
+const QFont &tileFont()
+{
+    static const QFont font("Arial", 8);
+    return font;
+}
+
+} // namespace
+
 VisualMonitorWidget::VisualMonitorWidget(const QString &name, 
                                          const QString &resolution,
                                          int width, int height,
@@ -16,6 +30,7 @@ VisualMonitorWidget::VisualMonitorWidget(const QString &name,
     , m_resolution(resolution)
     , m_width(width)
     , m_height(height)
+    , m_scaleFactor(scaleFactor)
     , m_isPrimary(false)
     , m_isEnabled(true)
     , m_scale(1.0)
@@ -39,21 +54,12 @@ VisualMonitorWidget::VisualMonitorWidget(const QString &name,
     setFlag(QGraphicsItem::ItemSendsGeometryChanges, true);
     
     // Calculate scaled size for visual representation
-    setMinimumSize(m_width * scaleFactor, m_height * scaleFactor);
-    setMaximumSize(m_width * scaleFactor, m_height * scaleFactor);
-    resize(m_width * scaleFactor, m_height * scaleFactor);
+    updateSize();
     
     // Set up animations
     m_selectionAnimation = new QPropertyAnimation(this, "opacity", this);
     m_selectionAnimation->setDuration(200);
     
-    // Set up drop shadow
-    QGraphicsDropShadowEffect *shadowEffect = new QGraphicsDropShadowEffect(this);
-    shadowEffect->setBlurRadius(10);
-    shadowEffect->setColor(QColor(0, 0, 0, 100));
-    shadowEffect->setOffset(2, 2);
-    setGraphicsEffect(shadowEffect);
-    
     updateAppearance();
 }
 
@@ -61,6 +67,35 @@ VisualMonitorWidget::~VisualMonitorWidget()
 {
 }
 
+void VisualMonitorWidget::setResolution(const QString &resolution, int width, int height)
+{
+    if (m_resolution != resolution || m_width != width || m_height != height) {
+        m_resolution = resolution;
+        m_width = width;
+        m_height = height;
+        updateSize();
+        update();
+    }
+}
+
+void VisualMonitorWidget::setScaleFactor(double scaleFactor)
+{
+    if (m_scaleFactor != scaleFactor) {
+        m_scaleFactor = scaleFactor;
+        updateSize();
+    }
+}
+
+void VisualMonitorWidget::updateSize()
+{
+    prepareGeometryChange();
+    m_cacheKey.clear();
+    QSizeF size(m_width * m_scaleFactor, m_height * m_scaleFactor);
+    setMinimumSize(size);
+    setMaximumSize(size);
+    resize(size);
+}
+
 void VisualMonitorWidget::setPrimary(bool primary)
 {
     if (m_isPrimary != primary) {
@@ -142,43 +177,96 @@ void VisualMonitorWidget::setWideGamut(bool wideGamut)
     }
 }
 
+QRectF VisualMonitorWidget::boundingRect() const
+{
+    // Leave room for the shadow painted around the tile
+    return rect().adjusted(-ShadowMargin, -ShadowMargin,
+                           ShadowMargin + ShadowOffset.x(), ShadowMargin + ShadowOffset.y());
+}
+
+QPainterPath VisualMonitorWidget::shape() const
+{
+    QPainterPath path;
+    path.addRect(rect());
+    return path;
+}
+
 void VisualMonitorWidget::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
     Q_UNUSED(option)
     Q_UNUSED(widget)
     
-    painter->setRenderHint(QPainter::Antialiasing);
+    // Rendered again only when the key changes; drags and hovers draw the cached pixmap
+    const qreal dpr = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+    if (m_cacheKey.isEmpty() || m_cacheDpr != dpr) {
+        m_cacheDpr = dpr;
+        m_cacheKey = QString("vmw:%1:%2:%3x%4:%5:%6:%7%8%9%10:%11")
+                     .arg(m_name, m_resolution)
+                     .arg(qRound(size().width())).arg(qRound(size().height()))
+                     .arg(m_scale).arg(dpr)
+                     .arg(int(m_isEnabled)).arg(int(m_isPrimary)).arg(int(m_isHovered)).arg(int(m_hdr))
+                     .arg(m_fillColor.rgba());
+    }
     
-    QRectF rect = boundingRect();
+    QPixmap tile;
+    if (!QPixmapCache::find(m_cacheKey, &tile)) {
+        tile = renderTile(dpr);
+        QPixmapCache::insert(m_cacheKey, tile);
+    }
+    painter->drawPixmap(boundingRect().topLeft(), tile);
+}
+
+QPixmap VisualMonitorWidget::renderTile(qreal dpr) const
+{
+    const QRectF bounds = boundingRect();
+    QPixmap pixmap((bounds.size() * dpr).toSize());
+    pixmap.setDevicePixelRatio(dpr);
+    pixmap.fill(Qt::transparent);
+    
+    QPainter painter(&pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.translate(-bounds.topLeft());
+    
+    QRectF rect = this->rect();
+    
+    // Soft shadow: stacked translucent rounded rects approximate the old blur
+    painter.setPen(Qt::NoPen);
+    for (int i = ShadowMargin; i > 0; --i) {
+        painter.setBrush(QColor(0, 0, 0, 100 / ShadowMargin));
+        painter.drawRoundedRect(rect.translated(ShadowOffset).adjusted(-i, -i, i, i),
+                                m_cornerRadius + i, m_cornerRadius + i);
+    }
     
     // Draw background
-    painter->fillRect(rect, m_fillColor);
+    painter.fillRect(rect, m_fillColor);
     
     // Draw border
     QPen pen(m_borderColor, m_borderWidth);
-    painter->setPen(pen);
-    painter->drawRoundedRect(rect, m_cornerRadius, m_cornerRadius);
+    painter.setPen(pen);
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRoundedRect(rect, m_cornerRadius, m_cornerRadius);
     
     // Draw text
-    painter->setPen(m_textColor);
-    painter->setFont(QFont("Arial", 8));
+    painter.setPen(m_textColor);
+    painter.setFont(tileFont());
     
     // Draw monitor name
-    painter->drawText(rect, Qt::AlignTop | Qt::AlignHCenter, m_name);
+    painter.drawText(rect, Qt::AlignTop | Qt::AlignHCenter, m_name);
     
     // Draw resolution
-    painter->drawText(rect, Qt::AlignCenter, m_resolution);
+    painter.drawText(rect, Qt::AlignCenter, m_resolution);
     
     // Draw additional info
     QString info = QString("Scale: %1").arg(m_scale);
     if (m_hdr) info += " HDR";
-    painter->drawText(rect, Qt::AlignBottom | Qt::AlignHCenter, info);
+    painter.drawText(rect, Qt::AlignBottom | Qt::AlignHCenter, info);
     
     // Draw primary indicator
     if (m_isPrimary) {
-        painter->setPen(QPen(Qt::yellow, 3));
-        painter->drawEllipse(rect.topLeft() + QPointF(5, 5), 5, 5);
+        painter.setPen(QPen(Qt::yellow, 3));
+        painter.drawEllipse(rect.topLeft() + QPointF(5, 5), 5, 5);
     }
+    return pixmap;
 }
 
 void VisualMonitorWidget::mousePressEvent(QGraphicsSceneMouseEvent *event)
@@ -215,6 +303,7 @@ void VisualMonitorWidget::hoverEnterEvent(QGraphicsSceneHoverEvent *event)
     Q_UNUSED(event)
     m_isHovered = true;
     updateAppearance();
+    update();
     setCursor(Qt::OpenHandCursor);
 }
 
@@ -223,11 +312,13 @@ void VisualMonitorWidget::hoverLeaveEvent(QGraphicsSceneHoverEvent *event)
     Q_UNUSED(event)
     m_isHovered = false;
     updateAppearance();
+    update();
     setCursor(Qt::ArrowCursor);
 }
 
 void VisualMonitorWidget::updateAppearance()
 {
+    m_cacheKey.clear();
     if (!m_isEnabled) {
         m_fillColor = QColor(100, 100, 100);
         m_borderColor = QColor(80, 80, 80);
@@ -11,6 +11,7 @@
 #include <QGraphicsWidget>
 #include <QPropertyAnimation>
 #include <QGraphicsOpacityEffect>
+#include <QPixmap>
 
 class VisualMonitorWidget : public QGraphicsWidget
 {
@@ -24,6 +25,11 @@ public:
     QString getName() const { return m_name; }
     QString getResolution() const { return m_resolution; }
     QSize getSize() const { return QSize(m_width, m_height); }
+    void setResolution(const QString &resolution, int width, int height);
+    
+    // Pixels in the layout view per logical pixel
+    void setScaleFactor(double scaleFactor);
+    double getScaleFactor() const { return m_scaleFactor; }
     
     void setPrimary(bool primary);
     bool isPrimary() const { return m_isPrimary; }
@@ -49,6 +55,10 @@ public:
     bool isTenBit() const { return m_tenBit; }
     void setWideGamut(bool wideGamut);
     bool isWideGamut() const { return m_wideGamut; }
+    
+    // Includes the margin the cached shadow is painted into
+    QRectF boundingRect() const override;
+    QPainterPath shape() const override;
 
 signals:
     void monitorMoved(const QString &name, const QPointF &pos);
@@ -65,12 +75,15 @@ protected:
 
 private:
     void updateAppearance();
+    void updateSize();
     void animateSelection();
+    QPixmap renderTile(qreal dpr) const;
     
     QString m_name;
     QString m_resolution;
     int m_width;
     int m_height;
+    double m_scaleFactor;
     bool m_isPrimary;
     bool m_isEnabled;
     double m_scale;
@@ -94,6 +107,10 @@ private:
     int m_borderWidth;
     int m_cornerRadius;
     
+    // QPixmapCache key for the current appearance; cleared whenever it changes
+    QString m_cacheKey;
+    qreal m_cacheDpr = 1.0;
+    
     bool m_tenBit = false;
     bool m_wideGamut = false;
 };
@@ -0,0 +1,106 @@
+#include "warmstartcache.h"
+#include "snapshotformat.h"
+#include <QCborStreamReader>
+#include <QCborStreamWriter>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+QString WarmStartCache::defaultPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/HyprDisplays/warmstart.cbor";
+}
+
+bool WarmStartCache::load(const QString &path, WarmStartState &state, QString *error)
+{
+    state = WarmStartState();
+    QFile file(path);
+    if (!file.exists()) {
+        return true;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    const qint64 size = file.size();
+    uchar *mapped = size > 0 ? file.map(0, size) : nullptr;
+    if (!mapped) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+
+    // Strings are copied out while decoding, so the mapping can go right after
+    const QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), size);
+    QCborStreamReader reader(data);
+    bool ok = SnapshotFormat::enterDocument(reader, error);
+    while (ok && reader.lastError() == QCborError::NoError && reader.hasNext()) {
+        const QString key = SnapshotFormat::readString(reader);
+        if (key == QLatin1String("saved")) {
+            state.saved = QDateTime::fromMSecsSinceEpoch(SnapshotFormat::readInteger(reader));
+        } else if (key == QLatin1String("view") && reader.isArray() && reader.enterContainer()) {
+            const double width = reader.hasNext() ? SnapshotFormat::readDouble(reader) : 0.0;
+            const double height = reader.hasNext() ? SnapshotFormat::readDouble(reader) : 0.0;
+            state.viewSize = QSizeF(width, height);
+            while (reader.hasNext()) reader.next();
+            ok = reader.leaveContainer();
+        } else if (key == QLatin1String("layout") && reader.isArray() && reader.enterContainer()) {
+            state.layout.minX = reader.hasNext() ? int(SnapshotFormat::readInteger(reader)) : 0;
+            state.layout.minY = reader.hasNext() ? int(SnapshotFormat::readInteger(reader)) : 0;
+            state.layout.scale = reader.hasNext() ? SnapshotFormat::readDouble(reader, 0.1) : 0.1;
+            state.layout.offsetX = reader.hasNext() ? SnapshotFormat::readDouble(reader) : 0.0;
+            state.layout.offsetY = reader.hasNext() ? SnapshotFormat::readDouble(reader) : 0.0;
+            while (reader.hasNext()) reader.next();
+            ok = reader.leaveContainer();
+        } else if (key == QLatin1String("displays")) {
+            ok = SnapshotFormat::readDisplays(reader, state.displays);
+        } else {
+            reader.next();
+        }
+    }
+    if (ok && reader.lastError() != QCborError::NoError) {
+        ok = false;
+        if (error) *error = reader.lastError().toString();
+    }
+    file.unmap(mapped);
+
+    if (!ok) {
+        if (error && error->isEmpty()) *error = QString("Malformed warm-start cache");
+        state = WarmStartState();
+    }
+    return ok;
+}
+
+bool WarmStartCache::save(const QString &path, const WarmStartState &state, QString *error)
+{
+    QByteArray data;
+    QCborStreamWriter writer(&data);
+    SnapshotFormat::beginDocument(writer, "warmstart");
+    writer.append("saved");
+    writer.append(state.saved.toMSecsSinceEpoch());
+    writer.append("view");
+    writer.startArray(2);
+    writer.append(state.viewSize.width());
+    writer.append(state.viewSize.height());
+    writer.endArray();
+    writer.append("layout");
+    writer.startArray(5);
+    writer.append(qint64(state.layout.minX));
+    writer.append(qint64(state.layout.minY));
+    writer.append(double(state.layout.scale));
+    writer.append(double(state.layout.offsetX));
+    writer.append(double(state.layout.offsetY));
+    writer.endArray();
+    writer.append("displays");
+    SnapshotFormat::writeDisplays(writer, state.displays);
+    writer.endMap();
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    return true;
+}
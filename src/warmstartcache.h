@@ -0,0 +1,32 @@
+#ifndef WARMSTARTCACHE_H
+#define WARMSTARTCACHE_H
+
+#include <QDateTime>
+#include <QList>
+#include <QSizeF>
+#include <QString>
+
+#include "displaymanager.h"
+#include "monitorscenesync.h"
+
+// What the layout view showed when the window was last closed
+struct WarmStartState {
+    QList<DisplayInfo> displays;
+    MonitorLayoutTransform layout;  // fit of displays into viewSize
+    QSizeF viewSize;
+    QDateTime saved;
+};
+
+// Lets the next launch paint the monitors before Hyprland has answered.
+// The state is kept as a CBOR snapshot in the cache directory and read
+// through a memory mapping, so loading costs one mmap and a decode pass.
+class WarmStartCache
+{
+public:
+    static QString defaultPath();
+    // A missing file is not an error; state is left empty
+    static bool load(const QString &path, WarmStartState &state, QString *error = nullptr);
+    static bool save(const QString &path, const WarmStartState &state, QString *error = nullptr);
+};
+
+#endif // WARMSTARTCACHE_H
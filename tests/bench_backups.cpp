@@ -0,0 +1,177 @@
+#include "backupstore.h"
+#include "benchmarkdata.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QtTest>
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+// A handful of layouts the user keeps switching between
+const int Variants = 8;
+
+enum Operation { Create, List, OpenIndex, LegacyList };
+
+// The old ConfigManager::getBackups(): directory scan, then a stat per comparison
+QStringList legacyBackupList(const QString &dir)
+{
+    static const QRegularExpression backupFileRegex(R"(hyprdisplays_backup_\d{8}_\d{6}\.json)");
+    QStringList backups;
+    const QFileInfoList files = QDir(dir).entryInfoList(QStringList() << "*.json", QDir::Files);
+    for (const QFileInfo &fileInfo : files) {
+        if (backupFileRegex.match(fileInfo.fileName()).hasMatch()) {
+            backups.append(fileInfo.absoluteFilePath());
+        }
+    }
+    std::sort(backups.begin(), backups.end(), [](const QString &a, const QString &b) {
+        return QFileInfo(a).lastModified() > QFileInfo(b).lastModified();
+    });
+    return backups;
+}
+
+QJsonObject sampleBackupState(int variant)
+{
+    QJsonObject displays;
+    for (const DisplayInfo &display : BenchmarkData::syntheticDisplays(1 + variant % 4)) {
+        displays[display.name] = display.toJson();
+    }
+    QJsonObject state;
+    state["displayConfig"] = displays;
+    state["workspaceConfig"] = QJsonObject{{"workspaces", variant}};
+    state["applicationConfig"] = QJsonObject{{"maxBackups", 0}};
+    state["version"] = "1.0.0";
+    return state;
+}
+
+}
+
+// Creating, listing and reopening the backup store as the history grows,
+// against the old one-file-per-backup listing
+class BackupBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void operation_data();
+    void operation();
+    void deduplicates();
+    void retention();
+
+private:
+    // Adds backups to both layouts until history are stored
+    void growTo(int history);
+    QString storePath() const { return m_dir.path() + "/store"; }
+    QString legacyPath() const { return m_dir.path() + "/legacy"; }
+
+    QTemporaryDir m_dir;
+    std::unique_ptr<BackupStore> m_store;
+    QList<QJsonObject> m_states;
+    int m_written = 0;
+};
+
+void BackupBenchmark::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    QDir().mkpath(legacyPath());
+    m_store = std::make_unique<BackupStore>(storePath());
+    for (int i = 0; i < Variants; ++i) m_states.append(sampleBackupState(i));
+}
+
+void BackupBenchmark::growTo(int history)
+{
+    while (m_written < history) {
+        QVERIFY(!m_store->add(m_states.at(m_written % Variants)).isEmpty());
+        // The old layout: one indented file per backup
+        QJsonObject legacy = m_states.at(m_written % Variants);
+        legacy["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+        QFile file(QString("%1/hyprdisplays_backup_%2_%3.json").arg(legacyPath())
+                   .arg(20250101 + m_written / 1000000).arg(m_written % 1000000, 6, 10, QChar('0')));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QJsonDocument(legacy).toJson());
+        ++m_written;
+    }
+}
+
+void BackupBenchmark::operation_data()
+{
+    QTest::addColumn<int>("history");
+    QTest::addColumn<int>("operation");
+    // Rows run in order, so the history only ever grows
+    for (int history : {100, 1000, 4000}) {
+        QTest::addRow("%d backups, create", history) << history << int(Create);
+        QTest::addRow("%d backups, list", history) << history << int(List);
+        QTest::addRow("%d backups, open index", history) << history << int(OpenIndex);
+        QTest::addRow("%d backups, legacy list", history) << history << int(LegacyList);
+    }
+}
+
+void BackupBenchmark::operation()
+{
+    QFETCH(int, history);
+    QFETCH(int, operation);
+    growTo(history);
+    if (QTest::currentTestFailed()) return;
+
+    switch (operation) {
+    case Create: {
+        bool ok = true;
+        QBENCHMARK {
+            ok = !m_store->add(m_states.at(m_written++ % Variants)).isEmpty() && ok;
+        }
+        QVERIFY(ok);
+        break;
+    }
+    case List: {
+        QStringList ids;
+        QBENCHMARK {
+            ids = m_store->ids();
+        }
+        QCOMPARE(int(ids.size()), m_written);
+        break;
+    }
+    case OpenIndex: {
+        int size = 0;
+        QBENCHMARK {
+            BackupStore reopened(storePath());
+            size = reopened.size();
+        }
+        QCOMPARE(size, m_written);
+        break;
+    }
+    case LegacyList: {
+        QStringList backups;
+        QBENCHMARK {
+            backups = legacyBackupList(legacyPath());
+        }
+        QVERIFY(!backups.isEmpty());
+        break;
+    }
+    }
+}
+
+void BackupBenchmark::deduplicates()
+{
+    // However many backups, each distinct state is stored once
+    QCOMPARE(int(QDir(storePath() + "/objects").entryList(QDir::Files).size()), Variants);
+    QCOMPARE(m_store->objectCount(), Variants);
+}
+
+void BackupBenchmark::retention()
+{
+    // Retention drops the oldest entries and the objects nothing refers to any more
+    m_store->setMaxEntries(Variants / 2);
+    QVERIFY(!m_store->add(m_states.at(m_written % Variants)).isEmpty());
+    QCOMPARE(m_store->size(), Variants / 2);
+    QCOMPARE(m_store->objectCount(), Variants / 2);
+    QCOMPARE(int(QDir(storePath() + "/objects").entryList(QDir::Files).size()), Variants / 2);
+}
+
+QTEST_GUILESS_MAIN(BackupBenchmark)
+#include "bench_backups.moc"
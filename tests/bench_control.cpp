@@ -0,0 +1,153 @@
+#include "benchmarkdata.h"
+#include "controlserver.h"
+#include "hyprlandeventsocket.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QLocalSocket>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QtTest>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace {
+
+const int Monitors = 4;
+const int RequestsPerClient = 2000;
+
+// One client of the load test: sends depth getLayout requests at a time and
+// waits for all of their answers. Answers without the monitors count as failures.
+void runControlClient(const QString &socketPath, int batches, int depth, std::atomic<int> &failures)
+{
+    QLocalSocket socket;
+    socket.connectToServer(socketPath);
+    if (!socket.waitForConnected(5000)) {
+        failures += batches * depth;
+        return;
+    }
+    QByteArray batch;
+    for (int i = 0; i < depth; ++i) {
+        batch += "{\"jsonrpc\":\"2.0\",\"id\":" + QByteArray::number(i) + ",\"method\":\"getLayout\"}\n";
+    }
+
+    LineFramer framer;
+    for (int round = 0; round < batches; ++round) {
+        socket.write(batch);
+        socket.flush();
+        int answered = 0;
+        while (answered < depth) {
+            if (!socket.waitForReadyRead(5000)) {
+                failures += (batches - round) * depth - answered;
+                return;
+            }
+            for (const QByteArray &line : framer.feed(socket.readAll())) {
+                if (!line.contains("\"monitors\":[{")) ++failures;
+                ++answered;
+            }
+        }
+    }
+}
+
+}
+
+// getLayout throughput on the control socket from 1 to 16 concurrent
+// clients, with and without pipelining. The layout comes from a refresh
+// against a fake Hyprland, as it would from the real one.
+class ControlBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void getLayout_data();
+    void getLayout();
+
+private:
+    QTemporaryDir m_dir;
+    std::unique_ptr<FakeHyprland> m_hyprland;
+    std::unique_ptr<DisplayManager> m_displayManager;
+    std::unique_ptr<ControlServer> m_server;
+    QString m_socketPath;
+};
+
+void ControlBenchmark::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    const QString runtimeDir = m_dir.path() + "/runtime";
+    const QString instanceDir = runtimeDir + "/hypr/bench";
+    QDir().mkpath(instanceDir);
+    QFile::setPermissions(runtimeDir, QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ExeOwner);
+    // Read on every request, so this points the IPC client at the fake
+    qputenv("XDG_RUNTIME_DIR", runtimeDir.toUtf8());
+    qputenv("HYPRLAND_INSTANCE_SIGNATURE", "bench");
+    m_hyprland = std::make_unique<FakeHyprland>(instanceDir, Monitors);
+    QVERIFY(m_hyprland->listen());
+
+    m_displayManager = std::make_unique<DisplayManager>();
+    bool refreshed = false;
+    bool finished = false;
+    const QMetaObject::Connection connection =
+        connect(m_displayManager.get(), &DisplayManager::refreshFinished, this, [&](bool ok) {
+            refreshed = ok;
+            finished = true;
+        });
+    QVERIFY(m_displayManager->refreshDisplays());
+    BenchmarkData::waitUntil([&]() { return finished; }, 5000);
+    disconnect(connection);
+    QVERIFY(finished);
+    QVERIFY(refreshed);
+    QVERIFY(m_displayManager->hyprlandSnapshot());
+    QCOMPARE(int(m_displayManager->hyprlandSnapshot()->displays.size()), Monitors);
+
+    m_server = std::make_unique<ControlServer>(m_displayManager.get(), nullptr);
+    m_socketPath = m_dir.path() + "/control.sock";
+    QString error;
+    QVERIFY2(m_server->listen(m_socketPath, &error), qPrintable(error));
+}
+
+void ControlBenchmark::getLayout_data()
+{
+    QTest::addColumn<int>("clients");
+    QTest::addColumn<int>("depth");
+    for (int clients : {1, 4, 16}) {
+        for (int depth : {1, 32}) {
+            QTest::addRow("%d clients, pipeline %d", clients, depth) << clients << depth;
+        }
+    }
+}
+
+void ControlBenchmark::getLayout()
+{
+    QFETCH(int, clients);
+    QFETCH(int, depth);
+    const int batches = qMax(1, RequestsPerClient / depth);
+    std::atomic<int> failed{0};
+    qint64 requests = 0;
+    qint64 elapsedUs = 0;
+    QBENCHMARK {
+        QList<QThread *> threads;
+        QElapsedTimer wall;
+        wall.start();
+        for (int c = 0; c < clients; ++c) {
+            threads.append(QThread::create([&]() { runControlClient(m_socketPath, batches, depth, failed); }));
+            threads.last()->start();
+        }
+        // The server answers from this thread's event loop meanwhile
+        BenchmarkData::waitUntil([&]() {
+            return std::all_of(threads.cbegin(), threads.cend(), [](QThread *thread) { return thread->isFinished(); });
+        }, 120000);
+        for (QThread *thread : std::as_const(threads)) {
+            thread->wait();
+            delete thread;
+        }
+        elapsedUs += wall.nsecsElapsed() / 1000;
+        requests += qint64(clients) * batches * depth;
+    }
+    qInfo() << qRound64(requests * 1e6 / qMax<qint64>(1, elapsedUs)) << "req/s";
+    QCOMPARE(failed.load(), 0);
+}
+
+QTEST_GUILESS_MAIN(ControlBenchmark)
+#include "bench_control.moc"
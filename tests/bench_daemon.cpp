@@ -0,0 +1,183 @@
+#include "benchmarkdata.h"
+#include "controlserver.h"
+#include "layoutprofilestore.h"
+#include "monitorjsondecoder.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonObject>
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QTemporaryDir>
+#include <QtTest>
+#include <memory>
+
+namespace {
+
+const int IdleSeconds = 5;
+// A Core-only process with two monitors and a few profiles; the window needs several times this
+const qint64 ResidentCeilingKb = 24 * 1024;
+
+// Voluntary and involuntary context switches of every thread of pid; each
+// time a thread blocks and runs again counts. -1 without /proc.
+qint64 contextSwitches(qint64 pid)
+{
+    const QDir tasks(QString("/proc/%1/task").arg(pid));
+    if (!tasks.exists()) return -1;
+    qint64 total = 0;
+    for (const QString &task : tasks.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        QFile status(tasks.filePath(task + "/status"));
+        if (!status.open(QIODevice::ReadOnly)) continue;
+        for (const QByteArray &line : status.readAll().split('\n')) {
+            if (line.startsWith("voluntary_ctxt_switches:") || line.startsWith("nonvoluntary_ctxt_switches:")) {
+                total += line.mid(line.indexOf(':') + 1).trimmed().toLongLong();
+            }
+        }
+    }
+    return total;
+}
+
+qint64 residentKbOf(qint64 pid)
+{
+    QFile status(QString("/proc/%1/status").arg(pid));
+    if (!status.open(QIODevice::ReadOnly)) return 0;
+    for (const QByteArray &line : status.readAll().split('\n')) {
+        if (line.startsWith("VmRSS:")) return line.mid(6).trimmed().split(' ').first().toLongLong();
+    }
+    return 0;
+}
+
+}
+
+// hyprdisplays-cli --daemon against a fake Hyprland: wakeups and timer
+// events while idle, resident memory, hotplug to apply, clean exit
+class DaemonBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void idle();
+    void resident();
+    void hotplugToApply();
+    void terminate();
+
+private:
+    QTemporaryDir m_dir;
+    std::unique_ptr<FakeHyprland> m_hyprland;
+    QProcess m_daemon;
+    QString m_socketPath;
+};
+
+void DaemonBenchmark::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    const QString runtimeDir = m_dir.path() + "/runtime";
+    const QString instanceDir = runtimeDir + "/hypr/bench";
+    QDir().mkpath(instanceDir);
+    QFile::setPermissions(runtimeDir, QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ExeOwner);
+    m_hyprland = std::make_unique<FakeHyprland>(instanceDir, 2);
+    QVERIFY(m_hyprland->listen());
+
+    // A saved layout for the fake monitors that differs from what they report, so every hotplug applies it
+    QList<DisplayInfo> displays;
+    QVERIFY(MonitorJsonDecoder::decode(BenchmarkData::recordedMonitorsReply(2), displays));
+    displays[1].x += 1280;
+    LayoutProfileStore store;
+    store.remember(displays);
+    const QString profilesPath = m_dir.path() + "/profiles.json";
+    QVERIFY(store.save(profilesPath));
+
+    m_socketPath = m_dir.path() + "/daemon.sock";
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert("XDG_RUNTIME_DIR", runtimeDir);
+    environment.insert("HYPRLAND_INSTANCE_SIGNATURE", "bench");
+    environment.insert("XDG_CONFIG_HOME", m_dir.path() + "/config");
+    environment.insert("XDG_CACHE_HOME", m_dir.path() + "/cache");
+    m_daemon.setProcessEnvironment(environment);
+    m_daemon.setStandardOutputFile(QProcess::nullDevice());
+    m_daemon.setStandardErrorFile(QProcess::nullDevice());
+
+    QElapsedTimer sinceStart;
+    sinceStart.start();
+    m_daemon.start(HYPRDISPLAYS_CLI_PATH, {"--daemon", "--profiles-path", profilesPath, "--socket-path", m_socketPath});
+    QVERIFY2(m_daemon.waitForStarted(5000), qPrintable(m_daemon.errorString()));
+
+    // The layout saved for the connected monitors is applied at startup
+    QVERIFY2(BenchmarkData::waitUntil([this]() {
+        return m_hyprland->batches() >= 1 && m_hyprland->eventClients() >= 1;
+    }, 5000), "the saved layout was not applied at startup");
+    qInfo() << "start to first apply:" << sinceStart.elapsed() << "ms";
+
+    // Let the refresh after the apply finish
+    BenchmarkData::waitUntil([]() { return false; }, 500);
+}
+
+void DaemonBenchmark::cleanupTestCase()
+{
+    if (m_daemon.state() != QProcess::NotRunning) {
+        m_daemon.kill();
+        m_daemon.waitForFinished();
+    }
+}
+
+void DaemonBenchmark::idle()
+{
+    QJsonValue before;
+    QString error;
+    QVERIFY2(ControlServer::call(m_socketPath, "getStatus", QJsonObject(), before, &error), qPrintable(error));
+    // Let the daemon see the hang-up of that connection too
+    BenchmarkData::waitUntil([]() { return false; }, 200);
+
+    const qint64 pid = m_daemon.processId();
+    const qint64 switchesBefore = contextSwitches(pid);
+    BenchmarkData::waitUntil([]() { return false; }, IdleSeconds * 1000);
+    const qint64 switchesAfter = contextSwitches(pid);
+    QJsonValue after;
+    QVERIFY2(ControlServer::call(m_socketPath, "getStatus", QJsonObject(), after, &error), qPrintable(error));
+
+    const qint64 timerEvents = after["statistics"].toObject()["timerEvents"].toInteger()
+                             - before["statistics"].toObject()["timerEvents"].toInteger();
+    qInfo() << "idle" << IdleSeconds << "s:" << timerEvents << "timer events";
+    QCOMPARE(timerEvents, qint64(0));
+    if (switchesBefore < 0) {
+        QSKIP("No /proc, wakeups not counted");
+    }
+    qInfo() << "idle" << IdleSeconds << "s:" << switchesAfter - switchesBefore << "wakeups";
+    QCOMPARE(switchesAfter - switchesBefore, qint64(0));
+}
+
+void DaemonBenchmark::resident()
+{
+    const qint64 residentKb = residentKbOf(m_daemon.processId());
+    if (residentKb == 0) {
+        QSKIP("No /proc, resident memory not read");
+    }
+    qInfo() << "resident:" << residentKb << "KiB, ceiling" << ResidentCeilingKb << "KiB";
+    QVERIFY(residentKb <= ResidentCeilingKb);
+}
+
+void DaemonBenchmark::hotplugToApply()
+{
+    // Event line to the batch that applies the saved layout
+    QBENCHMARK {
+        const int batchesBefore = m_hyprland->batches();
+        m_hyprland->sendEvent("monitoradded>>DP-3");
+        QVERIFY2(BenchmarkData::waitUntil([&]() { return m_hyprland->batches() > batchesBefore; }, 5000),
+                 "no batch within 5 s");
+    }
+}
+
+void DaemonBenchmark::terminate()
+{
+    m_daemon.terminate();
+    QVERIFY(m_daemon.waitForFinished(3000));
+    QCOMPARE(m_daemon.exitStatus(), QProcess::NormalExit);
+    // SIGTERM removes the control socket on the way out
+    QVERIFY(!QFileInfo::exists(m_socketPath));
+}
+
+QTEST_GUILESS_MAIN(DaemonBenchmark)
+#include "bench_daemon.moc"
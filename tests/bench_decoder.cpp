@@ -0,0 +1,118 @@
+#include "benchmarkdata.h"
+#include "monitorjsondecoder.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtTest>
+
+namespace {
+
+// The QJsonDocument path the refresh used before MonitorJsonDecoder, kept as the reference
+bool decodeWithDom(const QByteArray &reply, QList<DisplayInfo> &displays)
+{
+    const QString output = QString::fromUtf8(reply);
+    QJsonDocument doc = QJsonDocument::fromJson(output.toUtf8());
+    if (!doc.isArray()) return false;
+    QJsonArray arr = doc.array();
+    displays.clear();
+    displays.reserve(arr.size());
+    for (const QJsonValue &val : arr) {
+        QJsonObject obj = val.toObject();
+        DisplayInfo di;
+        di.name = obj["name"].toString();
+        di.description = obj["description"].toString();
+        di.manufacturer = obj["make"].toString();
+        di.model = obj["model"].toString();
+        di.serial = obj["serial"].toString();
+        di.width = obj["width"].toInt();
+        di.height = obj["height"].toInt();
+        di.refreshRate = obj["refreshRate"].toDouble();
+        di.x = obj["x"].toInt();
+        di.y = obj["y"].toInt();
+        di.scale = obj["scale"].toDouble();
+        di.setEnabled(!obj["disabled"].toBool());
+        di.setPrimary(obj["focused"].toBool());
+        di.transform = DisplayInfo::parseTransform(QString::number(obj["transform"].toInt()));
+        di.mirrorOf = obj["mirrorOf"].toString();
+        di.workspace = obj["activeWorkspace"].toObject()["name"].toString();
+        di.setHdr(obj["hdr"].toBool(false));
+        di.sdrBrightness = obj.contains("sdrBrightness") ? obj["sdrBrightness"].toDouble(1.0) : 1.0;
+        di.sdrSaturation = obj.contains("sdrSaturation") ? obj["sdrSaturation"].toDouble(1.0) : 1.0;
+        di.vrrMode = obj.contains("vrrMode") ? obj["vrrMode"].toInt() : 0;
+        di.setVrrCapable(obj.contains("vrr"));
+        di.setHdrCapable(true);
+        di.setTenBit(obj["tenBit"].toBool(false));
+        di.setWideGamut(obj["wideGamut"].toBool(false));
+        QJsonArray modes = obj["availableModes"].toArray();
+        for (const QJsonValue &mode : modes) di.availableModes.append(mode.toString());
+        di.modeTable = ModeTable::fromModes(di.availableModes);
+        displays.append(di);
+    }
+    return true;
+}
+
+}
+
+// Decoding `hyprctl monitors -j`: QJsonDocument DOM versus the streaming decoder
+class DecoderBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void decodersAgree_data();
+    void decodersAgree();
+    void decode_data();
+    void decode();
+};
+
+void DecoderBenchmark::decodersAgree_data()
+{
+    QTest::addColumn<int>("count");
+    for (int count : {2, 8, 32}) {
+        QTest::addRow("%d monitors", count) << count;
+    }
+}
+
+void DecoderBenchmark::decodersAgree()
+{
+    QFETCH(int, count);
+    const QByteArray reply = BenchmarkData::recordedMonitorsReply(count);
+    QList<DisplayInfo> dom;
+    QList<DisplayInfo> streamed;
+    QVERIFY(decodeWithDom(reply, dom));
+    QVERIFY(MonitorJsonDecoder::decode(reply, streamed));
+    QCOMPARE(streamed.size(), dom.size());
+    for (int i = 0; i < dom.size(); ++i) {
+        QCOMPARE(streamed.at(i).name, dom.at(i).name);
+        QCOMPARE(streamed.at(i).diff(dom.at(i)).toInt(), 0);
+    }
+}
+
+void DecoderBenchmark::decode_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("streaming");
+    for (int count : {2, 8, 32}) {
+        QTest::addRow("%d monitors, QJsonDocument", count) << count << false;
+        QTest::addRow("%d monitors, streaming", count) << count << true;
+    }
+}
+
+void DecoderBenchmark::decode()
+{
+    QFETCH(int, count);
+    QFETCH(bool, streaming);
+    const QByteArray reply = BenchmarkData::recordedMonitorsReply(count);
+    QList<DisplayInfo> displays;
+    QBENCHMARK {
+        if (streaming) {
+            MonitorJsonDecoder::decode(reply, displays);
+        } else {
+            decodeWithDom(reply, displays);
+        }
+    }
+    QCOMPARE(int(displays.size()), count);
+}
+
+QTEST_GUILESS_MAIN(DecoderBenchmark)
+#include "bench_decoder.moc"
@@ -0,0 +1,41 @@
+#include "benchmarkdata.h"
+#include <QtTest>
+
+// The cost of taking a writable copy of the monitor list, which is what
+// editing a monitor from getDisplays() costs
+class DisplayInfoBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void copy_data();
+    void copy();
+};
+
+void DisplayInfoBenchmark::initTestCase()
+{
+    qInfo() << "sizeof(DisplayInfo):" << sizeof(DisplayInfo) << "bytes";
+}
+
+void DisplayInfoBenchmark::copy_data()
+{
+    QTest::addColumn<int>("count");
+    for (int count : {2, 8, 32}) {
+        QTest::addRow("%d monitors", count) << count;
+    }
+}
+
+void DisplayInfoBenchmark::copy()
+{
+    QFETCH(int, count);
+    const QList<DisplayInfo> displays = BenchmarkData::syntheticDisplays(count);
+    QBENCHMARK {
+        // Detaching copies every record
+        QList<DisplayInfo> copy = displays;
+        copy.detach();
+    }
+}
+
+QTEST_GUILESS_MAIN(DisplayInfoBenchmark)
+#include "bench_displayinfo.moc"
@@ -0,0 +1,99 @@
+#include "hyprconfig.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QtTest>
+
+namespace {
+
+const int FileCount = 40;
+
+// A split config like the ones that grow out of dotfile repos: hyprland.conf
+// defines a few variables and sources count files of linesPerFile lines
+bool writeSplitConfig(const QString &dir, int count, int linesPerFile)
+{
+    QByteArray root = "$mainMod = SUPER\n$gaps = 8\n$term = kitty\n";
+    for (int i = 0; i < count; ++i) {
+        const QString name = QString("conf.d/%1.conf").arg(i, 2, 10, QChar('0'));
+        root += "source = ./" + name.toUtf8() + "\n";
+
+        QByteArray body = "# generated\ngeneral {\n    gaps_in = $gaps\n}\n";
+        for (int line = 0; line < linesPerFile; ++line) {
+            body += QString("bind = $mainMod, %1, exec, $term --title w%2-%1 # launcher\n").arg(line).arg(i).toUtf8();
+        }
+        body += QString("monitor = DP-%1, 2560x1440@143.97, %2x0, 1\n").arg(i + 1).arg(i * 2560).toUtf8();
+        QDir().mkpath(dir + "/conf.d");
+        QFile file(dir + "/" + name);
+        if (!file.open(QIODevice::WriteOnly) || file.write(body) != body.size()) return false;
+    }
+    QFile file(dir + "/hyprland.conf");
+    return file.open(QIODevice::WriteOnly) && file.write(root) == root.size();
+}
+
+}
+
+// Loading a split hyprland.conf: cold parse versus cached reloads after no
+// edit or one edited file
+class HyprConfigBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void coldLoad();
+    void reloadUnchanged();
+    void reloadOneEdited();
+
+private:
+    QTemporaryDir m_dir;
+    QString m_rootPath;
+};
+
+void HyprConfigBenchmark::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    QVERIFY(writeSplitConfig(m_dir.path(), FileCount, 50));
+    m_rootPath = m_dir.path() + "/hyprland.conf";
+}
+
+void HyprConfigBenchmark::coldLoad()
+{
+    QBENCHMARK {
+        HyprConfig fresh;
+        QVERIFY(fresh.load(m_rootPath));
+        QCOMPARE(int(fresh.values("monitor").size()), FileCount);
+    }
+}
+
+void HyprConfigBenchmark::reloadUnchanged()
+{
+    HyprConfig warm;
+    QVERIFY(warm.load(m_rootPath));
+    QBENCHMARK {
+        warm.reload();
+    }
+    QVERIFY(warm.reparsedFiles().isEmpty());
+    QCOMPARE(int(warm.values("monitor").size()), FileCount);
+}
+
+void HyprConfigBenchmark::reloadOneEdited()
+{
+    const QString editedPath = m_dir.path() + "/conf.d/07.conf";
+    HyprConfig warm;
+    QVERIFY(warm.load(m_rootPath));
+    QFile edited(editedPath);
+    // The append is measured too; it is a small write next to a parse
+    QBENCHMARK {
+        // Appending changes the size, so the edit is seen even within one mtime tick
+        QVERIFY(edited.open(QIODevice::Append));
+        edited.write("# edit\n");
+        edited.close();
+        warm.reload();
+    }
+    QCOMPARE(warm.reparsedFiles(), QStringList{QFileInfo(editedPath).canonicalFilePath()});
+    QCOMPARE(int(warm.values("monitor").size()), FileCount);
+}
+
+QTEST_GUILESS_MAIN(HyprConfigBenchmark)
+#include "bench_hyprconfig.moc"
@@ -0,0 +1,74 @@
+#include "hyprlandipc.h"
+#include <QtTest>
+
+// Per-request latency of the socket client versus spawning hyprctl, against
+// the running Hyprland
+class IpcBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void request_data();
+    void request();
+    void batch_data();
+    void batch();
+};
+
+void IpcBenchmark::initTestCase()
+{
+    if (!HyprlandIpc::isSocketAvailable()) {
+        QSKIP("Hyprland socket not found (HYPRLAND_INSTANCE_SIGNATURE unset?)");
+    }
+}
+
+void IpcBenchmark::request_data()
+{
+    QTest::addColumn<QStringList>("args");
+    QTest::addColumn<bool>("viaSocket");
+    for (const QStringList &args : {QStringList{"version"}, QStringList{"-j", "monitors"}}) {
+        const QByteArray name = args.join(' ').toUtf8();
+        QTest::newRow((name + " socket").constData()) << args << true;
+        QTest::newRow((name + " process").constData()) << args << false;
+    }
+}
+
+void IpcBenchmark::request()
+{
+    QFETCH(QStringList, args);
+    QFETCH(bool, viaSocket);
+    HyprlandReply reply;
+    QBENCHMARK {
+        reply = viaSocket ? HyprlandIpc::request(HyprlandIpc::commandFromArgs(args))
+                          : HyprlandIpc::runHyprctlProcess(args);
+    }
+    QVERIFY2(reply.ok, qPrintable(reply.error));
+}
+
+void IpcBenchmark::batch_data()
+{
+    QTest::addColumn<bool>("batched");
+    QTest::newRow("one request each") << false;
+    QTest::newRow("single [[BATCH]]") << true;
+}
+
+void IpcBenchmark::batch()
+{
+    QFETCH(bool, batched);
+    // Same shape as applying a six-monitor layout, but with a read-only command
+    const QStringList commands(6, "version");
+    bool ok = true;
+    QBENCHMARK {
+        if (batched) {
+            ok = HyprlandIpc::batch(commands).ok && ok;
+        } else {
+            for (const QString &command : commands) {
+                ok = HyprlandIpc::hyprctl({command}).ok && ok;
+            }
+        }
+    }
+    QVERIFY(ok);
+}
+
+QTEST_GUILESS_MAIN(IpcBenchmark)
+#include "bench_ipc.moc"
@@ -0,0 +1,73 @@
+#include "benchmarkdata.h"
+#include "layoutprofilestore.h"
+#include <QtTest>
+
+namespace {
+
+// Comparing the identity list against every profile in turn
+const LayoutProfile *scan(const LayoutProfileStore &store, const QList<DisplayInfo> &displays)
+{
+    QStringList wanted;
+    for (const DisplayInfo &display : displays) wanted.append(LayoutProfileStore::identity(display));
+    wanted.sort();
+    for (const QString &fingerprint : store.fingerprints()) {
+        const LayoutProfile *profile = store.find(fingerprint);
+        QStringList identities;
+        for (const DisplayInfo &display : profile->displays) identities.append(LayoutProfileStore::identity(display));
+        identities.sort();
+        if (identities == wanted) {
+            return profile;
+        }
+    }
+    return nullptr;
+}
+
+}
+
+// Finding the saved layout for the connected monitors: fingerprint lookup
+// versus scanning every profile
+class ProfileBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void lookup_data();
+    void lookup();
+
+private:
+    LayoutProfileStore m_store;
+    QList<DisplayInfo> m_docked;
+};
+
+void ProfileBenchmark::initTestCase()
+{
+    // Profiles for a laptop panel plus one to three of many different external monitors
+    for (int i = 0; i < 1000; ++i) {
+        const QList<DisplayInfo> displays = BenchmarkData::dockedDisplays(i);
+        m_store.remember(displays);
+        if (i == 500) m_docked = displays;
+    }
+    QCOMPARE(m_store.size(), 1000);
+}
+
+void ProfileBenchmark::lookup_data()
+{
+    QTest::addColumn<bool>("fingerprint");
+    QTest::newRow("fingerprint") << true;
+    QTest::newRow("linear scan") << false;
+}
+
+void ProfileBenchmark::lookup()
+{
+    QFETCH(bool, fingerprint);
+    const LayoutProfile *found = nullptr;
+    QBENCHMARK {
+        found = fingerprint ? m_store.find(LayoutProfileStore::fingerprint(m_docked)) : scan(m_store, m_docked);
+    }
+    QVERIFY(found);
+    QCOMPARE(found->fingerprint, LayoutProfileStore::fingerprint(m_docked));
+}
+
+QTEST_GUILESS_MAIN(ProfileBenchmark)
+#include "bench_profiles.moc"
@@ -0,0 +1,116 @@
+#include "benchmarkdata.h"
+#include "layoutprofilestore.h"
+#include "snapshotformat.h"
+#include <QtTest>
+#include <map>
+#include <memory>
+
+// Encoding and decoding large profile stores as JSON and as CBOR, with the
+// size of each
+class SnapshotBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void encode_data();
+    void encode();
+    void decode_data();
+    void decode();
+    void cborRoundTrip_data();
+    void cborRoundTrip();
+
+private:
+    void addRows() const;
+    // Built once per size and shared by every case
+    const LayoutProfileStore &store(int profileCount);
+
+    std::map<int, std::unique_ptr<LayoutProfileStore>> m_stores;
+};
+
+void SnapshotBenchmark::addRows() const
+{
+    QTest::addColumn<int>("profileCount");
+    QTest::addColumn<int>("format");
+    for (int profileCount : {100, 1000, 10000}) {
+        for (SnapshotFormat::Format format : {SnapshotFormat::Json, SnapshotFormat::Cbor}) {
+            QTest::addRow("%d profiles, %s", profileCount, qPrintable(SnapshotFormat::name(format)))
+                << profileCount << int(format);
+        }
+    }
+}
+
+const LayoutProfileStore &SnapshotBenchmark::store(int profileCount)
+{
+    std::unique_ptr<LayoutProfileStore> &store = m_stores[profileCount];
+    if (!store) {
+        store = std::make_unique<LayoutProfileStore>();
+        for (int i = 0; i < profileCount; ++i) {
+            store->remember(BenchmarkData::dockedDisplays(i));
+        }
+    }
+    return *store;
+}
+
+void SnapshotBenchmark::encode_data()
+{
+    addRows();
+}
+
+void SnapshotBenchmark::encode()
+{
+    QFETCH(int, profileCount);
+    QFETCH(int, format);
+    const LayoutProfileStore &saved = store(profileCount);
+    QByteArray data;
+    QBENCHMARK {
+        data = saved.encode(SnapshotFormat::Format(format));
+    }
+    qInfo() << "size:" << data.size() / 1024 << "KiB";
+}
+
+void SnapshotBenchmark::decode_data()
+{
+    addRows();
+}
+
+void SnapshotBenchmark::decode()
+{
+    QFETCH(int, profileCount);
+    QFETCH(int, format);
+    const LayoutProfileStore &saved = store(profileCount);
+    const QByteArray data = saved.encode(SnapshotFormat::Format(format));
+    bool ok = true;
+    QBENCHMARK {
+        LayoutProfileStore loaded;
+        ok = loaded.decode(data) && loaded.size() == saved.size() && ok;
+    }
+    QVERIFY(ok);
+}
+
+void SnapshotBenchmark::cborRoundTrip_data()
+{
+    QTest::addColumn<int>("profileCount");
+    QTest::newRow("100 profiles") << 100;
+    QTest::newRow("1000 profiles") << 1000;
+}
+
+void SnapshotBenchmark::cborRoundTrip()
+{
+    // Both encodings must give back the same layouts
+    QFETCH(int, profileCount);
+    const LayoutProfileStore &saved = store(profileCount);
+    LayoutProfileStore fromCbor;
+    QVERIFY(fromCbor.decode(saved.encode(SnapshotFormat::Cbor)));
+    for (const QString &fingerprint : saved.fingerprints()) {
+        const LayoutProfile *original = saved.find(fingerprint);
+        const LayoutProfile *loaded = fromCbor.find(fingerprint);
+        QVERIFY(loaded);
+        QCOMPARE(loaded->displays.size(), original->displays.size());
+        for (int i = 0; i < original->displays.size(); ++i) {
+            QCOMPARE(loaded->displays.at(i).diff(original->displays.at(i)).toInt(), 0);
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(SnapshotBenchmark)
+#include "bench_snapshot.moc"
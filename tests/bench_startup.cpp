@@ -0,0 +1,132 @@
+#include "benchmarkdata.h"
+#include "hyprlandipc.h"
+#include "layoutprofilestore.h"
+#include "singleinstance.h"
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QtTest>
+
+// Process start to exit of the window (offscreen), of the headless
+// subcommands, and of a launch handed to a running window. The paths of
+// the built binaries come from tests/CMakeLists.txt.
+class StartupBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void coldStart_data();
+    void coldStart();
+    void handOff();
+
+private:
+    QTemporaryDir m_dir;
+    QString m_profilesPath;
+    QProcessEnvironment m_environment;
+};
+
+void StartupBenchmark::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    LayoutProfileStore store;
+    for (int i = 0; i < 20; ++i) {
+        QList<DisplayInfo> displays = BenchmarkData::syntheticDisplays(2);
+        displays[1].serial = QString("SN%1").arg(i);
+        store.remember(displays);
+    }
+    m_profilesPath = m_dir.path() + "/profiles.json";
+    QVERIFY(store.save(m_profilesPath));
+
+    m_environment = QProcessEnvironment::systemEnvironment();
+    m_environment.insert("QT_QPA_PLATFORM", "offscreen");
+}
+
+void StartupBenchmark::coldStart_data()
+{
+    QTest::addColumn<QString>("program");
+    QTest::addColumn<QStringList>("arguments");
+    QTest::addColumn<bool>("needsHyprland");
+    const QString window = HYPRDISPLAYS_PATH;
+    // Links the core library only
+    const QString cli = HYPRDISPLAYS_CLI_PATH;
+    const QStringList listProfiles = {"list", "--profiles", "--json", "--profiles-path", m_profilesPath};
+    QTest::newRow("window, offscreen") << window << QStringList{"--exit-after-show"} << false;
+    QTest::newRow("headless list --profiles") << window << listProfiles << false;
+    QTest::newRow("cli list --profiles") << cli << listProfiles << false;
+    QTest::newRow("headless list --json") << window << QStringList{"list", "--json"} << true;
+    QTest::newRow("cli list --json") << cli << QStringList{"list", "--json"} << true;
+}
+
+void StartupBenchmark::coldStart()
+{
+    QFETCH(QString, program);
+    QFETCH(QStringList, arguments);
+    QFETCH(bool, needsHyprland);
+    if (needsHyprland && !HyprlandIpc::isSocketAvailable()) {
+        QSKIP("Hyprland socket not found, monitor listing skipped");
+    }
+
+    int failed = 0;
+    QBENCHMARK {
+        QProcess process;
+        process.setProcessEnvironment(m_environment);
+        process.setStandardOutputFile(QProcess::nullDevice());
+        process.setStandardErrorFile(QProcess::nullDevice());
+        process.start(program, arguments);
+        if (!process.waitForFinished(30000) || process.exitStatus() != QProcess::NormalExit
+            || process.exitCode() != 0) {
+            ++failed;
+        }
+    }
+    QCOMPARE(failed, 0);
+}
+
+void StartupBenchmark::handOff()
+{
+    // A plain launch while a window is open; this process stands in for the
+    // window and has to keep answering, so the child is waited for in an event loop
+    const QString runtimeDir = m_dir.path() + "/runtime";
+    QDir().mkpath(runtimeDir);
+    QFile::setPermissions(runtimeDir, QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ExeOwner);
+    SingleInstance window(runtimeDir + "/hyprdisplays");
+    int activations = 0;
+    connect(&window, &SingleInstance::showRequested, this, [&]() { ++activations; });
+    QString error;
+    QVERIFY(window.lock());
+    QVERIFY2(window.listen(&error), qPrintable(error));
+    QProcessEnvironment environment = m_environment;
+    environment.insert("XDG_RUNTIME_DIR", runtimeDir);
+
+    int launches = 0;
+    int failed = 0;
+    QBENCHMARK {
+        QProcess process;
+        process.setProcessEnvironment(environment);
+        process.setStandardOutputFile(QProcess::nullDevice());
+        process.setStandardErrorFile(QProcess::nullDevice());
+        QEventLoop loop;
+        connect(&process, &QProcess::finished, &loop, &QEventLoop::quit);
+        connect(&process, &QProcess::errorOccurred, &loop, &QEventLoop::quit);
+        QTimer::singleShot(30000, &loop, &QEventLoop::quit);
+        process.start(HYPRDISPLAYS_PATH, QStringList());
+        loop.exec();
+        ++launches;
+        if (process.state() != QProcess::NotRunning || process.exitStatus() != QProcess::NormalExit
+            || process.exitCode() != 0) {
+            process.kill();
+            process.waitForFinished();
+            ++failed;
+        }
+    }
+    QCOMPARE(failed, 0);
+    // Each handed-off launch has to have reached the window
+    QCOMPARE(activations, launches);
+}
+
+QTEST_GUILESS_MAIN(StartupBenchmark)
+#include "bench_startup.moc"
@@ -0,0 +1,105 @@
+#include "benchmarkdata.h"
+#include "monitorscenesync.h"
+#include "visualmonitorwidget.h"
+#include <QGraphicsDropShadowEffect>
+#include <QGraphicsScene>
+#include <QImage>
+#include <QPainter>
+#include <QPixmapCache>
+#include <QtTest>
+
+// The layout view: keeping the scene in sync with the monitors, and painting
+// it while a tile is dragged
+class ViewBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sceneUpdate_data();
+    void sceneUpdate();
+    void dragFrame_data();
+    void dragFrame();
+};
+
+void ViewBenchmark::sceneUpdate_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("incremental");
+    for (int count : {2, 8, 32}) {
+        QTest::addRow("%d monitors, full rebuild", count) << count << false;
+        QTest::addRow("%d monitors, incremental", count) << count << true;
+    }
+}
+
+void ViewBenchmark::sceneUpdate()
+{
+    QFETCH(int, count);
+    QFETCH(bool, incremental);
+    const QSizeF viewSize(960, 300);
+    QList<DisplayInfo> displays = BenchmarkData::syntheticDisplays(count);
+    QGraphicsScene scene;
+    MonitorSceneSync sync(&scene);
+    sync.sync(displays, viewSize);
+
+    // Each update nudges one monitor, like a refresh after a drag
+    int i = 0;
+    QBENCHMARK {
+        displays[i % count].x += (i % 2) ? -10 : 10;
+        ++i;
+        if (!incremental) {
+            sync.clear();
+        }
+        sync.sync(displays, viewSize);
+    }
+    QCOMPARE(int(sync.items().size()), count);
+}
+
+void ViewBenchmark::dragFrame_data()
+{
+    QTest::addColumn<bool>("shadowEffect");
+    QTest::newRow("shadow effect") << true;
+    QTest::newRow("cached tiles") << false;
+}
+
+void ViewBenchmark::dragFrame()
+{
+    QFETCH(bool, shadowEffect);
+    const QSize viewSize(1920, 600);
+    const QList<DisplayInfo> displays = BenchmarkData::syntheticDisplays(32);
+    QGraphicsScene scene;
+    MonitorSceneSync sync(&scene);
+    sync.sync(displays, viewSize);
+
+    // With the cache disabled every tile is repainted, including its shadow
+    const int cacheLimit = QPixmapCache::cacheLimit();
+    if (shadowEffect) {
+        QPixmapCache::setCacheLimit(0);
+        for (VisualMonitorWidget *vmw : sync.items()) {
+            auto *effect = new QGraphicsDropShadowEffect;
+            effect->setBlurRadius(10);
+            effect->setColor(QColor(0, 0, 0, 100));
+            effect->setOffset(2, 2);
+            vmw->setGraphicsEffect(effect);
+        }
+    }
+
+    // One frame per step while a tile moves across the layout
+    QImage frame(viewSize, QImage::Format_ARGB32_Premultiplied);
+    VisualMonitorWidget *dragged = sync.item(displays.first().name);
+    QVERIFY(dragged);
+    const QPointF start = dragged->pos();
+    int i = 0;
+    QBENCHMARK {
+        dragged->setPos(start + QPointF(i % 200, (i / 200) % 50));
+        ++i;
+        frame.fill(Qt::transparent);
+        QPainter painter(&frame);
+        scene.render(&painter, QRectF(QPointF(0, 0), viewSize), QRectF(QPointF(0, 0), viewSize));
+    }
+
+    QPixmapCache::setCacheLimit(cacheLimit);
+    QPixmapCache::clear();
+}
+
+QTEST_MAIN(ViewBenchmark)
+#include "bench_view.moc"
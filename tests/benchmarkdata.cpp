@@ -0,0 +1,154 @@
+#include "benchmarkdata.h"
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QLocalSocket>
+#include <QStringList>
+#include <QTimer>
+
+namespace {
+
+// One monitor of the recorded reply; %1-%3 vary per monitor
+const char *const RecordedMonitor = R"({
+    "id": %1,
+    "name": "DP-%2",
+    "description": "Dell Inc. DELL U2720Q 8LXMZ13",
+    "make": "Dell Inc.",
+    "model": "DELL U2720Q",
+    "serial": "8LXMZ13",
+    "width": 3840,
+    "height": 2160,
+    "refreshRate": 59.99700,
+    "x": %3,
+    "y": 0,
+    "activeWorkspace": {
+        "id": %2,
+        "name": "%2"
+    },
+    "specialWorkspace": {
+        "id": 0,
+        "name": ""
+    },
+    "reserved": [0, 0, 0, 0],
+    "scale": 1.50,
+    "transform": 0,
+    "focused": false,
+    "dpmsStatus": true,
+    "vrr": false,
+    "solitary": "0",
+    "activelyTearing": false,
+    "directScanoutTo": "0",
+    "disabled": false,
+    "currentFormat": "XRGB2101010",
+    "mirrorOf": "none",
+    "availableModes": ["3840x2160@60.00Hz","3840x2160@59.94Hz","3840x2160@50.00Hz","3840x2160@30.00Hz","2560x1440@59.95Hz","1920x1080@60.00Hz","1920x1080@59.94Hz","1920x1080@50.00Hz","1280x720@60.00Hz","1024x768@60.00Hz","800x600@60.32Hz","640x480@59.94Hz"]
+})";
+
+}
+
+QList<DisplayInfo> BenchmarkData::syntheticDisplays(int count)
+{
+    QList<DisplayInfo> displays;
+    const int columns = 4;
+    for (int i = 0; i < count; ++i) {
+        DisplayInfo display{};
+        display.name = QString("DP-%1").arg(i + 1);
+        display.width = 2560;
+        display.height = 1440;
+        display.refreshRate = 144;
+        display.x = (i % columns) * display.width;
+        display.y = (i / columns) * display.height;
+        display.scale = 1.0;
+        display.setEnabled(true);
+        display.sdrBrightness = 1.0;
+        display.sdrSaturation = 1.0;
+        displays.append(display);
+    }
+    return displays;
+}
+
+QList<DisplayInfo> BenchmarkData::dockedDisplays(int index)
+{
+    QList<DisplayInfo> displays = syntheticDisplays(1 + index % 3 + 1);
+    for (int j = 0; j < displays.size(); ++j) {
+        displays[j].manufacturer = j == 0 ? "BOE" : "Dell Inc.";
+        displays[j].model = j == 0 ? "0x095F" : QString("DELL U27%1Q").arg(j);
+        displays[j].serial = j == 0 ? QString() : QString("SN%1-%2").arg(index).arg(j);
+    }
+    return displays;
+}
+
+QByteArray BenchmarkData::recordedMonitorsReply(int count)
+{
+    QStringList monitors;
+    for (int i = 0; i < count; ++i) {
+        monitors.append(QString::fromLatin1(RecordedMonitor).arg(i).arg(i + 1).arg(i * 2560));
+    }
+    return ("[" + monitors.join(",") + "]").toUtf8();
+}
+
+bool BenchmarkData::waitUntil(const std::function<bool()> &done, int timeoutMs)
+{
+    QElapsedTimer elapsed;
+    elapsed.start();
+    QEventLoop loop;
+    QTimer tick;
+    tick.setInterval(2);
+    QObject::connect(&tick, &QTimer::timeout, &loop, [&]() {
+        if (done() || elapsed.elapsed() >= timeoutMs) loop.quit();
+    });
+    tick.start();
+    if (!done()) loop.exec();
+    return done();
+}
+
+FakeHyprland::FakeHyprland(const QString &instanceDir, int monitors, QObject *parent)
+    : QObject(parent)
+    , m_instanceDir(instanceDir)
+    , m_monitorsReply(BenchmarkData::recordedMonitorsReply(monitors))
+    , m_batches(0)
+{
+    connect(&m_requests, &QLocalServer::newConnection, this, [this]() {
+        while (QLocalSocket *client = m_requests.nextPendingConnection()) {
+            connect(client, &QLocalSocket::disconnected, client, &QObject::deleteLater);
+            connect(client, &QLocalSocket::readyRead, this, [this, client]() { answer(client); });
+        }
+    });
+    connect(&m_events, &QLocalServer::newConnection, this, [this]() {
+        while (QLocalSocket *client = m_events.nextPendingConnection()) {
+            connect(client, &QLocalSocket::disconnected, this, [this, client]() {
+                m_eventClients.removeOne(client);
+                client->deleteLater();
+            });
+            m_eventClients.append(client);
+        }
+    });
+}
+
+bool FakeHyprland::listen()
+{
+    return m_requests.listen(m_instanceDir + "/.socket.sock") && m_events.listen(m_instanceDir + "/.socket2.sock");
+}
+
+void FakeHyprland::sendEvent(const QByteArray &line)
+{
+    for (QLocalSocket *client : std::as_const(m_eventClients)) {
+        client->write(line + '\n');
+        client->flush();
+    }
+}
+
+void FakeHyprland::answer(QLocalSocket *client)
+{
+    const QByteArray request = client->readAll();
+    QByteArray reply = "ok";
+    if (request.startsWith("[[BATCH]]")) {
+        QByteArrayList replies;
+        for (int i = 0; i <= request.count(';'); ++i) replies.append("ok");
+        reply = replies.join("\n\n\n");
+        ++m_batches;
+    } else if (request.contains("monitors")) {
+        reply = m_monitorsReply;
+    }
+    client->write(reply);
+    client->disconnectFromServer();
+}
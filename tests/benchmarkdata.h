@@ -0,0 +1,58 @@
+#ifndef BENCHMARKDATA_H
+#define BENCHMARKDATA_H
+
+#include <QByteArray>
+#include <QList>
+#include <QLocalServer>
+#include <QObject>
+#include <QString>
+#include <functional>
+
+#include "displaymanager.h"
+
+class QLocalSocket;
+
+// Inputs shared by the benchmarks, so every case measures the same shapes
+namespace BenchmarkData {
+
+// A grid of identical 2560x1440 monitors, the shape a docked laptop or a wall grows into
+QList<DisplayInfo> syntheticDisplays(int count);
+
+// A laptop panel plus one to three external monitors; index makes the serials unique
+QList<DisplayInfo> dockedDisplays(int index);
+
+// A recorded `hyprctl monitors -j` reply (Hyprland 0.41) with count monitors
+QByteArray recordedMonitorsReply(int count);
+
+// Runs this thread's event loop until done() holds or the time is up
+bool waitUntil(const std::function<bool()> &done, int timeoutMs);
+
+}
+
+// Stands in for Hyprland's request and event sockets, so the daemon and the
+// control socket can be measured without a compositor. Monitor queries get
+// the recorded reply, batches are counted and acknowledged, anything else
+// gets "ok".
+class FakeHyprland : public QObject
+{
+public:
+    FakeHyprland(const QString &instanceDir, int monitors, QObject *parent = nullptr);
+
+    bool listen();
+    void sendEvent(const QByteArray &line);
+
+    int batches() const { return m_batches; }
+    int eventClients() const { return m_eventClients.size(); }
+
+private:
+    void answer(QLocalSocket *client);
+
+    QString m_instanceDir;
+    QByteArray m_monitorsReply;
+    QLocalServer m_requests;
+    QLocalServer m_events;
+    QList<QLocalSocket *> m_eventClients;
+    int m_batches;
+};
+
+#endif // BENCHMARKDATA_H
@@ -0,0 +1,70 @@
+#include "applyplanner.h"
+#include <QtTest>
+
+namespace {
+
+DisplayInfo liveMonitor()
+{
+    DisplayInfo display;
+    display.name = "DP-1";
+    display.width = 2560;
+    display.height = 1440;
+    display.refreshRate = 59.951;
+    display.scale = 1.333333;
+    display.setEnabled(true);
+    display.setHdr(true);
+    display.sdrBrightness = 1.2;
+    display.sdrSaturation = 0.98;
+    return display;
+}
+
+}
+
+// What the planner sends for one monitor, given its live state and the one
+// read back from the settings panel or monitors.conf
+class ApplyPlannerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void plan_data();
+    void plan();
+};
+
+void ApplyPlannerTest::plan_data()
+{
+    QTest::addColumn<double>("refreshRate");
+    QTest::addColumn<double>("scale");
+    QTest::addColumn<double>("sdrBrightness");
+    QTest::addColumn<int>("x");
+    QTest::addColumn<int>("kind");
+
+    QTest::newRow("unchanged") << 59.951 << 1.333333 << 1.2 << 0 << int(PlannedChange::Unchanged);
+    // Everything the panel and monitors.conf round to two decimals
+    QTest::newRow("rounded to two decimals") << 59.95 << 1.33 << 1.2000001 << 0 << int(PlannedChange::Unchanged);
+    QTest::newRow("other refresh rate") << 59.94 << 1.333333 << 1.2 << 0 << int(PlannedChange::Modeset);
+    QTest::newRow("scale step") << 59.951 << 1.25 << 1.2 << 0 << int(PlannedChange::Reconfigure);
+    QTest::newRow("SDR brightness step") << 59.951 << 1.333333 << 1.21 << 0 << int(PlannedChange::Modeset);
+    QTest::newRow("moved and rounded") << 59.95 << 1.33 << 1.2 << 2560 << int(PlannedChange::Reposition);
+}
+
+void ApplyPlannerTest::plan()
+{
+    QFETCH(double, refreshRate);
+    QFETCH(double, scale);
+    QFETCH(double, sdrBrightness);
+    QFETCH(int, x);
+    QFETCH(int, kind);
+    DisplayInfo desired = liveMonitor();
+    desired.refreshRate = refreshRate;
+    desired.scale = scale;
+    desired.sdrBrightness = sdrBrightness;
+    desired.x = x;
+
+    const ApplyPlan plan = ApplyPlanner::plan({liveMonitor()}, {desired});
+    QCOMPARE(int(plan.changes.size()), 1);
+    QCOMPARE(PlannedChange::kindName(plan.changes.first().kind), PlannedChange::kindName(PlannedChange::Kind(kind)));
+}
+
+QTEST_GUILESS_MAIN(ApplyPlannerTest)
+#include "tst_applyplanner.moc"